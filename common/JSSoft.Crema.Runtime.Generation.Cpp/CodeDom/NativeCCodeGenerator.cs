@@ -1646,6 +1646,17 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp.CodeDom
                     this.Output.Write(" const");
                 }
 
+                if (e.IsInline() == true)
+                {
+                    this.OutputStartingBrace();
+                    this.Indent++;
+                    this.GenerateStatements(e.Statements);
+                    this.GenerateStatements(e);
+                    this.Indent--;
+                    this.Output.WriteLine("}");
+                    return;
+                }
+
                 this.Output.WriteLine(";");
 
                 {
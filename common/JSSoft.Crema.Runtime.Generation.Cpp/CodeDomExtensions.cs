@@ -30,6 +30,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
         private const string key_includes = "includes";
         private const string key_customIncludes = "custom_includes";
         private const string key_const = "const";
+        private const string key_inline = "inline";
         private const string key_pointer = "pointer";
         private const string key_codeType = "codeType";
 
@@ -86,6 +87,18 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             codeMember.UserData[key_const] = value;
         }
 
+        public static bool IsInline(this CodeMemberMethod codeMember)
+        {
+            if (codeMember.UserData.Contains(key_inline) == false)
+                return false;
+            return (bool)codeMember.UserData[key_inline];
+        }
+
+        public static void IsInline(this CodeMemberMethod codeMember, bool value)
+        {
+            codeMember.UserData[key_inline] = value;
+        }
+
         public static bool HasCodeType(this CodeTypeReference codeTypeReference, CodeType codeType)
         {
             if (codeTypeReference.UserData.Contains(key_codeType) == false)
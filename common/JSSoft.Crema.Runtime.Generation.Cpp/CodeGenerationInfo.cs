@@ -36,6 +36,9 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
         public const string CremaDataName = "CremaData";
         public const string CremaTableName = "CremaTable";
         public const string CremaRowName = "CremaRow";
+        public const string CremaFieldRowName = "CremaFieldRow";
+        public const string CremaRowsName = "CremaRows";
+        public const string CremaLazyTableName = "CremaLazyTable";
 
         private readonly GenerationSet metaData;
         private readonly CodeGenerationSettings settings;
@@ -165,6 +168,10 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
 
         public bool NoChanges => this.settings.Options.HasFlag(CodeGenerationOptions.OmitSignatureDate);
 
+        public bool ZeroCopyRows => this.settings.Options.HasFlag(CodeGenerationOptions.ZeroCopyRows);
+
+        public bool LazyTables => this.settings.Options.HasFlag(CodeGenerationOptions.LazyTables);
+
         public bool BlankLinesBetweenMembers
         {
             get;
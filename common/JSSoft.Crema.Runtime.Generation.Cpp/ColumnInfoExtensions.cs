@@ -90,6 +90,37 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             return Utility.GenerateCodeType(TypeNamespace, itemName.Name);
         }
 
+        public static CodeTypeReference GetFieldCodeType(this ColumnInfo columnInfo)
+        {
+            if (columnInfo.DataType == "datetime")
+                return new CodeTypeReference(typeof(long));
+            else if (columnInfo.DataType == "duration")
+                return new CodeTypeReference(typeof(int));
+            else if (columnInfo.IsCustomType() == true)
+                return new CodeTypeReference(typeof(int));
+            return columnInfo.GetCodeType(CodeType.None);
+        }
+
+        public static bool IsStringType(this ColumnInfo columnInfo)
+        {
+            return columnInfo.DataType == typeof(string).GetTypeName() || columnInfo.DataType == typeof(Guid).GetTypeName();
+        }
+
+        public static CodeExpression GetFieldAccessExpression(this ColumnInfo columnInfo, int index)
+        {
+            var thisRef = new CodeThisReferenceExpression();
+            var indexExp = new CodePrimitiveExpression(index);
+            if (columnInfo.IsStringType() == true)
+                return new CodeMethodInvokeExpression(thisRef, "StringField", indexExp);
+
+            var fieldType = columnInfo.GetFieldCodeType();
+            var field = new CodeMethodReferenceExpression(thisRef, "Field", fieldType);
+            var fieldInvoke = new CodeMethodInvokeExpression(field, indexExp);
+            if (fieldType.BaseType == columnInfo.GetCodeType(CodeType.None).BaseType)
+                return fieldInvoke;
+            return new CodeCastExpression(columnInfo.GetCodeType(CodeType.None), fieldInvoke);
+        }
+
         public static bool IsCustomType(this ColumnInfo columnInfo)
         {
             return CremaDataTypeUtility.IsBaseType(columnInfo.DataType) == false;
@@ -96,10 +96,13 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             cc.Parameters.Add(generationInfo.ReaderNamespace, "idataset&", "dataSet");
             cc.Parameters.Add(new CodeTypeReference(typeof(bool)), "verifyRevision");
 
-            foreach (var item in generationInfo.GetTables(true))
+            if (generationInfo.LazyTables == false)
             {
-                var field = new CodeFieldReferenceExpression(new CodeThisReferenceExpression(), item.Name);
-                cc.Statements.AddAssign(field, new CodePrimitiveExpression(null));
+                foreach (var item in generationInfo.GetTables(true))
+                {
+                    var field = new CodeFieldReferenceExpression(new CodeThisReferenceExpression(), item.Name);
+                    cc.Statements.AddAssign(field, new CodePrimitiveExpression(null));
+                }
             }
 
             var methodInvokeExp = new CodeMethodInvokeExpression(new CodeThisReferenceExpression(), "Load", new CodeVariableReferenceExpression("dataSet"), new CodeVariableReferenceExpression("verifyRevision"));
@@ -115,12 +118,16 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                 Attributes = MemberAttributes.Public | MemberAttributes.Override
             };
 
-            foreach (var item in generationInfo.GetTables())
+            // 지연 테이블은 스스로 테이블을 해제합니다.
+            if (generationInfo.LazyTables == false)
             {
-                var field = new CodeFieldReferenceExpression(new CodeThisReferenceExpression(), item.Name);
-                var delete = new CodeObjectDeleteExpression(field);
+                foreach (var item in generationInfo.GetTables())
+                {
+                    var field = new CodeFieldReferenceExpression(new CodeThisReferenceExpression(), item.Name);
+                    var delete = new CodeObjectDeleteExpression(field);
 
-                cc.Statements.Add(delete);
+                    cc.Statements.Add(delete);
+                }
             }
 
             classType.Members.Add(cc);
@@ -138,9 +145,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             cc.Parameters.Add(codeTypeRef, "filename");
             cc.Parameters.Add(new CodeTypeReference(typeof(bool)), "verifyRevision");
 
-            var paramExp = new CodeVariableReferenceExpression("filename");
-            var readerTypeRef = new CodeTypeReferenceExpression(string.Join("::", generationInfo.ReaderNamespace, "CremaReader"));
-            var methodInvokeExp = new CodeMethodInvokeExpression(readerTypeRef, "ReadFromFile", paramExp);
+            var methodInvokeExp = CreateReadFromFileExpression(generationInfo);
 
             cc.ChainedConstructorArgs.Add(methodInvokeExp);
             cc.ChainedConstructorArgs.Add(new CodeVariableReferenceExpression("verifyRevision"));
@@ -217,6 +222,13 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             foreach (var item in generationInfo.GetTables(true))
             {
                 var field = new CodeFieldReferenceExpression(new CodeThisReferenceExpression(), item.Name);
+                if (generationInfo.LazyTables == true)
+                {
+                    var reset = new CodeMethodInvokeExpression(new CodeMethodReferenceExpression(field, "Reset"), dataSet, new CodePrimitiveExpression(item.Name));
+                    cc.Statements.Add(reset);
+                    continue;
+                }
+
                 var operatorExp = new CodeBinaryOperatorExpression(field, CodeBinaryOperatorType.IdentityInequality, new CodePrimitiveExpression(null));
                 var ccs = new CodeConditionStatement(operatorExp);
                 var delete = new CodeObjectDeleteExpression(field);
@@ -249,9 +261,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             cc.Parameters.Add(codeTypeRef, "filename");
             cc.Parameters.Add(new CodeTypeReference(typeof(bool)), "verifyRevision");
 
-            var paramExp = new CodeVariableReferenceExpression("filename");
-            var readerTypeRef = new CodeTypeReferenceExpression(string.Join("::", generationInfo.ReaderNamespace, "CremaReader"));
-            var readerInvokeExp = new CodeMethodInvokeExpression(readerTypeRef, "ReadFromFile", paramExp);
+            var readerInvokeExp = CreateReadFromFileExpression(generationInfo);
 
             var methodInvokeExp = new CodeMethodInvokeExpression(new CodeThisReferenceExpression(), "Load", readerInvokeExp, new CodeVariableReferenceExpression("verifyRevision"));
             cc.Statements.Add(methodInvokeExp);
@@ -271,10 +281,30 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                     Name = item.Name,
                     Type = item.GetCodeType(CodeType.Pointer | CodeType.Const)
                 };
+                if (generationInfo.LazyTables == true)
+                {
+                    cmf.Type = new CodeTypeReference(string.Join(".", generationInfo.BaseNamespace, CodeGenerationInfo.CremaLazyTableName), item.GetCodeType(CodeType.None));
+                }
                 classType.Members.Add(cmf);
             }
         }
 
+        private static CodeMethodInvokeExpression CreateReadFromFileExpression(CodeGenerationInfo generationInfo)
+        {
+            var paramExp = new CodeVariableReferenceExpression("filename");
+            var readerTypeRef = new CodeTypeReferenceExpression(string.Join("::", generationInfo.ReaderNamespace, "CremaReader"));
+            var readerInvokeExp = new CodeMethodInvokeExpression(readerTypeRef, "ReadFromFile", paramExp);
+
+            // 지연 테이블은 테이블을 처음 접근할 때 읽으므로 리더도 필요한 테이블만 읽도록 합니다.
+            if (generationInfo.LazyTables == true)
+            {
+                var flagTypeRef = new CodeTypeReferenceExpression(generationInfo.ReaderNamespace);
+                readerInvokeExp.Parameters.Add(new CodeFieldReferenceExpression(flagTypeRef, "ReadFlag_lazy_loading"));
+            }
+
+            return readerInvokeExp;
+        }
+
         private static void CreateNameField(CodeTypeDeclaration classType, CodeGenerationInfo generationInfo)
         {
             var cmf = new CodeMemberField
@@ -40,14 +40,23 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
 
             classType.IsClass = true;
             classType.Name = tableInfo.GetRowClassName();
-            classType.BaseTypes.Add(generationInfo.BaseNamespace, "CremaRow");
 
-            CreateColumnFields(classType, tableInfo, generationInfo);
+            if (generationInfo.ZeroCopyRows == true)
+            {
+                classType.BaseTypes.Add(generationInfo.BaseNamespace, "CremaFieldRow");
+                CreateColumnAccessors(classType, tableInfo, generationInfo);
+            }
+            else
+            {
+                classType.BaseTypes.Add(generationInfo.BaseNamespace, "CremaRow");
+                CreateColumnFields(classType, tableInfo, generationInfo);
+            }
             CreateTableField(classType, tableInfo);
             CreateChildFields(classType, tableInfo, generationInfo);
             CreateStaticChildEmptyFields(classType, tableInfo, generationInfo);
             CreateParentField(classType, tableInfo);
             CreateConstructor(classType, tableInfo, generationInfo);
+            CreateEqualsKeyMethod(classType, tableInfo, generationInfo);
             CreateSetChildsMethod(classType, tableInfo, generationInfo);
         }
 
@@ -60,7 +69,10 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             cc.Parameters.Add(generationInfo.ReaderNamespace, "irow&", "row");
             cc.Parameters.Add(tableInfo.GetCodeType(CodeType.Pointer), "table");
 
-            cc.AddConstructorStatement(string.Format("{0}(row)", CodeGenerationInfo.CremaRowName));
+            if (generationInfo.ZeroCopyRows == true)
+                cc.AddConstructorStatement(string.Format("{0}(row)", CodeGenerationInfo.CremaFieldRowName));
+            else
+                cc.AddConstructorStatement(string.Format("{0}(row)", CodeGenerationInfo.CremaRowName));
             //cc.AddConstructorStatement("Table(*table)");
 
             //foreach (var item in tableInfo.Columns)
@@ -105,6 +117,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             }
 
             // assign fields
+            if (generationInfo.ZeroCopyRows == false)
             {
                 int index = 0;
                 foreach (var item in tableInfo.Columns)
@@ -176,13 +189,17 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                 {
                     if (item.IsKey == true)
                     {
+                        var keyExp = item.GetFieldExpression();
+                        if (generationInfo.ZeroCopyRows == true)
+                            keyExp = new CodeMethodInvokeExpression(new CodeThisReferenceExpression(), item.Name);
+
                         if (item.DataType == typeof(string).GetTypeName() == true)
                         {
-                            methodInvokeExp.Parameters.Add(new CodeMethodInvokeExpression(item.GetFieldExpression(), "c_str"));
+                            methodInvokeExp.Parameters.Add(new CodeMethodInvokeExpression(keyExp, "c_str"));
                         }
                         else
                         {
-                            methodInvokeExp.Parameters.Add(item.GetFieldExpression());
+                            methodInvokeExp.Parameters.Add(keyExp);
                         }
                     }
                 }
@@ -192,6 +209,49 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             classType.Members.Add(cc);
         }
 
+        private static void CreateEqualsKeyMethod(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
+        {
+            var cmm = new CodeMemberMethod
+            {
+                Attributes = MemberAttributes.Public | MemberAttributes.Final,
+                Name = "EqualsKey",
+                ReturnType = new CodeTypeReference(typeof(bool))
+            };
+            cmm.IsConst(true);
+            cmm.IsInline(true);
+
+            CodeExpression condition = null;
+            foreach (var item in tableInfo.Columns)
+            {
+                if (item.IsKey == false)
+                    continue;
+
+                if (item.DataType == typeof(string).GetTypeName() == true)
+                {
+                    var stringType = new CodeTypeReference(typeof(sbyte));
+                    stringType.SetCodeType(CodeType.Pointer | CodeType.Const);
+                    cmm.Parameters.Add(stringType, item.Name);
+                }
+                else
+                {
+                    cmm.Parameters.Add(item.GetCodeType(CodeType.None), item.Name);
+                }
+
+                var valueExp = item.GetFieldExpression();
+                if (generationInfo.ZeroCopyRows == true)
+                    valueExp = new CodeMethodInvokeExpression(new CodeThisReferenceExpression(), item.Name);
+
+                var equals = new CodeBinaryOperatorExpression(valueExp, CodeBinaryOperatorType.ValueEquality, new CodeVariableReferenceExpression(item.Name));
+                if (condition == null)
+                    condition = equals;
+                else
+                    condition = new CodeBinaryOperatorExpression(condition, CodeBinaryOperatorType.BooleanAnd, equals);
+            }
+
+            cmm.Statements.AddMethodReturn(condition ?? new CodePrimitiveExpression(true));
+            classType.Members.Add(cmm);
+        }
+
         private static void CreateColumnFields(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
         {
             foreach (var item in tableInfo.Columns)
@@ -220,6 +280,52 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             }
         }
 
+        private static void CreateColumnAccessors(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
+        {
+            var index = 0;
+            foreach (var item in tableInfo.Columns)
+            {
+                var cmm = new CodeMemberMethod
+                {
+                    Attributes = MemberAttributes.Public | MemberAttributes.Final,
+                    Name = item.Name,
+                    ReturnType = item.GetPropertyType()
+                };
+                cmm.IsConst(true);
+                cmm.IsInline(true);
+                cmm.Statements.AddMethodReturn(item.GetFieldAccessExpression(index));
+
+                if (generationInfo.NoComment == false)
+                {
+                    cmm.Comments.AddSummary(item.Comment);
+                }
+                if (generationInfo.NoChanges == false)
+                {
+                    cmm.Comments.Add(CremaSchema.Creator, item.CreationInfo.ID);
+                    cmm.Comments.Add(CremaSchema.CreatedDateTime, item.CreationInfo.DateTime);
+                    cmm.Comments.Add(CremaSchema.Modifier, item.ModificationInfo.ID);
+                    cmm.Comments.Add(CremaSchema.ModifiedDateTime, item.ModificationInfo.DateTime);
+                }
+                classType.Members.Add(cmm);
+
+                if (item.IsKey == false)
+                {
+                    var hasValue = new CodeMemberMethod
+                    {
+                        Attributes = MemberAttributes.Public | MemberAttributes.Final,
+                        Name = "Has" + item.Name,
+                        ReturnType = new CodeTypeReference(typeof(bool))
+                    };
+                    hasValue.IsConst(true);
+                    hasValue.IsInline(true);
+                    var hasField = new CodeMethodInvokeExpression(new CodeThisReferenceExpression(), "HasField", new CodePrimitiveExpression(index));
+                    hasValue.Statements.AddMethodReturn(hasField);
+                    classType.Members.Add(hasValue);
+                }
+                index++;
+            }
+        }
+
         private static void CreateTableField(CodeTypeDeclaration classType, TableInfo tableInfo)
         {
             var cmf = new CodeMemberField
@@ -242,8 +348,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                     Name = tableInfo.TableName + "Set" + item.TableName
                 };
                 cmm.Parameters.Add(tableInfo.GetRowCodeType(CodeType.Pointer), "target");
-                var arrayType = new CodeTypeReference(item.GetRowCodeType(CodeType.Pointer), 1);
-                arrayType.SetCodeType(CodeType.Const | CodeType.Reference);
+                var arrayType = item.GetRowsCodeType(generationInfo.BaseNamespace, CodeType.Const | CodeType.Reference);
                 var childNameType = new CodeTypeReference(typeof(string));
                 childNameType.SetCodeType(CodeType.Const | CodeType.Reference);
                 cmm.Parameters.Add(childNameType, "childName");
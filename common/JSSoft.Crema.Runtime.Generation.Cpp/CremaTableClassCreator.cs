@@ -78,11 +78,10 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                 classType.Comments.Add(CremaSchema.ContentsModifiedDateTime, tableInfo.ContentsInfo.DateTime);
             }
 
-            CreateCreateRowInstanceMethod(classType, tableInfo, generationInfo);
             CreateFields(classType, tableInfo, generationInfo);
             CreateConstructor(classType, tableInfo, generationInfo);
             CreateConstructorFromTable(classType, tableInfo, generationInfo);
-            CreateConstructorFromRows(classType, tableInfo);
+            CreateConstructorFromRows(classType, tableInfo, generationInfo);
             CreateDestructor(classType, tableInfo, generationInfo);
             CreateFindMethod(classType, tableInfo, generationInfo);
 
@@ -153,7 +152,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             {
                 var table = new CodeVariableReferenceExpression("table");
                 var readFromFile = new CodeMethodReferenceExpression(new CodeThisReferenceExpression(), "ReadFromTable");
-                var methodInvoke = new CodeMethodInvokeExpression(readFromFile, table);
+                var methodInvoke = new CodeMethodInvokeExpression(readFromFile, table, thisRef);
 
                 cc.Statements.Add(methodInvoke);
             }
@@ -164,14 +163,13 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                 foreach (var item in generationInfo.GetChilds(tableInfo))
                 {
                     var setRelations = new CodeMethodReferenceExpression(thisRef, "SetRelations");
-                    var field = new CodeFieldPointerExpression(thisRef, item.TableName);
-                    var rows = new CodePropertyReferenceExpression(field, "Rows");
+                    var field = new CodeFieldReferenceExpression(thisRef, item.TableName);
                     var codeTypeRef = new CodeTypeReferenceExpression(tableInfo.GetRowCodeType(CodeType.None));
                     var setChildAction = new CodePropertyReferenceExpression(null, tableInfo.TableName + "Set" + item.TableName);
                     var tableName = new CodeMethodInvokeExpression(new CodeMethodReferenceExpression(table, "name"));
                     var childName = new CodeBinaryOperatorExpression(tableName, CodeBinaryOperatorType.Add, new CodePrimitiveExpression("." + item.TableName));
 
-                    var setRelationsInvoke = new CodeMethodInvokeExpression(setRelations, childName, rows, setChildAction);
+                    var setRelationsInvoke = new CodeMethodInvokeExpression(setRelations, childName, field, setChildAction);
                     cc.Statements.Add(setRelationsInvoke);
                 }
             }
@@ -180,7 +178,7 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             classType.Members.Add(cc);
         }
 
-        private static void CreateConstructorFromRows(CodeTypeDeclaration classType, TableInfo tableInfo)
+        private static void CreateConstructorFromRows(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
         {
             if (string.IsNullOrEmpty(tableInfo.ParentName) == true)
                 return;
@@ -190,11 +188,9 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
                 Attributes = MemberAttributes.Public
             };
 
-            var codeTypeRef = tableInfo.GetRowCodeType(CodeType.Pointer);
-            var arrayTypeRef = new CodeTypeReference(codeTypeRef, 1);
-            arrayTypeRef.SetCodeType(CodeType.Const | CodeType.Reference);
+            var rowsTypeRef = tableInfo.GetRowsCodeType(generationInfo.BaseNamespace, CodeType.Const | CodeType.Reference);
             cc.Parameters.Add(typeof(string), "name");
-            cc.Parameters.Add(arrayTypeRef, 1, "rows");
+            cc.Parameters.Add(rowsTypeRef, "rows");
             //cc.BaseConstructorArgs.Add("rows");
 
             {
@@ -264,30 +260,6 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             classType.Members.Add(cmm);
         }
 
-        private static void CreateCreateRowInstanceMethod(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
-        {
-            var cmm = new CodeMemberMethod
-            {
-                Attributes = MemberAttributes.Family | MemberAttributes.Override,
-                Name = "CreateRow",
-                ReturnType = new CodeTypeReference(typeof(object))
-            };
-            cmm.Parameters.Add(generationInfo.ReaderNamespace, "irow&", "row");
-            cmm.Parameters.Add(typeof(object), "table");
-
-            // statement
-            {
-                var row = new CodeVariableReferenceExpression("row");
-                var tablePtr = new CodeVariableReferenceExpression("table");
-                var table = new CodeCastExpression(tableInfo.GetCodeType(CodeType.Pointer), tablePtr);
-                var instance = new CodeObjectCreateExpression(tableInfo.GetRowCodeType(CodeType.None), row, table);
-
-                cmm.Statements.AddMethodReturn(instance);
-            }
-
-            classType.Members.Add(cmm);
-        }
-
         private static CodeStatement CreateCompareTypeStatement(CodeTypeDeclaration classType, TableInfo tableInfo, CodeGenerationInfo generationInfo)
         {
             var table = new CodeVariableReferenceExpression("table");
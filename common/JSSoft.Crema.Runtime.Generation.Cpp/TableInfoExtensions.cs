@@ -102,6 +102,13 @@ namespace JSSoft.Crema.Runtime.Generation.Cpp
             return codeTypeRef;
         }
 
+        public static CodeTypeReference GetRowsCodeType(this TableInfo tableInfo, string baseNamespace, CodeType codeType)
+        {
+            var codeTypeRef = new CodeTypeReference(string.Join(".", baseNamespace, CodeGenerationInfo.CremaRowsName), tableInfo.GetRowCodeType(CodeType.None));
+            codeTypeRef.SetCodeType(codeType);
+            return codeTypeRef;
+        }
+
         public static CodeTypeReferenceExpression GetRowCodeTypeExpression(this TableInfo tableInfo, CodeType codeType)
         {
             return new CodeTypeReferenceExpression(tableInfo.GetRowCodeType(codeType));
@@ -21,8 +21,14 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
 #include "crema_reader.h"
 #include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace CremaCode
 {
@@ -38,92 +44,280 @@ namespace CremaCode
 			return CremaData::ErrorOccured(e);
 		}
 
-		static ErrorOccured ErrorOccured;
+		static CremaCode::ErrorOccured ErrorOccured;
 	};
 
+	template<typename T>
+	class CremaRows;
+
 	class CremaRow
 	{
 
 	private:
-		std::string _relationID;
-		std::string _parentID;
+		int _relationID;
+		int _parentID;
 
-		long _key;
+		unsigned long long _key;
 
 	protected:
 		CremaRow(reader::irow& row)
-			: _key(-1)
+			: _relationID(0), _parentID(0), _key(-1)
 		{
-			std::ostringstream stringStream;
-
 			for (auto itor = row.table().columns().begin(); itor != row.table().columns().end(); itor++)
 			{
 				if ((*itor).name() == "__RelationID__")
 				{
-					_relationID = row.value<std::string>(*itor);
+					_relationID = ReadStringID(row, (*itor).index());
 				}
 				else if ((*itor).name() == "__ParentID__")
 				{
-					_parentID = row.value<std::string>(*itor);
+					_parentID = ReadStringID(row, (*itor).index());
 				}
 			}
 		}
 
 	protected:
-		template<typename keytype>
-		void SetKey(keytype keyvalue)
+		template<typename... keytypes>
+		void SetKey(const keytypes&... keyvalues)
+		{
+			_key = reader::iniutil::generate_hash(keyvalues...);
+		}
+
+	public:
+		template<typename T = CremaRow, typename U = CremaRow>
+		static void SetParent(T* parent, const CremaRows<U>& childs)
+		{
+			for (auto item : childs)
+			{
+				item->Parent = parent;
+			}
+		}
+
+	private:
+		friend unsigned long long GetKey(CremaRow* target)
+		{
+			return target->_key;
+		}
+
+		// 관계 ID 는 문자열 대신 리더의 문자열 테이블 ID 로 보관합니다. 같은 문자열은 같은 ID 를 가지며, 0 은 값이 없다는 뜻입니다.
+		friend int GetRelationID(const CremaRow* target)
 		{
-			_key = reader::iniutil::generate_hash(keyvalue);
+			return target->_relationID;
 		}
 
-		template<typename keytype1, typename keytype2>
-		void SetKey(keytype1 keyvalue1, keytype2 keyvalue2)
+		friend int GetParentID(const CremaRow* target)
 		{
-			_key = reader::iniutil::generate_hash(keyvalue1, keyvalue2);
+			return target->_parentID;
 		}
 
-		template<typename keytype1, typename keytype2, typename keytype3>
-		void SetKey(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3)
+		static int ReadStringID(reader::irow& row, size_t index)
 		{
-			_key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3);
+			const char* fields = row.fields();
+			int offset;
+			memcpy(&offset, fields + index * sizeof(int), sizeof(int));
+			if (offset == 0)
+				return 0;
+			int id;
+			memcpy(&id, fields + offset, sizeof(int));
+			return id;
 		}
+	};
 
-		template<typename keytype1, typename keytype2, typename keytype3, typename keytype4>
-		void SetKey(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3, keytype4 keyvalue4)
+	// 값을 복사하지 않고 리더가 가진 행 데이터를 직접 읽는 행입니다.
+	// 행 데이터는 열 개수만큼의 int 오프셋 뒤에 값들이 이어지며, 오프셋이 0 이면 값이 없습니다.
+	// 리더는 이 행을 가진 테이블보다 오래 유지되어야 합니다.
+	class CremaFieldRow : public CremaRow
+	{
+	private:
+		const reader::irow* _row;
+		const char* _fields;
+
+	protected:
+		CremaFieldRow(reader::irow& row)
+			: CremaRow(row), _row(&row), _fields(row.fields())
 		{
-			_key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3, keyvalue4);
+
+		}
+
+		template<typename T>
+		T Field(size_t index) const
+		{
+			const int offset = reinterpret_cast<const int*>(_fields)[index];
+			if (offset == 0)
+				return T();
+			T value;
+			memcpy(&value, _fields + offset, sizeof(T));
+			return value;
 		}
 
-		template<typename keytype1, typename keytype2, typename keytype3, typename keytype4, typename keytype5>
-		void SetKey(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3, keytype4 keyvalue4, keytype5 keyvalue5)
+		bool HasField(size_t index) const
 		{
-			_key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3, keyvalue4, keyvalue5);
+			return reinterpret_cast<const int*>(_fields)[index] != 0;
 		}
 
+		const std::string& StringField(size_t index) const
+		{
+			return _row->to_string(index);
+		}
+	};
+
+	// 키 해시로 행을 찾는 개방 주소 방식의 색인입니다.
+	// 해시가 같은 행도 모두 보관하며, 찾을 때는 해시가 같은 행마다 키를 직접 비교합니다.
+	template<class T = CremaRow>
+	class CremaKeyIndex
+	{
+	private:
+		struct Slot
+		{
+			unsigned long long key;
+			T* row;
+		};
+
+		std::vector<Slot> _slots;
+		size_t _mask;
+
 	public:
-		template<typename T = CremaRow, typename U = CremaRow>
-		static void SetParent(T* parent, const std::vector<U*>& childs)
+		CremaKeyIndex()
+			: _mask(0)
 		{
-			for (auto item : childs)
+
+		}
+
+		void Reserve(size_t count)
+		{
+			size_t capacity = 8;
+			while (capacity < count * 2)
+				capacity <<= 1;
+
+			Slot empty = { 0, nullptr };
+			_slots.assign(capacity, empty);
+			_mask = capacity - 1;
+		}
+
+		void Insert(unsigned long long key, T* row)
+		{
+			size_t slot = this->Bucket(key);
+			while (_slots[slot].row != nullptr)
+				slot = (slot + 1) & _mask;
+
+			_slots[slot].key = key;
+			_slots[slot].row = row;
+		}
+
+		template<typename Predicate>
+		T* Find(unsigned long long key, Predicate predicate) const
+		{
+			if (_slots.empty() == true)
+				return nullptr;
+
+			size_t slot = this->Bucket(key);
+			while (_slots[slot].row != nullptr)
 			{
-				item->Parent = parent;
+				if (_slots[slot].key == key && predicate(_slots[slot].row) == true)
+					return _slots[slot].row;
+				slot = (slot + 1) & _mask;
 			}
+			return nullptr;
 		}
 
 	private:
-		friend long GetKey(CremaRow* target)
+		size_t Bucket(unsigned long long key) const
 		{
-			return target->_key;
+			return (size_t)(key ^ (key >> 32)) & _mask;
 		}
+	};
+
+	// 연속된 행 포인터 배열의 일부를 복사 없이 가리키는 행 목록입니다.
+	// 자식 테이블은 부모 테이블이 관계 순서대로 모아 둔 배열에서 자신의 구간만 가리킵니다.
+	// 예전 Rows 는 const std::vector<T*>& 였으므로 읽기 전용 vector 멤버와 std::vector<T*> 로의 변환을 함께 제공합니다.
+	template<typename T>
+	class CremaRows
+	{
+	public:
+		typedef T* value_type;
+		typedef size_t size_type;
+		typedef T* const& const_reference;
+		typedef T* const* const_iterator;
+		typedef const_iterator iterator;
+
+	private:
+		const_iterator _begin;
+		const_iterator _end;
 
-		friend const std::string& GetRelationID(CremaRow* target)
+	public:
+		CremaRows()
+			: _begin(nullptr), _end(nullptr)
 		{
-			return target->_relationID;
+
 		}
 
-		friend const std::string& GetParentID(CremaRow* target)
+		CremaRows(const_iterator begin, const_iterator end)
+			: _begin(begin), _end(end)
 		{
-			return target->_parentID;
+
+		}
+
+		const_iterator begin() const
+		{
+			return _begin;
+		}
+
+		const_iterator end() const
+		{
+			return _end;
+		}
+
+		const_iterator cbegin() const
+		{
+			return _begin;
+		}
+
+		const_iterator cend() const
+		{
+			return _end;
+		}
+
+		T* const* data() const
+		{
+			return _begin;
+		}
+
+		T* front() const
+		{
+			return *_begin;
+		}
+
+		T* back() const
+		{
+			return *(_end - 1);
+		}
+
+		size_t size() const
+		{
+			return (size_t)(_end - _begin);
+		}
+
+		bool empty() const
+		{
+			return _begin == _end;
+		}
+
+		T* operator [] (size_t index) const
+		{
+			return _begin[index];
+		}
+
+		T* at(size_t index) const
+		{
+			if (index >= this->size())
+				throw std::out_of_range("index");
+			return _begin[index];
+		}
+
+		// 행 목록을 std::vector<T*> 로 받던 코드를 위한 변환입니다. 포인터 배열을 복사합니다.
+		operator std::vector<T*>() const
+		{
+			return std::vector<T*>(_begin, _end);
 		}
 	};
 
@@ -131,11 +325,14 @@ namespace CremaCode
 	class CremaTable
 	{
 	public:
-		const std::vector<T*>& Rows;
+		const CremaRows<T>& Rows;
 
 	private:
-		std::map<long, T*> _keyToRow;
-		std::vector<T*> _rows;
+		CremaKeyIndex<T> _keyToRow;
+		std::vector<T> _storage;
+		std::vector<T*> _rowPointers;
+		mutable std::vector<T*> _relationRows;
+		CremaRows<T> _rows;
 		std::string _name;
 		std::string _tableName;
 
@@ -146,14 +343,7 @@ namespace CremaCode
 
 		}
 
-		virtual ~CremaTable()
-		{
-			for (auto item : _rows)
-			{
-				delete item;
-			}
-			_rows.clear();
-		}
+		virtual ~CremaTable() {}
 
 		const std::string& name() const
 		{
@@ -166,107 +356,123 @@ namespace CremaCode
 		}
 
 	protected:
-		void ReadFromTable(reader::itable& table)
+		// 행은 _storage 에 값으로 연속해서 저장되고, Rows 는 그 순서대로 행을 가리킵니다.
+		template<typename U>
+		void ReadFromTable(reader::itable& table, U* owner)
 		{
 			_name = table.name();
 			_tableName = this->GetTableName(table.name());
-			_rows.reserve(table.rows().size());
-			for (size_t i = 0; i < table.rows().size(); i++)
+
+			const size_t count = table.rows().size();
+			_storage.reserve(count);
+			_rowPointers.reserve(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				_storage.emplace_back(table.rows().at(i), owner);
+			}
+			for (auto& item : _storage)
 			{
-				reader::irow& item = table.rows().at(i);
-				T* row = (T*)(this->CreateRow(item, this));
-				_keyToRow.insert(std::pair<long, T*>(GetKey(row), row));
-				_rows.push_back(row);
+				_rowPointers.push_back(&item);
 			}
+			if (count != 0)
+				_rows = CremaRows<T>(&_rowPointers.front(), &_rowPointers.front() + count);
+			this->BuildKeyIndex();
 		}
 
-		void ReadFromRows(const std::string& name, const std::vector<T*>& rows)
+		void ReadFromRows(const std::string& name, const CremaRows<T>& rows)
 		{
 			_name = name;
 			_tableName = this->GetTableName(name);
 			if (rows.size() == 0)
 				return;
 
-			_rows.reserve(rows.size());
-			for (auto item : rows)
-			{
-				_keyToRow.insert(std::pair<long, T*>(GetKey(item), item));
-				_rows.push_back(item);
-			}
+			_rows = rows;
+			this->BuildKeyIndex();
 		}
 
-		virtual void* CreateRow(reader::irow& row, void* table) = 0;
-
+		// 자식 행을 부모 행 순서대로 한 번의 계수 정렬로 모아 childTable 에 보관하고,
+		// 부모 행마다 자기 구간을 가리키는 행 목록으로 setChildsAction 을 호출합니다.
+		// 행을 직접 가진 테이블(ReadFromTable)에서만 호출됩니다.
 		template<typename U = CremaRow>
-		void SetRelations(const std::string& childName, const std::vector<U*>& childs, void(*setChildsAction)(T*, const std::string&, const std::vector<U*>&))
+		void SetRelations(const std::string& childName, const CremaTable<U>* childTable, void(*setChildsAction)(T*, const std::string&, const CremaRows<U>&))
 		{
-			std::map<std::string, T*> relationToRow;
+			const size_t parentCount = _storage.size();
+			const CremaRows<U>& childs = childTable->Rows;
+			if (parentCount == 0 || childs.size() == 0)
+				return;
 
-			for (auto item : this->Rows)
+			CremaKeyIndex<T> relationToRow;
+			relationToRow.Reserve(parentCount);
+			for (auto& item : _storage)
 			{
-				relationToRow.insert(std::pair<std::string, T*>(GetRelationID(item), item));
+				if (GetRelationID(&item) != 0)
+					relationToRow.Insert((unsigned int)GetRelationID(&item), &item);
 			}
 
-			std::map<T*, std::vector<U*>> rowToChilds;
-
-			for (auto item : childs)
+			const size_t none = (size_t)-1;
+			std::vector<size_t> parentIndexes(childs.size(), none);
+			std::vector<size_t> offsets(parentCount + 1, 0);
+			for (size_t i = 0; i < childs.size(); i++)
 			{
-				auto itor = relationToRow.find(GetParentID(item));
-				if (itor == relationToRow.end())
+				const int parentID = GetParentID(childs[i]);
+				if (parentID == 0)
 					continue;
 
-				auto parent = itor->second;
+				T* parent = relationToRow.Find((unsigned int)parentID, [&](const T* row) { return GetRelationID(row) == parentID; });
+				if (parent == nullptr)
+					continue;
 
-				if (rowToChilds.find(parent) == rowToChilds.end())
-					rowToChilds.insert(std::pair<T*, std::vector<U*>>(parent, std::vector<U*>()));
+				parentIndexes[i] = (size_t)(parent - &_storage.front());
+				offsets[parentIndexes[i] + 1]++;
+			}
 
-				rowToChilds[parent].push_back(item);
+			for (size_t i = 0; i < parentCount; i++)
+			{
+				offsets[i + 1] += offsets[i];
 			}
 
-			for (auto item : rowToChilds)
+			std::vector<U*>& grouped = childTable->_relationRows;
+			grouped.assign(offsets[parentCount], nullptr);
+			std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < childs.size(); i++)
 			{
-				setChildsAction(item.first, childName, item.second);
+				if (parentIndexes[i] != none)
+					grouped[positions[parentIndexes[i]]++] = childs[i];
 			}
-		}
 
-		template<typename keytype>
-		const T* FindRow(keytype keyvalue) const
-		{
-			long key = reader::iniutil::generate_hash(keyvalue);
-			return _keyToRow.find(key)->second;
-		}
+			for (size_t i = 0; i < parentCount; i++)
+			{
+				if (offsets[i] == offsets[i + 1])
+					continue;
 
-		template<typename keytype1, typename keytype2>
-		const T* FindRow(keytype1 keyvalue1, keytype2 keyvalue2) const
-		{
-			long key = reader::iniutil::generate_hash(keyvalue1, keyvalue2);
-			return _keyToRow.find(key)->second;
+				U* const* begin = &grouped.front();
+				setChildsAction(&_storage[i], childName, CremaRows<U>(begin + offsets[i], begin + offsets[i + 1]));
+			}
 		}
 
-		template<typename keytype1, typename keytype2, typename keytype3>
-		const T* FindRow(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3) const
+		// 키를 스택에서 inikey_value 로 묶어 해시하므로 찾을 때 메모리를 할당하지 않습니다.
+		template<typename... keytypes>
+		const T* FindRow(const keytypes&... keyvalues) const
 		{
-			long key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3);
-			return _keyToRow.find(key)->second;
+			unsigned long long key = reader::iniutil::generate_hash(keyvalues...);
+			return _keyToRow.Find(key, [&](const T* row) { return row->EqualsKey(keyvalues...); });
 		}
 
-		template<typename keytype1, typename keytype2, typename keytype3, typename keytype4>
-		const T* FindRow(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3, keytype4 keyvalue4) const
-		{
-			long key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3, keyvalue4);
-			return _keyToRow.find(key)->second;
-		}
+		friend class CremaRow;
 
-		template<typename keytype1, typename keytype2, typename keytype3, typename keytype4, typename keytype5>
-		const T* FindRow(keytype1 keyvalue1, keytype2 keyvalue2, keytype3 keyvalue3, keytype4 keyvalue4, keytype5 keyvalue5) const
+		template<typename U>
+		friend class CremaTable;
+
+	private:
+		void BuildKeyIndex()
 		{
-			long key = reader::iniutil::generate_hash(keyvalue1, keyvalue2, keyvalue3, keyvalue4, keyvalue5);
-			return _keyToRow.find(key)->second;
+			_keyToRow.Reserve(_rows.size());
+			for (auto item : _rows)
+			{
+				_keyToRow.Insert(GetKey(item), item);
+			}
 		}
 
-		friend class CremaRow;
-
-	private:
 		std::string GetTableName(const std::string& name) const
 		{
 			std::vector<std::string> elems;
@@ -282,5 +488,303 @@ namespace CremaCode
 			return elems[1];
 		}
 	};
+
+	// 처음 접근할 때 리더에서 테이블을 읽어 만드는 테이블입니다.
+	// 리더를 ReadFlag_lazy_loading 으로 열면 실제로 접근한 테이블만 파일에서 읽습니다.
+	// 잠그지 않으므로 여러 스레드가 서로 다른 테이블을 동시에 만들 수 있고, 리더는 이 테이블보다 오래 유지되어야 합니다.
+	// Reset 은 Get 과 동시에 부르면 안됩니다.
+	template<typename T>
+	class CremaLazyTable
+	{
+	private:
+		reader::idataset* _dataSet;
+		std::string _tableName;
+		mutable std::atomic<T*> _table;
+
+	public:
+		CremaLazyTable()
+			: _dataSet(nullptr), _table(nullptr)
+		{
+
+		}
+
+		~CremaLazyTable()
+		{
+			delete _table.load();
+		}
+
+		CremaLazyTable(const CremaLazyTable&) = delete;
+		CremaLazyTable& operator = (const CremaLazyTable&) = delete;
+
+		void Reset(reader::idataset& dataSet, const std::string& tableName)
+		{
+			delete _table.exchange(nullptr);
+			_dataSet = &dataSet;
+			_tableName = tableName;
+		}
+
+		const T* Get() const
+		{
+			T* table = _table.load(std::memory_order_acquire);
+			if (table != nullptr || _dataSet == nullptr)
+				return table;
+
+			// 같은 테이블을 여러 스레드가 동시에 만들면 먼저 게시한 것을 쓰고 나머지는 버립니다.
+			T* created = new T(_dataSet->tables()[_tableName]);
+			if (_table.compare_exchange_strong(table, created, std::memory_order_acq_rel, std::memory_order_acquire) == false)
+			{
+				delete created;
+				return table;
+			}
+			return created;
+		}
+
+		bool IsLoaded() const
+		{
+			return _table.load(std::memory_order_acquire) != nullptr;
+		}
+
+		const T* operator -> () const
+		{
+			return this->Get();
+		}
+
+		operator const T* () const
+		{
+			return this->Get();
+		}
+	};
+
+	// 데이터 한 벌(리비전)을 원자적으로 교체하는 핸들입니다.
+	// 요청 스레드는 Acquire 로 현재 리비전을 고정한 뒤 잠금 없이 읽고, 갱신 스레드는 새로 만든 리비전을 Publish 로 교체합니다.
+	// 교체된 리비전은 그 리비전을 고정한 스레드가 모두 놓은 뒤에(에포크 기준) 리더와 함께 해제됩니다.
+	// 리비전은 Publish 로 넘긴 뒤 수정하면 안되며, 핸들은 모든 Pin 보다 오래 유지되어야 합니다.
+	// 잠금 없이 고정할 수 있는 Pin 은 동시에 SlotCount(64) 개까지이고, 그보다 많으면 잠금을 거치는 느린 경로로 고정합니다.
+	template<typename T>
+	class CremaDataHandle
+	{
+	private:
+		struct Revision
+		{
+			T* data;
+			reader::CremaReader* reader;
+			unsigned long long epoch;
+		};
+
+		// 스레드마다 다른 캐시 라인을 쓰도록 슬롯을 64 바이트로 맞춥니다.
+		struct Slot
+		{
+			std::atomic<unsigned long long> epoch;
+			char padding[64 - sizeof(std::atomic<unsigned long long>)];
+		};
+
+		static const size_t SlotCount = 64;
+		static const unsigned long long Idle = ~0ULL;
+
+	public:
+		class Pin
+		{
+		public:
+			Pin(Pin&& other)
+				: _slot(other._slot), _handle(other._handle), _epoch(other._epoch), _data(other._data)
+			{
+				other._slot = nullptr;
+				other._handle = nullptr;
+				other._data = nullptr;
+			}
+
+			~Pin()
+			{
+				if (_slot != nullptr)
+					_slot->epoch.store(Idle, std::memory_order_release);
+				else if (_handle != nullptr)
+					_handle->Unpin(_epoch);
+			}
+
+			Pin(const Pin&) = delete;
+			Pin& operator = (const Pin&) = delete;
+			Pin& operator = (Pin&&) = delete;
+
+			const T* Get() const
+			{
+				return _data;
+			}
+
+			const T* operator -> () const
+			{
+				return _data;
+			}
+
+			const T& operator * () const
+			{
+				return *_data;
+			}
+
+			explicit operator bool () const
+			{
+				return _data != nullptr;
+			}
+
+		private:
+			Pin(Slot* slot, const T* data)
+				: _slot(slot), _handle(nullptr), _epoch(Idle), _data(data)
+			{
+
+			}
+
+			Pin(const CremaDataHandle* handle, unsigned long long epoch, const T* data)
+				: _slot(nullptr), _handle(handle), _epoch(epoch), _data(data)
+			{
+
+			}
+
+			Slot* _slot;
+			const CremaDataHandle* _handle;
+			unsigned long long _epoch;
+			const T* _data;
+
+			friend class CremaDataHandle;
+		};
+
+		CremaDataHandle()
+			: _current(nullptr), _epoch(0)
+		{
+			for (size_t i = 0; i < SlotCount; i++)
+			{
+				_slots[i].epoch.store(Idle, std::memory_order_relaxed);
+			}
+		}
+
+		~CremaDataHandle()
+		{
+			Free(_current.exchange(nullptr));
+			for (size_t i = 0; i < _retired.size(); i++)
+			{
+				Free(_retired[i]);
+			}
+		}
+
+		CremaDataHandle(const CremaDataHandle&) = delete;
+		CremaDataHandle& operator = (const CremaDataHandle&) = delete;
+
+		// 현재 리비전을 고정합니다. Pin 이 살아있는 동안 리비전의 테이블과 행은 해제되지 않습니다.
+		// 빈 슬롯이 없으면 기다리지 않고 _overflow 에 에포크를 기록하는 느린 경로로 고정합니다.
+		Pin Acquire() const
+		{
+			size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % SlotCount;
+			for (size_t i = 0; i < SlotCount; i++)
+			{
+				Slot& slot = _slots[(index + i) % SlotCount];
+				unsigned long long expected = Idle;
+				if (slot.epoch.load(std::memory_order_relaxed) == Idle
+					&& slot.epoch.compare_exchange_strong(expected, _epoch.load()))
+				{
+					Revision* revision = _current.load();
+					return Pin(&slot, revision != nullptr ? revision->data : nullptr);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(_overflowLock);
+			unsigned long long epoch = _epoch.load();
+			_overflow.push_back(epoch);
+			Revision* revision = _current.load();
+			return Pin(this, epoch, revision != nullptr ? revision->data : nullptr);
+		}
+
+		// 새 리비전으로 교체합니다. reader 를 넘기면 리비전이 해제될 때 reader 도 destroy 됩니다.
+		void Publish(T* data, reader::CremaReader* reader = nullptr)
+		{
+			Revision* revision = new Revision();
+			revision->data = data;
+			revision->reader = reader;
+			revision->epoch = 0;
+
+			std::lock_guard<std::mutex> lock(_retiredLock);
+			Revision* old = _current.exchange(revision);
+			if (old != nullptr)
+			{
+				old->epoch = _epoch.fetch_add(1) + 1;
+				_retired.push_back(old);
+			}
+			this->ReclaimCore();
+		}
+
+		// 고정한 스레드가 없는 이전 리비전을 해제하고 해제한 개수를 반환합니다.
+		size_t Reclaim()
+		{
+			std::lock_guard<std::mutex> lock(_retiredLock);
+			return this->ReclaimCore();
+		}
+
+		size_t RetiredCount() const
+		{
+			std::lock_guard<std::mutex> lock(_retiredLock);
+			return _retired.size();
+		}
+
+	private:
+		size_t ReclaimCore()
+		{
+			unsigned long long minimum = Idle;
+			for (size_t i = 0; i < SlotCount; i++)
+			{
+				unsigned long long epoch = _slots[i].epoch.load();
+				if (epoch < minimum)
+					minimum = epoch;
+			}
+			{
+				std::lock_guard<std::mutex> lock(_overflowLock);
+				for (size_t i = 0; i < _overflow.size(); i++)
+				{
+					if (_overflow[i] < minimum)
+						minimum = _overflow[i];
+				}
+			}
+
+			size_t count = 0;
+			for (size_t i = 0; i < _retired.size();)
+			{
+				if (_retired[i]->epoch <= minimum)
+				{
+					Free(_retired[i]);
+					_retired[i] = _retired.back();
+					_retired.pop_back();
+					count++;
+				}
+				else
+				{
+					i++;
+				}
+			}
+			return count;
+		}
+
+		void Unpin(unsigned long long epoch) const
+		{
+			std::lock_guard<std::mutex> lock(_overflowLock);
+			std::vector<unsigned long long>::iterator i = std::find(_overflow.begin(), _overflow.end(), epoch);
+			*i = _overflow.back();
+			_overflow.pop_back();
+		}
+
+		static void Free(Revision* revision)
+		{
+			if (revision == nullptr)
+				return;
+			delete revision->data;
+			if (revision->reader != nullptr)
+				revision->reader->destroy();
+			delete revision;
+		}
+
+	private:
+		std::atomic<Revision*> _current;
+		std::atomic<unsigned long long> _epoch;
+		mutable Slot _slots[SlotCount];
+		mutable std::mutex _overflowLock;
+		mutable std::vector<unsigned long long> _overflow;
+		mutable std::mutex _retiredLock;
+		std::vector<Revision*> _retired;
+	};
 } /*namespace CremaCode*/
 
@@ -47,5 +47,15 @@ namespace JSSoft.Crema.Runtime.Generation
         /// 코드를 생성하지 않습니다.
         /// </summary>
         OmitCode = 8,
+
+        /// <summary>
+        /// 행의 값을 복사하지 않고 리더의 행 데이터를 직접 읽는 접근자를 생성합니다.
+        /// </summary>
+        ZeroCopyRows = 16,
+
+        /// <summary>
+        /// 테이블을 처음 접근할 때 읽어 만드는 데이터 클래스를 생성합니다.
+        /// </summary>
+        LazyTables = 32,
     }
 }
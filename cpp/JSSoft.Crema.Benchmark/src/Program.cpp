@@ -0,0 +1,148 @@
+﻿#include "benchmark.h"
+#include "synthetic_data.h"
+#include "include/crema/inireader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+
+namespace CremaBenchmark
+{
+	volatile unsigned long long sink = 0;
+} /*namespace CremaBenchmark*/
+
+namespace
+{
+	void usage()
+	{
+		std::cout << "usage: JSSoft.Crema.Benchmark [options] [key_index] [reader] [dataset] [trace] [remote] [generate]" << std::endl;
+		std::cout << "  remote needs a boost build (make BOOST=1)" << std::endl;
+		std::cout << "  --rows        rows per synthetic table (default 10000)" << std::endl;
+		std::cout << "  --tables      synthetic table count, at least 4 (default 8)" << std::endl;
+		std::cout << "  --iterations  measured runs per benchmark (default 5)" << std::endl;
+		std::cout << "  --file        synthetic data path (default crema_benchmark.dat, removed on exit unless generate)" << std::endl;
+		std::cout << "  --keys        key column types, e.g. int,string,long,int (generate only)" << std::endl;
+		std::cout << "  --values      value column types, e.g. int,double,string,dateTime (generate only)" << std::endl;
+		std::cout << "  --strings     distinct strings per value column (default 100)" << std::endl;
+		std::cout << "  --nulls       float/double columns are empty every N rows, 0 for never (default 10)" << std::endl;
+		std::cout << "  --threads     table encoding and parallel loading threads, 0 for all cores (default 0)" << std::endl;
+		std::cout << "  --compress    write LZ4 compressed tables (not readable by the dataset suite)" << std::endl;
+		std::cout << "  --trace       Chrome trace event output of the trace suite (chrome://tracing, Perfetto)" << std::endl;
+		std::cout << "  --cold        drop the file from the page cache before every read of the reader suite (Linux only)" << std::endl;
+	}
+
+	void generate(const std::string& path, const CremaBenchmark::synthetic::spec& spec)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		CremaBenchmark::synthetic::write(path, spec);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		std::ifstream stream(path.c_str(), std::ios::binary | std::ios::ate);
+		double seconds = (double)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() / 1000.0;
+		double megabytes = (double)stream.tellg() / (1024.0 * 1024.0);
+		std::cout << "[generate] " << path << ": " << spec.tables << " tables, " << spec.rows << " rows per table, "
+			<< std::fixed << std::setprecision(1) << megabytes << " MB in " << std::setprecision(2) << seconds << " s" << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	CremaBenchmark::options options;
+	options.rows = 10000;
+	options.tables = 8;
+	options.iterations = 5;
+	options.path = "crema_benchmark.dat";
+	options.cold = false;
+	CremaBenchmark::synthetic::spec spec;
+	bool customized = false;
+
+	std::set<std::string> suites;
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (strcmp(arg, "--rows") == 0 && value != nullptr)
+			options.rows = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--tables") == 0 && value != nullptr)
+			options.tables = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--iterations") == 0 && value != nullptr)
+			options.iterations = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--file") == 0 && value != nullptr)
+			options.path = argv[++i];
+		else if (strcmp(arg, "--keys") == 0 && value != nullptr)
+			spec.keys = CremaBenchmark::synthetic::parse_columns(argv[++i], "K"), customized = true;
+		else if (strcmp(arg, "--values") == 0 && value != nullptr)
+			spec.values = CremaBenchmark::synthetic::parse_columns(argv[++i], "V"), customized = true;
+		else if (strcmp(arg, "--strings") == 0 && value != nullptr)
+			spec.string_cardinality = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--nulls") == 0 && value != nullptr)
+			spec.null_interval = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--threads") == 0 && value != nullptr)
+			spec.threads = (size_t)strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(arg, "--trace") == 0 && value != nullptr)
+			options.trace = argv[++i];
+		else if (strcmp(arg, "--compress") == 0)
+			spec.compression = true;
+		else if (strcmp(arg, "--cold") == 0)
+			options.cold = true;
+		else if (arg[0] != '-')
+			suites.insert(arg);
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	bool generating = suites.count("generate") != 0;
+	bool benchmarking = suites.empty() == true || suites.count("reader") != 0 || suites.count("dataset") != 0 || suites.count("trace") != 0 || suites.count("remote") != 0;
+	bool readingDataset = suites.empty() == true || suites.count("dataset") != 0;
+	if (options.rows == 0 || options.tables < 4 || options.iterations == 0 || spec.keys.empty() == true || spec.string_cardinality == 0 ||
+		(benchmarking == true && customized == true) || (readingDataset == true && spec.compression == true))
+	{
+		usage();
+		return 1;
+	}
+	spec.rows = options.rows;
+	spec.tables = options.tables;
+	CremaReader::CremaReader::set_thread_count(spec.threads);
+
+	try
+	{
+		if (suites.empty() == true || suites.count("key_index") != 0)
+			CremaBenchmark::run_key_index();
+
+		if (generating == true)
+			generate(options.path, spec);
+
+		if (benchmarking == true)
+		{
+			if (generating == false)
+				CremaBenchmark::synthetic::write(options.path, spec);
+			if (suites.empty() == true || suites.count("reader") != 0)
+				CremaBenchmark::run_reader(options);
+			if (readingDataset == true)
+				CremaBenchmark::run_dataset(options);
+			if (suites.empty() == true || suites.count("trace") != 0)
+				CremaBenchmark::run_trace(options);
+#ifndef _IGNORE_BOOST
+			if (suites.empty() == true || suites.count("remote") != 0)
+				CremaBenchmark::run_remote(options);
+#else
+			if (suites.count("remote") != 0)
+				std::cout << "[remote] skipped: build with make BOOST=1" << std::endl;
+#endif
+			if (generating == false)
+				std::remove(options.path.c_str());
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		if (generating == false)
+			std::remove(options.path.c_str());
+		return 1;
+	}
+	return 0;
+}
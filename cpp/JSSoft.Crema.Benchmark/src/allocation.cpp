@@ -0,0 +1,44 @@
+﻿#include "benchmark.h"
+#include <cstdlib>
+#include <new>
+
+namespace CremaBenchmark
+{
+	std::atomic<unsigned long long> allocations(0);
+	thread_local unsigned long long thread_allocations = 0;
+} /*namespace CremaBenchmark*/
+
+void* operator new(size_t size)
+{
+	CremaBenchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+	CremaBenchmark::thread_allocations++;
+	void* ptr = std::malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
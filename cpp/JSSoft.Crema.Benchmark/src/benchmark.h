@@ -0,0 +1,63 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "include/crema/inidefine.h"
+
+namespace CremaBenchmark
+{
+	// 측정 대상이 최적화로 사라지지 않도록 결과를 모아 두는 값입니다.
+	extern volatile unsigned long long sink;
+
+	// 전역 operator new 가 호출된 횟수입니다. allocation.cpp 에서 셉니다.
+	extern std::atomic<unsigned long long> allocations;
+	// 호출한 스레드에서 일어난 할당 횟수입니다.
+	extern thread_local unsigned long long thread_allocations;
+
+	struct options
+	{
+		size_t rows;
+		size_t tables;
+		size_t iterations;
+		std::string path;
+		// 비어 있지 않으면 trace 에서 Chrome trace event 파일을 씁니다.
+		std::string trace;
+		// reader 에서 파일을 열 때마다 페이지 캐시를 비워 디스크에서 읽게 합니다. 리눅스에서만 동작합니다.
+		bool cold;
+	};
+
+	// func 를 iterations 번 실행하고 func 안에서 수행한 작업 operations 개당 평균 시간(ns)과 할당 횟수, 실행 한번의 할당 횟수를 출력합니다.
+	template<typename Func>
+	double measure(const std::string& name, size_t iterations, size_t operations, Func func)
+	{
+		func();
+
+		unsigned long long allocated = allocations.load(std::memory_order_relaxed);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++)
+		{
+			func();
+		}
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		allocated = allocations.load(std::memory_order_relaxed) - allocated;
+
+		double count = (double)(iterations * operations);
+		double elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		double average = elapsed / count;
+		std::cout << std::left << std::setw(40) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << average << " ns"
+			<< std::setw(12) << std::setprecision(2) << (double)allocated / count << " allocs"
+			<< std::setw(12) << allocated / iterations << " allocs/run" << std::endl;
+		return average;
+	}
+
+	void run_key_index();
+	void run_reader(const options& options);
+	void run_dataset(const options& options);
+	void run_trace(const options& options);
+#ifndef _IGNORE_BOOST
+	// 원격 읽기를 standin_server 에 붙여 확인하고 측정합니다. 결과가 파일에서 읽은 것과 다르면 예외를 던집니다.
+	void run_remote(const options& options);
+#endif
+} /*namespace CremaBenchmark*/
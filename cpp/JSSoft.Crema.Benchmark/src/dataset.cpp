@@ -0,0 +1,290 @@
+﻿#include "benchmark.h"
+#include "synthetic_data.h"
+#include "crema_base.h"
+
+namespace CremaBenchmark
+{
+	namespace
+	{
+		using namespace CremaCode;
+
+		// 아래 클래스들은 synthetic 스키마로 코드 생성기가 만드는 코드와 같은 모양이며, 열 접근자만 SyntheticRow 로 모았습니다.
+		class SyntheticRow : public CremaFieldRow
+		{
+		protected:
+			SyntheticRow(reader::irow& row)
+				: CremaFieldRow(row)
+			{
+
+			}
+
+		public:
+			int K0() const { return this->Field<int>(0); }
+			const std::string& K1() const { return this->StringField(1); }
+			long long K2() const { return this->Field<long long>(2); }
+			int K3() const { return this->Field<int>(3); }
+			int Value() const { return this->Field<int>(4); }
+			double Ratio() const { return this->Field<double>(5); }
+			bool HasRatio() const { return this->HasField(5); }
+			const std::string& Name() const { return this->StringField(6); }
+			time_t Stamp() const { return (time_t)this->Field<long long>(7); }
+		};
+
+		class Key1Row : public SyntheticRow
+		{
+		public:
+			Key1Row(reader::irow& row, void* /*table*/)
+				: SyntheticRow(row)
+			{
+				this->SetKey(this->K0());
+			}
+
+			bool EqualsKey(int K0) const
+			{
+				return this->K0() == K0;
+			}
+		};
+
+		class Key2Row : public SyntheticRow
+		{
+		public:
+			Key2Row(reader::irow& row, void* /*table*/)
+				: SyntheticRow(row)
+			{
+				this->SetKey(this->K0(), this->K1().c_str());
+			}
+
+			bool EqualsKey(int K0, const char* K1) const
+			{
+				return this->K0() == K0 && this->K1() == K1;
+			}
+		};
+
+		class Key3Row : public SyntheticRow
+		{
+		public:
+			Key3Row(reader::irow& row, void* /*table*/)
+				: SyntheticRow(row)
+			{
+				this->SetKey(this->K0(), this->K1().c_str(), this->K2());
+			}
+
+			bool EqualsKey(int K0, const char* K1, long long K2) const
+			{
+				return this->K0() == K0 && this->K1() == K1 && this->K2() == K2;
+			}
+		};
+
+		class Key4Row : public SyntheticRow
+		{
+		public:
+			Key4Row(reader::irow& row, void* /*table*/)
+				: SyntheticRow(row)
+			{
+				this->SetKey(this->K0(), this->K1().c_str(), this->K2(), this->K3());
+			}
+
+			bool EqualsKey(int K0, const char* K1, long long K2, int K3) const
+			{
+				return this->K0() == K0 && this->K1() == K1 && this->K2() == K2 && this->K3() == K3;
+			}
+		};
+
+		class Key1Table : public CremaTable<Key1Row>
+		{
+		public:
+			Key1Table(reader::itable& table)
+			{
+				this->ReadFromTable(table, this);
+			}
+
+			const Key1Row* Find(int K0) const
+			{
+				return this->FindRow(K0);
+			}
+		};
+
+		class Key2Table : public CremaTable<Key2Row>
+		{
+		public:
+			Key2Table(reader::itable& table)
+			{
+				this->ReadFromTable(table, this);
+			}
+
+			const Key2Row* Find(int K0, const std::string& K1) const
+			{
+				return this->FindRow(K0, K1.c_str());
+			}
+		};
+
+		class Key3Table : public CremaTable<Key3Row>
+		{
+		public:
+			Key3Table(reader::itable& table)
+			{
+				this->ReadFromTable(table, this);
+			}
+
+			const Key3Row* Find(int K0, const std::string& K1, long long K2) const
+			{
+				return this->FindRow(K0, K1.c_str(), K2);
+			}
+		};
+
+		class Key4Table : public CremaTable<Key4Row>
+		{
+		public:
+			Key4Table(reader::itable& table)
+			{
+				this->ReadFromTable(table, this);
+			}
+
+			const Key4Row* Find(int K0, const std::string& K1, long long K2, int K3) const
+			{
+				return this->FindRow(K0, K1.c_str(), K2, K3);
+			}
+		};
+
+		class CremaDataSet
+		{
+		public:
+			const Key1Table* Key1;
+			const Key2Table* Key2;
+			const Key3Table* Key3;
+			const Key4Table* Key4;
+
+			CremaDataSet(reader::idataset& dataSet)
+				: Key1(nullptr), Key2(nullptr), Key3(nullptr), Key4(nullptr)
+			{
+				this->Key1 = new Key1Table(dataSet.tables()["Key1"]);
+				this->Key2 = new Key2Table(dataSet.tables()["Key2"]);
+				this->Key3 = new Key3Table(dataSet.tables()["Key3"]);
+				this->Key4 = new Key4Table(dataSet.tables()["Key4"]);
+			}
+
+			~CremaDataSet()
+			{
+				delete this->Key1;
+				delete this->Key2;
+				delete this->Key3;
+				delete this->Key4;
+			}
+		};
+
+		// --lazy-tables 로 생성한 코드와 같은 모양입니다.
+		class CremaLazyDataSet
+		{
+		public:
+			CremaLazyTable<Key1Table> Key1;
+			CremaLazyTable<Key2Table> Key2;
+			CremaLazyTable<Key3Table> Key3;
+			CremaLazyTable<Key4Table> Key4;
+
+			CremaLazyDataSet(reader::idataset& dataSet)
+			{
+				this->Key1.Reset(dataSet, "Key1");
+				this->Key2.Reset(dataSet, "Key2");
+				this->Key3.Reset(dataSet, "Key3");
+				this->Key4.Reset(dataSet, "Key4");
+			}
+		};
+
+		template<typename Func>
+		void run_find(const options& options, const std::string& name, Func find)
+		{
+			size_t missing = 0;
+			measure(name, options.iterations, options.rows, [&]()
+			{
+				missing = 0;
+				for (size_t i = 0; i < options.rows; i++)
+				{
+					if (find(i) == false)
+						missing++;
+				}
+			});
+			if (missing != 0)
+				std::cout << "  missing rows: " << missing << std::endl;
+		}
+
+		void run_find(const options& options, const CremaDataSet& dataSet)
+		{
+			using namespace synthetic;
+
+			std::vector<std::string> names(options.rows);
+			for (size_t i = 0; i < names.size(); i++)
+			{
+				names[i] = k1(i);
+			}
+
+			run_find(options, "  Find (1 key)", [&](size_t i)
+			{
+				return dataSet.Key1->Find(k0(i)) != nullptr;
+			});
+
+			run_find(options, "  Find (2 keys)", [&](size_t i)
+			{
+				return dataSet.Key2->Find(k0(i), names[i]) != nullptr;
+			});
+
+			run_find(options, "  Find (3 keys)", [&](size_t i)
+			{
+				return dataSet.Key3->Find(k0(i), names[i], k2(i)) != nullptr;
+			});
+
+			run_find(options, "  Find (4 keys)", [&](size_t i)
+			{
+				return dataSet.Key4->Find(k0(i), names[i], k2(i), k3(i)) != nullptr;
+			});
+
+			measure("  iterate fields", options.iterations, options.rows, [&]()
+			{
+				unsigned long long sum = 0;
+				for (const Key1Row* row : dataSet.Key1->Rows)
+				{
+					sum += (unsigned long long)row->Value();
+					sum += (unsigned long long)row->Ratio();
+					sum += row->Name().length();
+					sum += (unsigned long long)row->Stamp();
+				}
+				sink = sink + sum;
+			});
+		}
+	}
+
+	void run_dataset(const options& options)
+	{
+		size_t rows = options.rows * 4;
+		std::cout << "[generated CremaDataSet] rows per table: " << options.rows << " (time per row)" << std::endl;
+
+		measure("  read + CremaDataSet", options.iterations, rows, [&]()
+		{
+			reader::CremaReader& reader = reader::CremaReader::ReadFromFile(options.path);
+			{
+				CremaDataSet dataSet(reader);
+				sink = sink + dataSet.Key1->Rows.size();
+			}
+			reader.destroy();
+		});
+
+		reader::CremaReader& reader = reader::CremaReader::ReadFromFile(options.path);
+		measure("  CremaDataSet", options.iterations, rows, [&]()
+		{
+			CremaDataSet dataSet(reader);
+			sink = sink + dataSet.Key1->Rows.size();
+		});
+
+		measure("  lazy read + CremaLazyDataSet (1 table)", options.iterations, options.rows, [&]()
+		{
+			reader::CremaReader& lazyReader = reader::CremaReader::ReadFromFile(options.path, reader::ReadFlag_lazy_loading);
+			{
+				CremaLazyDataSet dataSet(lazyReader);
+				sink = sink + dataSet.Key1->Rows.size();
+			}
+			lazyReader.destroy();
+		});
+
+		run_find(options, CremaDataSet(reader));
+		reader.destroy();
+	}
+} /*namespace CremaBenchmark*/
@@ -0,0 +1,101 @@
+﻿#include "benchmark.h"
+#include "crema_base.h"
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace CremaBenchmark
+{
+	namespace
+	{
+		// 생성된 코드의 행처럼 키 두개(int, string)를 가진 행입니다.
+		struct key_row
+		{
+			int Type;
+			std::string Name;
+
+			bool EqualsKey(int type, const char* name) const
+			{
+				return this->Type == type && this->Name == name;
+			}
+		};
+
+		void run_size(size_t count, size_t iterations)
+		{
+			std::vector<key_row> rows(count);
+			std::vector<unsigned long long> keys(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				std::ostringstream stream;
+				stream << "Item" << i;
+				rows[i].Type = (int)i;
+				rows[i].Name = stream.str();
+				keys[i] = CremaCode::reader::iniutil::generate_hash(rows[i].Type, rows[i].Name.c_str());
+			}
+
+			std::cout << "rows: " << count << std::endl;
+
+			std::map<unsigned long long, key_row*> map;
+			measure("  std::map build", iterations, count, [&]()
+			{
+				map.clear();
+				for (size_t i = 0; i < count; i++)
+				{
+					map.insert(std::make_pair(keys[i], &rows[i]));
+				}
+			});
+
+			CremaCode::CremaKeyIndex<key_row> index;
+			measure("  CremaKeyIndex build", iterations, count, [&]()
+			{
+				index.Reserve(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					index.Insert(keys[i], &rows[i]);
+				}
+			});
+
+			measure("  std::map find", iterations, count, [&]()
+			{
+				unsigned long long sum = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					std::map<unsigned long long, key_row*>::const_iterator itor = map.find(keys[i]);
+					if (itor != map.end())
+						sum += (unsigned long long)itor->second->Type;
+				}
+				sink = sink + sum;
+			});
+
+			measure("  CremaKeyIndex find", iterations, count, [&]()
+			{
+				unsigned long long sum = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					const key_row& row = rows[i];
+					key_row* found = index.Find(keys[i], [&](const key_row* item) { return item->EqualsKey(row.Type, row.Name.c_str()); });
+					if (found != nullptr)
+						sum += (unsigned long long)found->Type;
+				}
+				sink = sink + sum;
+			});
+
+			size_t missing = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				const key_row& row = rows[i];
+				if (index.Find(keys[i], [&](const key_row* item) { return item->EqualsKey(row.Type, row.Name.c_str()); }) != &row)
+					missing++;
+			}
+			std::cout << "  std::map dropped by collision: " << (count - map.size()) << ", CremaKeyIndex missing: " << missing << std::endl;
+		}
+	}
+
+	void run_key_index()
+	{
+		std::cout << "[key index]" << std::endl;
+		run_size(1000, 1000);
+		run_size(100000, 10);
+		run_size(1000000, 2);
+	}
+} /*namespace CremaBenchmark*/
@@ -0,0 +1,209 @@
+﻿#include "benchmark.h"
+#include "synthetic_data.h"
+#include "include/crema/inireader.h"
+#include "src/binary_reader.h"
+#include <fstream>
+#include <vector>
+#include <stdexcept>
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CremaBenchmark
+{
+	namespace
+	{
+		using CremaReader::icolumn_array;
+		using CremaReader::inicolumn;
+		using CremaReader::irow;
+		using CremaReader::irow_array;
+		using CremaReader::itable;
+		using CremaReader::ReadFlag;
+		using CremaReader::ReadFlag_none;
+		using CremaReader::ReadFlag_lazy_loading;
+		using CremaReader::ReadFlag_memory_mapped;
+		using CremaReader::ReadFlag_parallel_loading;
+		using CremaReader::internal::binary::binary_reader;
+		using CremaReader::internal::binary::binary_table;
+
+		// 페이지 캐시에서 파일을 내려 다음 읽기가 디스크를 거치게 합니다.
+		void evict(const options& options)
+		{
+#ifndef _MSC_VER
+			if (options.cold == false)
+				return;
+			int file = ::open(options.path.c_str(), O_RDONLY);
+			if (file == -1)
+				return;
+			::posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+			::close(file);
+#else
+			(void)options;
+#endif
+		}
+
+		void run_read(const options& options, const std::string& name, ReadFlag flag, size_t operations)
+		{
+			measure(name, options.iterations, operations, [&]()
+			{
+				evict(options);
+				CremaReader::CremaReader& reader = CremaReader::CremaReader::read(options.path, flag);
+				sink = sink + reader.tables().size();
+				reader.destroy();
+			});
+		}
+
+		// 파일 이름 대신 std::ifstream 을 넘기면 테이블을 읽을 때마다 스트림을 잠그므로 파일에서 여는 경우와 비교할 수 있습니다.
+		void run_read_stream(const options& options, const std::string& name, ReadFlag flag, size_t operations)
+		{
+			measure(name, options.iterations, operations, [&]()
+			{
+				evict(options);
+				std::ifstream stream(options.path.c_str(), std::ios::binary);
+				CremaReader::CremaReader& reader = CremaReader::CremaReader::read(stream, flag);
+				sink = sink + reader.tables().size();
+				reader.destroy();
+			});
+		}
+
+		// 테이블마다 행 구간(rowsOffset..stringResourcesOffset)만 남기는지 봅니다.
+		void check_arena(const options& options, binary_reader& binaryReader)
+		{
+			using namespace CremaReader::internal::binary;
+
+			std::ifstream stream(options.path.c_str(), std::ios::binary);
+			file_header fileHeader;
+			stream.read((char*)&fileHeader, sizeof(file_header));
+			std::vector<table_index> indexes(fileHeader.tableCount);
+			if (indexes.empty() == false)
+				stream.read((char*)&indexes.front(), sizeof(table_index) * indexes.size());
+
+			for (size_t i = 0; i < indexes.size(); i++)
+			{
+				table_header tableHeader;
+				stream.seekg(indexes[i].offset, std::ios::beg);
+				stream.read((char*)&tableHeader, sizeof(table_header));
+				if (tableHeader.magicValue == compressed_table_magic_value)
+					continue;
+
+				binary_table* table = binaryReader.read_table(i);
+				size_t arenaSize = table->m_rows.arena_size();
+				delete table;
+				if (arenaSize != (size_t)(tableHeader.stringResourcesOffset - tableHeader.rowsOffset))
+					throw std::runtime_error("[reader] row arena holds more than the rows section");
+			}
+		}
+
+		void run_read_table(const options& options)
+		{
+			CremaReader::CremaReader& reader = CremaReader::CremaReader::read(options.path, ReadFlag_lazy_loading);
+			binary_reader& binaryReader = dynamic_cast<binary_reader&>(reader);
+			size_t count = reader.tables().size();
+
+			check_arena(options, binaryReader);
+
+			measure("  read_table", options.iterations, count * options.rows, [&]()
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					binary_table* table = binaryReader.read_table(i);
+					sink = sink + table->rows().size();
+					delete table;
+				}
+			});
+			reader.destroy();
+		}
+
+		template<typename Func>
+		void run_find(const options& options, itable& table, const std::string& name, Func find)
+		{
+			irow_array& rows = const_cast<irow_array&>(table.rows());
+			size_t missing = 0;
+			measure(name, options.iterations, rows.size(), [&]()
+			{
+				missing = 0;
+				for (size_t i = 0; i < rows.size(); i++)
+				{
+					if (find(rows, i) == rows.end())
+						missing++;
+				}
+			});
+			if (missing != 0)
+				std::cout << "  missing rows: " << missing << std::endl;
+		}
+
+		void run_find(const options& options, CremaReader::CremaReader& reader)
+		{
+			using namespace synthetic;
+
+			std::vector<std::string> names(options.rows);
+			for (size_t i = 0; i < names.size(); i++)
+			{
+				names[i] = k1(i);
+			}
+
+			run_find(options, reader.tables()[table_name(0)], "  find (1 key)", [](irow_array& rows, size_t i)
+			{
+				return rows.find(k0(i));
+			});
+
+			run_find(options, reader.tables()[table_name(1)], "  find (2 keys)", [&](irow_array& rows, size_t i)
+			{
+				return rows.find(k0(i), names[i]);
+			});
+
+			run_find(options, reader.tables()[table_name(2)], "  find (3 keys)", [&](irow_array& rows, size_t i)
+			{
+				return rows.find(k0(i), names[i], k2(i));
+			});
+
+			run_find(options, reader.tables()[table_name(3)], "  find (4 keys)", [&](irow_array& rows, size_t i)
+			{
+				return rows.find(k0(i), names[i], k2(i), k3(i));
+			});
+		}
+
+		void run_iterate(const options& options, CremaReader::CremaReader& reader)
+		{
+			const itable& table = reader.tables()[synthetic::table_name(0)];
+			const icolumn_array& columns = table.columns();
+			const inicolumn& value = columns["Value"];
+			const inicolumn& ratio = columns["Ratio"];
+			const inicolumn& name = columns["Name"];
+			const inicolumn& stamp = columns["Stamp"];
+
+			measure("  iterate value<T>()", options.iterations, table.rows().size(), [&]()
+			{
+				unsigned long long sum = 0;
+				for (const irow& row : table.rows())
+				{
+					sum += (unsigned long long)row.value<int>(value);
+					sum += (unsigned long long)row.value<double>(ratio);
+					sum += row.value<std::string>(name).length();
+					sum += (unsigned long long)row.value<long long>(stamp);
+				}
+				sink = sink + sum;
+			});
+		}
+	}
+
+	void run_reader(const options& options)
+	{
+		size_t rows = options.rows * options.tables;
+		std::cout << "[reader] tables: " << options.tables << ", rows per table: " << options.rows << " (time per row, open: per file)" << std::endl;
+
+		run_read(options, "  read", ReadFlag_none, rows);
+		run_read(options, "  read (parallel)", ReadFlag_parallel_loading, rows);
+		run_read_stream(options, "  read (istream)", ReadFlag_none, rows);
+		run_read_stream(options, "  read (istream, parallel)", ReadFlag_parallel_loading, rows);
+		run_read(options, "  read (memory mapped)", ReadFlag_memory_mapped, rows);
+		run_read(options, "  open (lazy)", ReadFlag_lazy_loading, 1);
+		run_read_table(options);
+
+		CremaReader::CremaReader& reader = CremaReader::CremaReader::read(options.path);
+		run_find(options, reader);
+		run_iterate(options, reader);
+		reader.destroy();
+	}
+} /*namespace CremaBenchmark*/
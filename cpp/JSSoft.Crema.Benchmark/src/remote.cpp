@@ -0,0 +1,371 @@
+﻿#include "benchmark.h"
+#include "standin_server.h"
+#include "synthetic_data.h"
+#ifndef _IGNORE_BOOST
+#include "include/crema/inireader.h"
+#include "src/socketbuf.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifndef _MSC_VER
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+namespace CremaBenchmark
+{
+	namespace
+	{
+		using CremaReader::DataLocation_both;
+		using CremaReader::irow;
+		using CremaReader::itable;
+
+		const char* database = "synthetic";
+
+		void check(bool condition, const std::string& message)
+		{
+			if (condition == false)
+				throw std::runtime_error("[remote] " + message);
+		}
+
+		// 모든 행의 키 해시와 Value 열을 더한 값으로 테이블 내용을 비교합니다.
+		unsigned long long checksum(const itable& table)
+		{
+			unsigned long long sum = 0;
+			for (const irow& row : table.rows())
+			{
+				sum = sum * 31 + row.hash() + (unsigned long long)row.value<int>("Value");
+			}
+			return sum;
+		}
+
+		void verify(CremaReader::CremaReader& expected, CremaReader::CremaReader& actual, const std::string& name)
+		{
+			check(actual.revision() == expected.revision() && actual.tables_hash_value() == expected.tables_hash_value(), name + ": revision");
+			check(actual.tables().size() == expected.tables().size(), name + ": table count");
+			for (size_t i = 0; i < expected.tables().size(); i++)
+			{
+				const itable& table = expected.tables()[i];
+				const itable& other = actual.tables()[table.name()];
+				check(other.hash_value() == table.hash_value() && checksum(other) == checksum(table), name + ": table " + table.name());
+			}
+		}
+
+		CremaReader::CremaReader& read(const standin_server& server, CremaReader::ReadFlag flag = CremaReader::ReadFlag_none)
+		{
+			return CremaReader::CremaReader::read("127.0.0.1", server.port(), database, DataLocation_both, flag);
+		}
+
+		// 처음부터 읽으면 블럭마다 한번씩만 받고, 지연 읽기로 테이블 하나만 읽으면 미리 받기 없이 필요한 블럭만 받는지 봅니다.
+		void run_block_requests(const options& options, standin_server& server, CremaReader::CremaReader& expected)
+		{
+			std::ifstream file(options.path.c_str(), std::ios::binary | std::ios::ate);
+			size_t size = (size_t)file.tellg();
+			size_t blocks = (size + CremaReader::internal::socketbuf::buffer_size - 1) / CremaReader::internal::socketbuf::buffer_size;
+
+			server.reset_counters();
+			CremaReader::CremaReader& reader = read(server);
+			unsigned long long requests = server.block_requests();
+			reader.destroy();
+			check(requests <= blocks, "read: blocks requested more than once");
+
+			server.reset_counters();
+			CremaReader::CremaReader& lazyReader = read(server, CremaReader::ReadFlag_lazy_loading);
+			const itable& table = expected.tables()[expected.tables().size() - 1];
+			check(checksum(lazyReader.tables()[table.name()]) == checksum(table), "read (lazy): table " + table.name());
+			unsigned long long lazyRequests = server.block_requests();
+			lazyReader.destroy();
+
+			std::cout << "  blocks requested: " << requests << " of " << blocks << " (read), " << lazyRequests << " (lazy, last table only)" << std::endl;
+		}
+
+#ifndef _MSC_VER
+		std::vector<std::string> list_blocks(const std::string& directory)
+		{
+			std::vector<std::string> files;
+			DIR* dir = ::opendir(directory.c_str());
+			if (dir == nullptr)
+				return files;
+			while (dirent* entry = ::readdir(dir))
+			{
+				std::string name = entry->d_name;
+				if (name != "." && name != "..")
+					files.push_back(directory + "/" + name);
+			}
+			::closedir(dir);
+			return files;
+		}
+
+		CremaReader::CremaReader& read_cached(const standin_server& server, bool async)
+		{
+			if (async == false)
+				return read(server);
+
+			boost::asio::io_service io_service;
+			std::future<CremaReader::CremaReader*> future = CremaReader::CremaReader::read_async(io_service, "127.0.0.1", server.port(), database, DataLocation_both);
+			io_service.run();
+			return *future.get();
+		}
+
+		// 블럭 하나의 가운데 바이트를 바꿉니다. 크기는 그대로라 해시로만 알아낼 수 있습니다.
+		void corrupt(const std::string& filename)
+		{
+			std::fstream stream(filename.c_str(), std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+			std::streamoff middle = (std::streamoff)stream.tellg() / 2;
+			char value = 0;
+			stream.seekg(middle);
+			stream.get(value);
+			stream.seekp(middle);
+			stream.put((char)(value ^ 0x5a));
+		}
+
+		// 캐시가 차 있으면 헤더 말고는 서버에 묻지 않고, 내용이 깨진 블럭 파일은 버리고 다시 받는지 봅니다.
+		// read 와 read_async 가 같은 캐시 파일을 같이 쓰는지도 봅니다.
+		void run_block_cache(const options& options, standin_server& server, CremaReader::CremaReader& expected)
+		{
+			struct pass
+			{
+				const char* name;
+				bool async;
+				bool corrupt;
+				bool clear;
+			};
+			const pass passes[] =
+			{
+				{ "read, empty cache", false, false, false },
+				{ "read, warm cache", false, false, false },
+				{ "read, one corrupted block", false, true, false },
+				{ "read_async, warm cache", true, false, false },
+				{ "read_async, one corrupted block", true, true, false },
+				{ "read_async, empty cache", true, false, true },
+				{ "read, cache written by read_async", false, false, false },
+			};
+
+			std::string pattern = options.path + ".cache.XXXXXX";
+			std::vector<char> path(pattern.begin(), pattern.end());
+			path.push_back('\0');
+			check(::mkdtemp(&path.front()) != nullptr, "cache: mkdtemp");
+			std::string directory = &path.front();
+
+			CremaReader::CremaReader::set_cache_directory(directory);
+			try
+			{
+				for (const pass& item : passes)
+				{
+					std::vector<std::string> files = list_blocks(directory);
+					if (item.corrupt == true)
+						corrupt(files.front());
+					for (size_t i = 0; item.clear == true && i < files.size(); i++)
+						std::remove(files[i].c_str());
+
+					server.reset_counters();
+					CremaReader::CremaReader& reader = read_cached(server, item.async);
+					unsigned long long requests = server.block_requests();
+					try
+					{
+						verify(expected, reader, std::string("cache: ") + item.name);
+					}
+					catch (...)
+					{
+						reader.destroy();
+						throw;
+					}
+					reader.destroy();
+
+					// 캐시 키를 정하려고 헤더를 한번 받습니다.
+					size_t blocks = list_blocks(directory).size();
+					unsigned long long expectedRequests = 1;
+					if (item.corrupt == true)
+						expectedRequests = 2;
+					else if (files.empty() == true || item.clear == true)
+						expectedRequests = blocks + 1;
+					check(requests == expectedRequests, std::string("cache: ") + item.name + ": blocks requested");
+					std::cout << "  blocks requested: " << requests << " (" << item.name << ")" << std::endl;
+				}
+			}
+			catch (...)
+			{
+				CremaReader::CremaReader::set_cache_directory("");
+				for (const std::string& file : list_blocks(directory))
+					std::remove(file.c_str());
+				::rmdir(directory.c_str());
+				throw;
+			}
+			CremaReader::CremaReader::set_cache_directory("");
+			for (const std::string& file : list_blocks(directory))
+				std::remove(file.c_str());
+			::rmdir(directory.c_str());
+		}
+#endif
+
+		// 짝수 번째 테이블만 바뀐 리비전을 올리고 update 가 바뀐 테이블만 받는지, 지연 읽기에서 읽지 않은 테이블도 새 리비전이 되는지 봅니다.
+		// 교체된 테이블 참조는 reclaim 전까지 이전 내용 그대로여야 하고, 테이블 구성이 바뀌면 아무것도 바꾸지 않고 실패해야 합니다.
+		void run_update(const options& options, standin_server& server)
+		{
+			const std::string paths[] = { options.path + ".update1", options.path + ".update2", options.path + ".update3" };
+			synthetic::spec spec;
+			spec.rows = options.rows;
+			for (size_t i = 0; i < 3; i++)
+			{
+				spec.revision = i + 1;
+				spec.tables = i == 2 ? options.tables - 1 : options.tables;
+				synthetic::write(paths[i], spec);
+			}
+
+			CremaReader::CremaReader* expected = nullptr;
+			CremaReader::CremaReader* reader = nullptr;
+			try
+			{
+				expected = &CremaReader::CremaReader::read(paths[1]);
+				const CremaReader::ReadFlag flags[] = { CremaReader::ReadFlag_none, CremaReader::ReadFlag_lazy_loading };
+				for (CremaReader::ReadFlag flag : flags)
+				{
+					std::string name = flag == CremaReader::ReadFlag_none ? "update" : "update (lazy)";
+					server.publish(paths[0]);
+					reader = &read(server, flag);
+					const itable& table = reader->tables()[synthetic::table_name(0)];
+					unsigned long long previous = checksum(table);
+
+					// update 하는 동안 다른 스레드가 리비전을 읽어도 되는지 봅니다.
+					server.publish(paths[1]);
+					std::atomic<bool> stop(false);
+					std::atomic<size_t> sink(0);
+					std::thread watcher([reader, &stop, &sink]()
+					{
+						while (stop == false)
+						{
+							sink += reader->revision().size() + reader->tables_hash_value().size();
+						}
+					});
+					size_t changed = (options.tables + 1) / 2;
+					size_t updated = 0;
+					try
+					{
+						updated = reader->update("127.0.0.1", server.port(), database, DataLocation_both);
+					}
+					catch (...)
+					{
+						stop = true;
+						watcher.join();
+						throw;
+					}
+					stop = true;
+					watcher.join();
+					check(updated == changed, name + ": tables updated");
+					check(checksum(table) == previous, name + ": replaced table kept until reclaim");
+					check(reader->revision() == "2", name + ": revision");
+					verify(*expected, *reader, name);
+
+					server.publish(paths[2]);
+					bool failed = false;
+					try
+					{
+						reader->update("127.0.0.1", server.port(), database, DataLocation_both);
+					}
+					catch (std::exception&)
+					{
+						failed = true;
+					}
+					check(failed == true, name + ": table set changed");
+					verify(*expected, *reader, name + ", table set changed");
+
+					check(reader->reclaim() == (flag == CremaReader::ReadFlag_none ? changed : 1), name + ": reclaim");
+					reader->destroy();
+					reader = nullptr;
+					std::cout << "  " << name << ": " << updated << " of " << options.tables << " tables replaced" << std::endl;
+				}
+			}
+			catch (...)
+			{
+				if (reader != nullptr)
+					reader->destroy();
+				if (expected != nullptr)
+					expected->destroy();
+				for (const std::string& path : paths)
+					std::remove(path.c_str());
+				server.publish(options.path);
+				throw;
+			}
+			expected->destroy();
+			for (const std::string& path : paths)
+				std::remove(path.c_str());
+			server.publish(options.path);
+		}
+
+		void run_read(const options& options, standin_server& server, CremaReader::CremaReader& expected)
+		{
+			measure("  read", options.iterations, options.rows * options.tables, [&]()
+			{
+				CremaReader::CremaReader& reader = read(server);
+				verify(expected, reader, "read");
+				reader.destroy();
+			});
+		}
+
+		// handler 가 io_service 를 돌리는 스레드에서 불리는지와 받은 데이터를 확인합니다.
+		void run_read_async(const options& options, standin_server& server, CremaReader::CremaReader& expected)
+		{
+			measure("  read_async", options.iterations, options.rows * options.tables, [&]()
+			{
+				boost::asio::io_service io_service;
+				CremaReader::CremaReader* reader = nullptr;
+				std::exception_ptr error;
+				std::thread::id handlerThread;
+				CremaReader::CremaReader::read_async(io_service, "127.0.0.1", server.port(), database, DataLocation_both, CremaReader::ReadFlag_none,
+					[&](CremaReader::CremaReader* result, std::exception_ptr exception)
+				{
+					reader = result;
+					error = exception;
+					handlerThread = std::this_thread::get_id();
+				});
+				io_service.run();
+
+				if (error != nullptr)
+					std::rethrow_exception(error);
+				check(reader != nullptr && handlerThread == std::this_thread::get_id(), "read_async: handler");
+				verify(expected, *reader, "read_async");
+				reader->destroy();
+			});
+
+			boost::asio::io_service io_service;
+			std::thread thread;
+			std::future<CremaReader::CremaReader*> future = CremaReader::CremaReader::read_async(io_service, "127.0.0.1", server.port(), database, DataLocation_both);
+			thread = std::thread([&io_service]() { io_service.run(); });
+			CremaReader::CremaReader* reader = future.get();
+			thread.join();
+			verify(expected, *reader, "read_async (future)");
+			reader->destroy();
+		}
+	}
+
+	void run_remote(const options& options)
+	{
+		std::cout << "[remote] tables: " << options.tables << ", rows per table: " << options.rows << " (time per row, stand-in server on 127.0.0.1)" << std::endl;
+
+		standin_server server;
+		server.publish(options.path);
+		CremaReader::CremaReader& expected = CremaReader::CremaReader::read(options.path);
+		try
+		{
+			run_read(options, server, expected);
+			run_read_async(options, server, expected);
+			run_block_requests(options, server, expected);
+#ifndef _MSC_VER
+			run_block_cache(options, server, expected);
+#endif
+			run_update(options, server);
+		}
+		catch (...)
+		{
+			expected.destroy();
+			throw;
+		}
+		expected.destroy();
+	}
+} /*namespace CremaBenchmark*/
+
+#endif
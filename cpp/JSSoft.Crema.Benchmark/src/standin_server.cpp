@@ -0,0 +1,286 @@
+﻿#include "standin_server.h"
+#ifndef _IGNORE_BOOST
+#include "include/crema/inireader.h"
+#include "src/binary_type.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace CremaBenchmark
+{
+	using boost::asio::ip::tcp;
+
+	namespace
+	{
+		// C# 리더의 HeaderType 과 같은 값입니다.
+		enum header_type
+		{
+			header_type_identify,
+			header_type_size,
+			header_type_buffer,
+			header_type_compare,
+		};
+	}
+
+	standin_server::standin_server()
+		: m_acceptor(m_io_service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), m_stopping(false), m_blockRequests(0), m_bytesSent(0)
+	{
+		m_thread = std::thread(&standin_server::accept, this);
+	}
+
+	standin_server::~standin_server()
+	{
+		m_stopping = true;
+		{
+			// accept 를 깨우기 위해 스스로 연결합니다.
+			boost::system::error_code error;
+			tcp::socket socket(m_io_service);
+			socket.connect(m_acceptor.local_endpoint(), error);
+		}
+		m_thread.join();
+
+		std::vector<std::thread> connections;
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			for (size_t i = 0; i < m_sockets.size(); i++)
+			{
+				boost::system::error_code error;
+				m_sockets[i]->shutdown(tcp::socket::shutdown_both, error);
+			}
+			connections.swap(m_connections);
+		}
+		for (size_t i = 0; i < connections.size(); i++)
+		{
+			connections[i].join();
+		}
+	}
+
+	void standin_server::publish(const std::string& filename)
+	{
+		std::shared_ptr<image> item(new image());
+		std::ifstream stream(filename.c_str(), std::ios::binary | std::ios::ate);
+		if (stream.is_open() == false)
+			throw std::invalid_argument("파일이 열리지 않았습니다.");
+		item->data.assign((size_t)stream.tellg(), 0);
+		stream.seekg(0);
+		stream.read(&item->data.front(), item->data.size());
+
+		using namespace CremaReader::internal::binary;
+		file_header header;
+		memcpy(&header, &item->data.front(), sizeof(file_header));
+		std::vector<table_index> indexes(header.tableCount);
+		if (indexes.empty() == false)
+			memcpy(&indexes.front(), &item->data.front() + header.indexOffset, sizeof(table_index) * indexes.size());
+
+		// 테이블 블럭은 다음 테이블이나 문자열 영역, 색인이 시작하는 곳에서 끝납니다.
+		std::vector<size_t> starts;
+		for (size_t i = 0; i < indexes.size(); i++)
+		{
+			starts.push_back((size_t)indexes[i].offset);
+		}
+		starts.push_back((size_t)header.stringResourcesOffset);
+		starts.push_back((size_t)header.indexOffset);
+		starts.push_back(item->data.size());
+		std::sort(starts.begin(), starts.end());
+
+		CremaReader::CremaReader& reader = CremaReader::CremaReader::read(filename);
+		try
+		{
+			item->revision = reader.revision();
+			item->tablesHashValue = reader.tables_hash_value();
+			for (size_t i = 0; i < indexes.size(); i++)
+			{
+				table_block& block = item->tables[reader.tables().names()[i]];
+				block.hash = reader.tables()[i].hash_value();
+				block.offset = (size_t)indexes[i].offset;
+				block.size = *std::upper_bound(starts.begin(), starts.end(), block.offset) - block.offset;
+			}
+		}
+		catch (...)
+		{
+			reader.destroy();
+			throw;
+		}
+		reader.destroy();
+
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_image = item;
+	}
+
+	int standin_server::port() const
+	{
+		return (int)m_acceptor.local_endpoint().port() - 1;
+	}
+
+	void standin_server::reset_counters()
+	{
+		m_blockRequests = 0;
+		m_bytesSent = 0;
+	}
+
+	std::shared_ptr<const standin_server::image> standin_server::current() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		if (m_image == nullptr)
+			throw std::logic_error("publish 한 데이터가 없습니다.");
+		return m_image;
+	}
+
+	void standin_server::accept()
+	{
+		for (;;)
+		{
+			std::shared_ptr<socket_type> socket(new socket_type(m_io_service));
+			boost::system::error_code error;
+			m_acceptor.accept(*socket, error);
+			if (m_stopping == true)
+				return;
+			if (error)
+				continue;
+
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_sockets.push_back(socket);
+			m_connections.push_back(std::thread(&standin_server::serve, this, socket));
+		}
+	}
+
+	void standin_server::serve(std::shared_ptr<socket_type> socket)
+	{
+		std::shared_ptr<const image> item;
+		try
+		{
+			for (;;)
+			{
+				int header = read_int(*socket);
+				if (header == header_type_size)
+				{
+					read_string(*socket);
+					item = this->current();
+					long long length = (long long)item->data.size();
+					boost::asio::write(*socket, boost::asio::buffer(&length, sizeof(length)));
+				}
+				else if (header == header_type_buffer)
+				{
+					// BufferInfo: long pos, int size, int dummy
+					long long pos = read_long(*socket);
+					int size = read_int(*socket);
+					read_int(*socket);
+					if (item == nullptr || pos < 0 || size < 0 || (size_t)pos + (size_t)size > item->data.size())
+						return;
+					boost::asio::write(*socket, boost::asio::buffer(&item->data.front() + pos, (size_t)size));
+					m_blockRequests++;
+					m_bytesSent += (unsigned long long)size;
+				}
+				else if (header == header_type_compare)
+				{
+					this->compare(*socket);
+				}
+				else
+				{
+					return;
+				}
+			}
+		}
+		catch (boost::system::system_error&)
+		{
+			// 리더가 연결을 닫았습니다.
+		}
+	}
+
+	// 요청: name, tablesHashValue, count, (tableName, hash) * count
+	// 응답: count(테이블 구성이 다르면 -1), revision, tablesHashValue, (tableName, long size, data) * count
+	void standin_server::compare(socket_type& socket)
+	{
+		read_string(socket);
+		read_string(socket);
+		int count = read_int(socket);
+		std::shared_ptr<const image> item = this->current();
+
+		std::vector<const table_block*> changed;
+		std::vector<std::string> names;
+		bool known = true;
+		for (int i = 0; i < count; i++)
+		{
+			std::string name = read_string(socket);
+			std::string hash = read_string(socket);
+			std::map<std::string, table_block>::const_iterator itor = item->tables.find(name);
+			if (itor == item->tables.end())
+			{
+				known = false;
+				continue;
+			}
+			if (itor->second.hash == hash)
+				continue;
+			changed.push_back(&itor->second);
+			names.push_back(name);
+		}
+
+		std::vector<char> packet;
+		if (known == false)
+		{
+			append_value(packet, (int)-1);
+			boost::asio::write(socket, boost::asio::buffer(packet));
+			return;
+		}
+
+		append_value(packet, (int)changed.size());
+		append_string(packet, item->revision);
+		append_string(packet, item->tablesHashValue);
+		for (size_t i = 0; i < changed.size(); i++)
+		{
+			append_string(packet, names[i]);
+			append_value(packet, (long long)changed[i]->size);
+			packet.insert(packet.end(), item->data.begin() + changed[i]->offset, item->data.begin() + changed[i]->offset + changed[i]->size);
+		}
+		boost::asio::write(socket, boost::asio::buffer(packet));
+		m_bytesSent += (unsigned long long)packet.size();
+	}
+
+	int standin_server::read_int(socket_type& socket)
+	{
+		int value;
+		boost::asio::read(socket, boost::asio::buffer(&value, sizeof(value)));
+		return value;
+	}
+
+	long long standin_server::read_long(socket_type& socket)
+	{
+		long long value;
+		boost::asio::read(socket, boost::asio::buffer(&value, sizeof(value)));
+		return value;
+	}
+
+	// C# BinaryWriter.Write(string) 처럼 7 비트씩 나눈 길이 뒤에 UTF-8 바이트가 옵니다.
+	std::string standin_server::read_string(socket_type& socket)
+	{
+		size_t length = 0;
+		size_t shift = 0;
+		unsigned char byte;
+		do
+		{
+			boost::asio::read(socket, boost::asio::buffer(&byte, 1));
+			length |= (size_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while ((byte & 0x80) != 0);
+
+		std::string text(length, 0);
+		if (length != 0)
+			boost::asio::read(socket, boost::asio::buffer(&text[0], length));
+		return text;
+	}
+
+	void standin_server::append_string(std::vector<char>& packet, const std::string& text)
+	{
+		size_t length = text.length();
+		while (length >= 0x80)
+		{
+			packet.push_back((char)(unsigned char)(length | 0x80));
+			length >>= 7;
+		}
+		packet.push_back((char)(unsigned char)length);
+		packet.insert(packet.end(), text.begin(), text.end());
+	}
+} /*namespace CremaBenchmark*/
+
+#endif
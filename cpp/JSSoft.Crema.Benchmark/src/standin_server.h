@@ -0,0 +1,82 @@
+﻿#pragma once
+#include "include/crema/inidefine.h"
+#ifndef _IGNORE_BOOST
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+namespace CremaBenchmark
+{
+	// 원격 읽기(CremaReader::read, read_async, update)가 쓰는 header_type 프로토콜을 흉내 내는 서버입니다.
+	// 패킷 모양은 C# 리더(tools/JSSoft.Crema.Reader)의 HeaderType, BufferInfo 와 socket_delta 의 compare 를 따릅니다.
+	// 데이터 파일 하나를 메모리에 올려 두고 127.0.0.1 의 빈 포트에서 연결마다 스레드 하나로 응답합니다.
+	// 연결은 처음 연결한 때의 이미지를 계속 쓰며 publish 로 바꾼 이미지는 다음 연결부터 보입니다.
+	class standin_server
+	{
+	public:
+		standin_server();
+		~standin_server();
+
+		void publish(const std::string& filename);
+		// 리더는 넘겨받은 포트 + 1 로 연결하므로 CremaReader 에 넘길 포트를 반환합니다.
+		int port() const;
+
+		unsigned long long block_requests() const { return m_blockRequests; }
+		unsigned long long bytes_sent() const { return m_bytesSent; }
+		void reset_counters();
+
+	private:
+		struct table_block
+		{
+			std::string hash;
+			size_t offset;
+			size_t size;
+		};
+
+		struct image
+		{
+			std::vector<char> data;
+			std::string revision;
+			std::string tablesHashValue;
+			std::map<std::string, table_block> tables;
+		};
+
+		typedef boost::asio::ip::tcp::socket socket_type;
+
+		void accept();
+		void serve(std::shared_ptr<socket_type> socket);
+		void compare(socket_type& socket);
+		std::shared_ptr<const image> current() const;
+
+		static int read_int(socket_type& socket);
+		static long long read_long(socket_type& socket);
+		static std::string read_string(socket_type& socket);
+		static void append_string(std::vector<char>& packet, const std::string& text);
+
+		template<typename T>
+		static void append_value(std::vector<char>& packet, T value)
+		{
+			const char* bytes = (const char*)&value;
+			packet.insert(packet.end(), bytes, bytes + sizeof(T));
+		}
+
+	private:
+		boost::asio::io_service m_io_service;
+		boost::asio::ip::tcp::acceptor m_acceptor;
+		std::thread m_thread;
+		std::atomic<bool> m_stopping;
+		mutable std::mutex m_lock;
+		std::shared_ptr<const image> m_image;
+		std::vector<std::thread> m_connections;
+		std::vector<std::shared_ptr<socket_type> > m_sockets;
+		std::atomic<unsigned long long> m_blockRequests;
+		std::atomic<unsigned long long> m_bytesSent;
+	};
+} /*namespace CremaBenchmark*/
+
+#endif
@@ -0,0 +1,173 @@
+﻿#include "synthetic_data.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace CremaBenchmark
+{
+	namespace synthetic
+	{
+		namespace
+		{
+			using CremaReader::iniwriter_column;
+			using CremaReader::iwriter_row;
+
+			bool is_string(const std::string& typeName)
+			{
+				return typeName == "string" || typeName == "guid";
+			}
+
+			bool is_real(const std::string& typeName)
+			{
+				return typeName == "float" || typeName == "double";
+			}
+
+			// 문자열 키는 K{row}, 첫 키는 row, 짝수 번째 키는 row * 7919, 홀수 번째 키는 row % 16 입니다.
+			void set_key(iwriter_row& values, size_t index, const iniwriter_column& column, size_t row)
+			{
+				if (is_string(column.type_name) == true)
+					values.set_value(index, k1(row));
+				else if (index == 0)
+					values.set_value(index, (long long)row);
+				else if (index % 2 == 0)
+					values.set_value(index, k2(row));
+				else
+					values.set_value(index, k3(row));
+			}
+
+			void set_value(iwriter_row& values, size_t index, const iniwriter_column& column, size_t row, const spec& spec, const std::vector<std::string>& strings, long long offset)
+			{
+				const std::string& typeName = column.type_name;
+				if (is_string(typeName) == true)
+					values.set_value(index, strings[row % strings.size()]);
+				else if (is_real(typeName) == true)
+				{
+					if (spec.null_interval == 0 || row % spec.null_interval != 0)
+						values.set_value(index, (double)row * 0.5);
+				}
+				else if (typeName == "boolean")
+					values.set_value(index, row % 2 == 1);
+				else if (typeName == "dateTime" || typeName == "duration")
+					values.set_value(index, (long long)(1500000000 + row));
+				else
+					values.set_value(index, (long long)(row * 3) + offset);
+			}
+		}
+
+		spec::spec()
+			: tables(8), rows(10000), string_cardinality(100), null_interval(10), compression(false), threads(0), revision(1)
+		{
+			keys.push_back(iniwriter_column("K0", "int"));
+			keys.push_back(iniwriter_column("K1", "string"));
+			keys.push_back(iniwriter_column("K2", "long"));
+			keys.push_back(iniwriter_column("K3", "int"));
+			values.push_back(iniwriter_column("Value", "int"));
+			values.push_back(iniwriter_column("Ratio", "double"));
+			values.push_back(iniwriter_column("Name", "string"));
+			values.push_back(iniwriter_column("Stamp", "dateTime"));
+		}
+
+		std::vector<iniwriter_column> parse_columns(const std::string& types, const std::string& prefix)
+		{
+			std::vector<iniwriter_column> columns;
+			std::istringstream stream(types);
+			std::string typeName;
+			while (std::getline(stream, typeName, ','))
+			{
+				std::ostringstream name;
+				name << prefix << columns.size();
+				columns.push_back(iniwriter_column(name.str(), typeName));
+			}
+			return columns;
+		}
+
+		std::string table_name(size_t tableIndex)
+		{
+			return table_name(spec(), tableIndex);
+		}
+
+		std::string table_name(const spec& spec, size_t tableIndex)
+		{
+			size_t keyCount = spec.keys.size();
+			std::ostringstream stream;
+			stream << "Key" << tableIndex % keyCount + 1;
+			if (tableIndex >= keyCount)
+				stream << "_" << tableIndex / keyCount;
+			return stream.str();
+		}
+
+		size_t key_count(size_t tableIndex)
+		{
+			return tableIndex % 4 + 1;
+		}
+
+		std::string k1(size_t row)
+		{
+			std::ostringstream stream;
+			stream << "K" << row;
+			return stream.str();
+		}
+
+		void write(const std::string& filename, const spec& spec)
+		{
+			if (spec.keys.empty() == true || spec.string_cardinality == 0)
+				throw std::invalid_argument("키 열과 문자열 종류가 하나 이상 필요합니다.");
+
+			std::vector<std::vector<std::string> > strings(spec.values.size());
+			for (size_t i = 0; i < spec.values.size(); i++)
+			{
+				if (is_string(spec.values[i].type_name) == false)
+					continue;
+				for (size_t j = 0; j < spec.string_cardinality; j++)
+				{
+					std::ostringstream stream;
+					stream << spec.values[i].name << j;
+					strings[i].push_back(stream.str());
+				}
+			}
+
+			CremaReader::CremaWriter& writer = CremaReader::CremaWriter::create("synthetic");
+			try
+			{
+				std::ostringstream revision;
+				revision << spec.revision;
+				writer.set_revision(revision.str());
+				writer.set_tags("All");
+				writer.set_compression(spec.compression);
+				writer.set_thread_count(spec.threads);
+
+				for (size_t i = 0; i < spec.tables; i++)
+				{
+					size_t keyCount = i % spec.keys.size() + 1;
+					std::vector<iniwriter_column> columns(spec.keys);
+					columns.insert(columns.end(), spec.values.begin(), spec.values.end());
+					for (size_t j = 0; j < columns.size(); j++)
+					{
+						columns[j].is_key = j < keyCount;
+					}
+
+					long long offset = i % 2 == 0 ? (long long)spec.revision - 1 : 0;
+					writer.add_table(table_name(spec, i), "/synthetic/", columns, spec.rows, [&spec, &strings, offset](size_t row, iwriter_row& values)
+					{
+						size_t index = 0;
+						for (size_t j = 0; j < spec.keys.size(); j++, index++)
+						{
+							set_key(values, index, spec.keys[j], row);
+						}
+						for (size_t j = 0; j < spec.values.size(); j++, index++)
+						{
+							set_value(values, index, spec.values[j], row, spec, strings[j], offset);
+						}
+					});
+				}
+
+				writer.write(filename);
+			}
+			catch (...)
+			{
+				writer.destroy();
+				throw;
+			}
+			writer.destroy();
+		}
+	} /*namespace synthetic*/
+} /*namespace CremaBenchmark*/
@@ -0,0 +1,49 @@
+﻿#pragma once
+#include "include/crema/iniwriter.h"
+#include <string>
+#include <vector>
+
+namespace CremaBenchmark
+{
+	// 벤치마크에 쓸 데이터를 CremaWriter 로 만듭니다.
+	// 테이블 i 는 (i % keys.size()) + 1 개의 키를 가지며, 기본 설정에서 이름은 Key1, Key2, Key3, Key4, Key1_1, Key2_1 ... 순서입니다.
+	// 열은 keys 뒤에 values 가 붙고 앞에서부터 키 갯수만큼의 열이 키입니다.
+	// 기본 설정의 열은 K0(int) K1(string) K2(long) K3(int) Value(int) Ratio(double) Name(string) Stamp(dateTime) 입니다.
+	namespace synthetic
+	{
+		struct spec
+		{
+			spec();
+
+			size_t tables;
+			size_t rows;
+			// 키가 될 수 있는 열입니다. 첫 열만으로 행이 구분되므로 행 갯수를 담을 수 있는 타입이어야 합니다.
+			std::vector<CremaReader::iniwriter_column> keys;
+			std::vector<CremaReader::iniwriter_column> values;
+			// 값 열의 문자열 종류 수입니다. 키 열의 문자열은 행마다 다릅니다.
+			size_t string_cardinality;
+			// float, double 값 열은 이 간격의 행마다 비어 있습니다. 0 이면 비우지 않습니다.
+			size_t null_interval;
+			bool compression;
+			// 0 이면 하드웨어 스레드 수를 씁니다.
+			size_t threads;
+			// 리비전 문자열입니다. 1 보다 크면 짝수 번째 테이블의 정수 값 열에 revision - 1 을 더해서 그 테이블들만 내용이 바뀝니다.
+			size_t revision;
+		};
+
+		// "int,string,long" 처럼 쉼표로 나눈 타입 목록으로 prefix0, prefix1 ... 열을 만듭니다.
+		std::vector<CremaReader::iniwriter_column> parse_columns(const std::string& types, const std::string& prefix);
+
+		void write(const std::string& filename, const spec& spec);
+
+		std::string table_name(size_t tableIndex);
+		std::string table_name(const spec& spec, size_t tableIndex);
+		size_t key_count(size_t tableIndex);
+
+		// 기본 설정에서 row 번째 행의 키 값입니다.
+		inline int k0(size_t row) { return (int)row; }
+		std::string k1(size_t row);
+		inline long long k2(size_t row) { return (long long)row * 7919; }
+		inline int k3(size_t row) { return (int)(row % 16); }
+	} /*namespace synthetic*/
+} /*namespace CremaBenchmark*/
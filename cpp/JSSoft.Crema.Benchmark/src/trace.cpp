@@ -0,0 +1,89 @@
+﻿#include "benchmark.h"
+#include "include/crema/inireader.h"
+#include <vector>
+
+namespace CremaBenchmark
+{
+	namespace
+	{
+		using CremaReader::initable_stats;
+		using CremaReader::ReadFlag;
+		using CremaReader::ReadFlag_none;
+		using CremaReader::ReadFlag_parallel_loading;
+
+		class benchmark_trace : public CremaReader::iniload_trace
+		{
+		public:
+			virtual long long allocation_count() { return (long long)thread_allocations; }
+		};
+
+		void run_read(const options& options, const std::string& name, ReadFlag flag, CremaReader::iload_listener* listener)
+		{
+			CremaReader::CremaReader::set_load_listener(listener);
+			measure(name, options.iterations, options.rows * options.tables, [&]()
+			{
+				CremaReader::CremaReader& reader = CremaReader::CremaReader::read(options.path, flag);
+				sink = sink + reader.tables().size();
+				reader.destroy();
+			});
+			CremaReader::CremaReader::set_load_listener(nullptr);
+		}
+
+		double to_microseconds(long long nanoseconds)
+		{
+			return (double)nanoseconds / 1000.0;
+		}
+	}
+
+	void run_trace(const options& options)
+	{
+		std::cout << "[trace] tables: " << options.tables << ", rows per table: " << options.rows << " (time per row)" << std::endl;
+
+		benchmark_trace trace;
+		run_read(options, "  read", ReadFlag_none, nullptr);
+		run_read(options, "  read (traced)", ReadFlag_none, &trace);
+		run_read(options, "  read (parallel, traced)", ReadFlag_parallel_loading, &trace);
+
+		trace.clear();
+		CremaReader::CremaReader::set_load_listener(&trace);
+		CremaReader::CremaReader& reader = CremaReader::CremaReader::read(options.path, ReadFlag_parallel_loading);
+		CremaReader::CremaReader::set_load_listener(nullptr);
+		reader.destroy();
+
+		CremaReader::iniload_stats stats = trace.stats();
+		const CremaReader::inidataset_stats& dataset = stats.datasets.front();
+		std::cout << std::fixed << std::setprecision(1) << "  dataset " << to_microseconds(dataset.wall_time) << " us: header " << to_microseconds(dataset.header_time)
+			<< " us, string resources " << to_microseconds(dataset.string_resources_time) << " us, tables " << to_microseconds(dataset.tables_time)
+			<< " us, " << stats.total_bytes_read() << " bytes read" << std::endl;
+
+		std::cout << "  " << std::left << std::setw(12) << "slowest" << std::right;
+		const char* headers[] = { "wall", "read", "decomp", "strings", "columns", "rows", "index", "bytes", "allocs" };
+		for (size_t i = 0; i < sizeof(headers) / sizeof(headers[0]); i++)
+		{
+			std::cout << std::setw(11) << headers[i];
+		}
+		std::cout << "  (us)" << std::endl;
+
+		std::vector<const initable_stats*> slowest = stats.slowest(5);
+		for (size_t i = 0; i < slowest.size(); i++)
+		{
+			const initable_stats& item = *slowest[i];
+			std::cout << "  " << std::left << std::setw(12) << item.name << std::right
+				<< std::setw(11) << to_microseconds(item.wall_time)
+				<< std::setw(11) << to_microseconds(item.read_time)
+				<< std::setw(11) << to_microseconds(item.decompress_time)
+				<< std::setw(11) << to_microseconds(item.strings_time)
+				<< std::setw(11) << to_microseconds(item.columns_time)
+				<< std::setw(11) << to_microseconds(item.rows_time)
+				<< std::setw(11) << to_microseconds(item.index_time)
+				<< std::setw(11) << item.bytes_read
+				<< std::setw(11) << item.allocations << std::endl;
+		}
+
+		if (options.trace.empty() == false)
+		{
+			trace.write_chrome_trace(options.trace);
+			std::cout << "  chrome trace: " << options.trace << std::endl;
+		}
+	}
+} /*namespace CremaBenchmark*/
@@ -20,21 +20,24 @@
 // Namespaces and files starting with "Ntreev" have been renamed to "JSSoft".
 
 #include "crema_reader.h"
-#include <stdarg.h>
 #include <locale>
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CREMA_HASH_SSE2
+#endif
 
 namespace CremaCode {
 	namespace reader {
 		namespace internal {
 			std::string string_resource::invalid_type("잘못된 타입입니다.");
-			std::string empty_string = "";
-			std::map<int, std::string> string_resource::m_strings;
-			std::map<const char*, std::string> string_resource::m_stringsByPtr;
 			std::string string_resource::empty_string;
-			int string_resource::m_ref = 0;
 			internal_util static_data;
 
 			internal_util::internal_util()
@@ -45,7 +48,10 @@ namespace CremaCode {
 			internal_util::~internal_util()
 			{
 				std::list<CremaReader*> readers;
-				readers.assign(m_readers.begin(), m_readers.end());
+				{
+					std::lock_guard<std::mutex> lock(m_lock);
+					readers.assign(m_readers.begin(), m_readers.end());
+				}
 
 				for (std::list<CremaReader*>::iterator itor = readers.begin(); itor != readers.end(); itor++)
 				{
@@ -53,78 +59,98 @@ namespace CremaCode {
 				}
 			}
 
-			void string_resource::read(std::istream& stream)
+			void string_pool::read(std::istream& stream)
 			{
 				int stringCount;
 				stream.read((char*)&stringCount, sizeof(int));
+				m_entries.reserve(stringCount);
+				m_values.reserve(stringCount);
+
+				std::vector<char> buffer;
 				for (int i = 0; i < stringCount; i++)
 				{
 					int length, id;
 					stream.read((char*)&id, sizeof(int));
 					stream.read((char*)&length, sizeof(int));
 
-					if (m_strings.find(id) == m_strings.end())
-					{
-						std::string text;
-						if (length != 0)
-						{
-							std::vector<char> buffer(length + 1, 0);
-							stream.read(&buffer.front(), length);
-							text = iniutil::utf8_to_string(&buffer.front());
-						}
-
-						m_strings[id] = text;
-					}
-					else
-					{
-#ifdef _DEBUG
-						std::streamoff off = stream.tellg();
-#endif
-						stream.seekg(length, std::ios::cur);
-					}
+					buffer.resize(length + 1);
+					if (length != 0)
+						stream.read(&buffer.front(), length);
+					this->add(id, &buffer.front(), length);
 				}
+				this->build_index();
 			}
 
-			const std::string& string_resource::get(int id)
+			const std::string& string_pool::get(int id) const
 			{
 				if (id == 0)
-					return empty_string;
-				std::map<int, std::string>::const_iterator itor = m_strings.find(id);
-				return itor->second;
-			}
+					return string_resource::empty_string;
 
-			const std::string& string_resource::getByPtr(const char* ptr)
-			{
-				std::map<const char*, std::string>::const_iterator itor = m_stringsByPtr.find(ptr);
-				return itor->second;
+				entry key = { id, 0 };
+				std::vector<entry>::const_iterator itor = std::lower_bound(m_entries.begin(), m_entries.end(), key);
+				if (itor == m_entries.end() || itor->id != id)
+					return string_resource::empty_string;
+				return m_values[itor->index];
 			}
 
-			void string_resource::add(const char* ptr, std::string text)
+			size_t string_pool::size() const
 			{
-				m_stringsByPtr.insert(std::pair<const char*, std::string>(ptr, text));
+				return m_values.size();
 			}
 
-			bool string_resource::contains(const char* ptr)
+			void string_pool::add(int id, const char* text, size_t length)
 			{
-				std::map<const char*, std::string>::const_iterator itor = m_stringsByPtr.find(ptr);
-				return itor != m_stringsByPtr.end();
-			}
+				entry item = { id, (unsigned int)m_values.size() };
+				m_entries.push_back(item);
 
-			void string_resource::add_ref()
-			{
-				m_ref++;
+				if (length == 0)
+				{
+					m_values.push_back(std::string());
+				}
+				else
+				{
+					std::string buffer(text, length);
+					m_values.push_back(iniutil::utf8_to_string(buffer.c_str()));
+				}
 			}
 
-			void string_resource::remove_ref()
+			void string_pool::build_index()
 			{
-				m_ref--;
-
-				if (m_ref == 0)
-					m_strings.clear();
+				std::stable_sort(m_entries.begin(), m_entries.end());
+				std::vector<entry>::iterator last = std::unique(m_entries.begin(), m_entries.end(), [](const entry& x, const entry& y) { return x.id == y.id; });
+				m_entries.erase(last, m_entries.end());
 			}
 
 			namespace binary
 			{
+				namespace
+				{
+					// 메모리에 읽어 둔 테이블 블럭을 std::istream 으로 읽기 위한 버퍼입니다. 블럭의 처음이 위치 0 입니다.
+					class block_streambuf : public std::streambuf
+					{
+					public:
+						block_streambuf(char* data, size_t size)
+						{
+							this->setg(data, data, data + size);
+						}
+
+					protected:
+						virtual pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode /*which*/)
+						{
+							char* base = dir == std::ios_base::beg ? this->eback() : dir == std::ios_base::cur ? this->gptr() : this->egptr();
+							if (offset < this->eback() - base || offset > this->egptr() - base)
+								return pos_type(off_type(-1));
+							this->setg(this->eback(), base + offset, this->egptr());
+							return pos_type(off_type(this->gptr() - this->eback()));
+						}
+
+						virtual pos_type seekpos(pos_type position, std::ios_base::openmode which)
+						{
+							return this->seekoff(off_type(position), std::ios_base::beg, which);
+						}
+					};
+				}
+
 				binary_reader::binary_reader()
 					: m_tables(*this)
 					, m_stream(nullptr)
@@ -145,6 +171,10 @@ namespace CremaCode {
 
 				void binary_reader::read_core(std::istream& stream, ReadFlag flag)
 				{
+					iload_listener* listener = CremaReader::load_listener();
+					inidataset_stats stats;
+					stats.start = listener != nullptr ? binary_reader::now() : 0;
+
 					file_header fileHeader;
 					m_stream = &stream;
 					m_flag = flag;
@@ -155,60 +185,102 @@ namespace CremaCode {
 					if (fileHeader.tableCount == 0)
 						return;
 					stream.read((char*)&m_tableIndexes.front(), sizeof(table_index) * (std::streamsize)fileHeader.tableCount);
+					if (listener != nullptr)
+						stats.header_time = binary_reader::now() - stats.start;
+
 					stream.seekg(fileHeader.stringResourcesOffset);
-					string_resource::read(stream);
-					m_name = string_resource::get(fileHeader.name);
-					m_revision = string_resource::get(fileHeader.revision);
+					m_strings.read(stream);
+					stats.strings = m_strings.size();
+					if (listener != nullptr)
+					{
+						stats.string_resources_time = binary_reader::now() - stats.start - stats.header_time;
+						stats.bytes_read = sizeof(file_header) + sizeof(table_index) * m_tableIndexes.size() + (size_t)((long long)stream.tellg() - fileHeader.stringResourcesOffset);
+					}
+					m_name = m_strings.get(fileHeader.name);
+					m_revision = m_strings.get(fileHeader.revision);
 
-					this->m_tables.set_size(m_tableIndexes);
 					this->m_tables.set_flag(flag);
-					m_typesHashValue = string_resource::get(fileHeader.typesHashValue);
-					m_tablesHashValue = string_resource::get(fileHeader.tablesHashValue);
-					m_tags = string_resource::get(fileHeader.tags);
+					this->m_tables.set_size(m_tableIndexes, m_strings);
+					m_typesHashValue = m_strings.get(fileHeader.typesHashValue);
+					m_tablesHashValue = m_strings.get(fileHeader.tablesHashValue);
+					m_tags = m_strings.get(fileHeader.tags);
 
+					long long tablesStart = listener != nullptr ? binary_reader::now() : 0;
 					if ((flag & ReadFlag_lazy_loading) == false)
 					{
 						for (size_t i = 0; i < m_tableIndexes.size(); i++)
 						{
 							const table_index& tableIndex = m_tableIndexes[i];
 
-							binary_table* table = read_table(stream, tableIndex.offset, flag);
+							binary_table* table = read_table(stream, tableIndex.offset, flag, i);
 							this->m_tables.set(i, table);
 						}
 					}
+
+					if (listener != nullptr)
+					{
+						long long end = binary_reader::now();
+						stats.name = m_name;
+						stats.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+						stats.wall_time = end - stats.start;
+						stats.tables_time = (flag & ReadFlag_lazy_loading) == false ? end - tablesStart : 0;
+						stats.table_count = m_tableIndexes.size();
+						listener->dataset_loaded(stats);
+					}
 				}
 
-				binary_table* binary_reader::read_table(size_t index)
+				long long binary_reader::now()
 				{
-					const table_index& table_index = m_tableIndexes.at(index);
-					binary_table* table = binary_reader::read_table(*m_stream, table_index.offset, m_flag);
-					this->m_tables.set(index, table);
-					return table;
+					return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 				}
 
-				bool binary_reader::findif::operator() (const table_index& index)
+				// 테이블 블럭만 잠금 안에서 읽고 나머지는 잠금 밖에서 메모리에서 읽으므로 다른 테이블을 동시에 읽을 수 있습니다.
+				// 읽은 테이블을 게시하는 것은 binary_table_array 가 맡습니다.
+				binary_table* binary_reader::read_table(size_t index)
 				{
-					if ((m_flag & ReadFlag_case_sensitive) != 0)
-						return m_tableName == string_resource::get(index.tableName);
-					return m_tableName == iniutil::to_lower(string_resource::get(index.tableName));
+					const table_index& tableIndex = m_tableIndexes.at(index);
+					std::vector<char> buffer;
+					binary_reader::read_block(tableIndex.offset, buffer);
+
+					block_streambuf streambuf(&buffer.front(), buffer.size());
+					std::istream stream(&streambuf);
+					return binary_reader::read_table(stream, 0, m_flag, index);
 				}
 
-				binary_table* binary_reader::read_table(const std::string& tableName)
+				void binary_reader::read_block(std::streamoff offset, std::vector<char>& buffer)
 				{
-					std::vector<table_index>::const_iterator itor = std::find_if(m_tableIndexes.begin(), m_tableIndexes.end(), findif(m_flag, tableName));
-
-					if (itor == m_tableIndexes.end())
-						throw keynotfoundexception(tableName, "tables");
+					table_header tableHeader;
 
-					size_t index = itor - m_tableIndexes.begin();
+					std::lock_guard<std::mutex> lock(m_streamLock);
+					m_stream->clear();
+					m_stream->seekg(offset, std::ios::beg);
+					m_stream->read((char*)&tableHeader, sizeof(table_header));
+					if (m_stream->good() == false || tableHeader.userOffset < (long long)sizeof(table_header))
+						throw std::runtime_error("테이블을 읽을 수 없습니다.");
 
-					binary_table* table = binary_reader::read_table(*m_stream, itor->offset, m_flag);
-					this->m_tables.set(index, table);
-					return table;
+					buffer.assign((size_t)tableHeader.userOffset, 0);
+					memcpy(&buffer.front(), &tableHeader, sizeof(table_header));
+					m_stream->read(&buffer.front() + sizeof(table_header), (std::streamsize)(buffer.size() - sizeof(table_header)));
 				}
 
-				binary_table* binary_reader::read_table(std::istream& stream, std::streamoff offset, ReadFlag flag)
+				// 스트림에서 단계마다 필요한 만큼만 읽으므로 read_time 은 헤더를 읽는 시간이고 나머지 읽기는 각 단계에 들어갑니다.
+				// 지연 로딩은 read_block 으로 블럭을 먼저 읽어 두므로 블럭을 읽는 시간은 들어가지 않습니다.
+				binary_table* binary_reader::read_table(std::istream& stream, std::streamoff offset, ReadFlag flag, size_t index)
 				{
+					iload_listener* listener = CremaReader::load_listener();
+					initable_stats stats;
+					long long allocations = listener != nullptr ? listener->allocation_count() : -1;
+					long long last = listener != nullptr ? binary_reader::now() : 0;
+					stats.start = last;
+					auto lap = [&](long long initable_stats::* phase)
+					{
+						if (listener == nullptr)
+							return;
+						long long time = binary_reader::now();
+						stats.*phase = time - last;
+						last = time;
+					};
+
 					table_header tableHeader;
 					table_info tableInfo;
 
@@ -217,21 +289,44 @@ namespace CremaCode {
 
 					stream.seekg(tableHeader.tableInfoOffset + offset, std::ios::beg);
 					stream.read((char*)&tableInfo, sizeof(table_info));
+					lap(&initable_stats::read_time);
 
 					binary_table* table = new binary_table(this, tableInfo.columnCount, tableInfo.rowCount);
 
 					stream.seekg(tableHeader.stringResourcesOffset + offset, std::ios::beg);
-					string_resource::read(stream);
+					table->m_strings.read(stream);
+					stats.strings = table->m_strings.size();
+					lap(&initable_stats::strings_time);
 
 					stream.seekg(tableHeader.columnsOffset + offset);
 					binary_reader::read_columns(stream, *table, tableInfo.columnCount, flag);
+					lap(&initable_stats::columns_time);
 
 					stream.seekg(tableHeader.rowsOffset + offset, std::ios::beg);
-					binary_reader::read_rows(stream, *table, tableInfo.rowCount);
+					binary_reader::read_rows(stream, *table, tableInfo.rowCount, (size_t)(tableHeader.stringResourcesOffset - tableHeader.rowsOffset));
+					lap(&initable_stats::rows_time);
 
-					table->m_tableName = string_resource::get(tableInfo.tableName);
-					table->m_categoryName = string_resource::get(tableInfo.categoryName);
-					table->m_hashValue = string_resource::get(tableHeader.hashValue);
+					table->m_rows.generate_keys();
+					lap(&initable_stats::index_time);
+
+					table->m_tableName = table->m_strings.get(tableInfo.tableName);
+					table->m_categoryName = table->m_strings.get(tableInfo.categoryName);
+					table->m_hashValue = table->m_strings.get(tableHeader.hashValue);
+
+					if (listener != nullptr)
+					{
+						stats.name = table->m_tableName;
+						stats.index = index;
+						stats.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+						stats.wall_time = binary_reader::now() - stats.start;
+						stats.bytes_read = (size_t)tableHeader.userOffset;
+						stats.raw_bytes = (size_t)tableHeader.userOffset;
+						stats.rows = (size_t)tableInfo.rowCount;
+						stats.columns = (size_t)tableInfo.columnCount;
+						if (allocations >= 0)
+							stats.allocations = listener->allocation_count() - allocations;
+						listener->table_loaded(stats);
+					}
 					return table;
 				}
 
@@ -244,8 +339,8 @@ namespace CremaCode {
 						column_info columninfo;
 						stream.read((char*)&columninfo, sizeof(column_info));
 
-						const std::string& columnName = string_resource::get(columninfo.columnName);
-						const std::string& typeName = string_resource::get(columninfo.dataType);
+						const std::string& columnName = table.m_strings.get(columninfo.columnName);
+						const std::string& typeName = table.m_strings.get(columninfo.dataType);
 						bool isKey = columninfo.iskey == 0 ? false : true;
 
 						binary_column* column = new binary_column(columnName, typeName, isKey);
@@ -259,19 +354,22 @@ namespace CremaCode {
 					}
 				}
 
-				void binary_reader::read_rows(std::istream& stream, binary_table& table, size_t rowCount)
+				void binary_reader::read_rows(std::istream& stream, binary_table& table, size_t rowCount, size_t length)
 				{
+					const char* data = table.m_rows.reserve_arena(length);
+					if (length != 0)
+						stream.read(const_cast<char*>(data), length);
+
 					for (size_t i = 0; i < rowCount; i++)
 					{
 						binary_row& dataRow = table.m_rows.at(i);
 
-						int length;
-						stream.read((char*)&length, sizeof(int));
+						int fieldsLength = *(const int*)data;
+						data += sizeof(int);
 
-						dataRow.reserve_fields_ptr(length);
-						stream.read(dataRow.fields_ptr(), length);
+						dataRow.set_fields(data);
+						data += fieldsLength;
 						dataRow.set_table(table);
-						table.m_rows.generate_key(i);
 					}
 				}
 
@@ -280,8 +378,8 @@ namespace CremaCode {
 					, m_typeName(typeName)
 					, m_dataType(iniutil::name_to_type(typeName))
 					, m_iskey(isKey)
-					, m_table(nullptr)
 					, m_columnIndex(-1)
+					, m_table(nullptr)
 				{
 
 				}
@@ -332,7 +430,8 @@ namespace CremaCode {
 				}
 
 				binary_row::binary_row()
-					: m_table(nullptr)
+					: m_fields(nullptr)
+					, m_table(nullptr)
 					, m_hash(-1)
 				{
 
@@ -346,10 +445,10 @@ namespace CremaCode {
 				const void* binary_row::value_core(const inicolumn& column) const
 				{
 					static long long nullvalue = 0;
-					const int* offsets = (const int*)&m_fields.front();
+					const int* offsets = (const int*)m_fields;
 					int offset = offsets[column.index()];
 
-					const char* valuePtr = &m_fields.front() + offset;
+					const char* valuePtr = m_fields + offset;
 					const std::type_info& typeinfo = column.datatype();
 
 					if (typeinfo == typeid(std::string))
@@ -358,30 +457,12 @@ namespace CremaCode {
 							return &string_resource::empty_string;
 						if (column.type_name() == "guid")
 						{
-							if (string_resource::contains(valuePtr) == false)
-							{
-								std::vector<unsigned char> bytes = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-								bytes.assign(valuePtr, valuePtr + 16);
-								std::stringstream stream;
-								stream.str("");
-								stream << std::hex << (int)bytes[3] << (int)bytes[2] << (int)bytes[1] << (int)bytes[0];
-								stream << "-";
-								stream << std::hex << (int)bytes[5] << (int)bytes[4];
-								stream << "-";
-								stream << std::hex << (int)bytes[7] << (int)bytes[6];
-								stream << "-";
-								stream << std::hex << (int)bytes[8] << (int)bytes[9];
-								stream << "-";
-								stream << std::hex << (int)bytes[10] << (int)bytes[11] << (int)bytes[12] << (int)bytes[13] << (int)bytes[14] << (int)bytes[15];
-								string_resource::add(valuePtr, stream.str());
-							}
-
-							return &string_resource::getByPtr(valuePtr);
+							return &m_table->guid_string(valuePtr);
 						}
 						else
 						{
 							int id = *(int*)valuePtr;
-							return &string_resource::get(id);
+							return &m_table->strings().get(id);
 						}
 					}
 					else
@@ -394,7 +475,7 @@ namespace CremaCode {
 
 				bool binary_row::has_value_core(const inicolumn& column) const
 				{
-					const int* offsets = (const int*)&m_fields.front();
+					const int* offsets = (const int*)m_fields;
 					int offset = offsets[column.index()];
 					return offset != 0;
 				}
@@ -409,19 +490,19 @@ namespace CremaCode {
 					return *m_table;
 				}
 
-				long binary_row::hash() const
+				unsigned long long binary_row::hash() const
 				{
 					return m_hash;
 				}
 
-				void binary_row::reserve_fields_ptr(size_t size)
+				const char* binary_row::fields() const
 				{
-					m_fields.resize(size, 0);
+					return m_fields;
 				}
 
-				char* binary_row::fields_ptr()
+				void binary_row::set_fields(const char* fields)
 				{
-					return &m_fields.front();
+					m_fields = fields;
 				}
 
 				void binary_row::set_table(binary_table& table)
@@ -429,85 +510,18 @@ namespace CremaCode {
 					m_table = &table;
 				}
 
-				void binary_row::set_hash(long hash)
+				void binary_row::set_hash(unsigned long long hash)
 				{
 					m_hash = hash;
 				}
 
-				bool binary_row::equals_key(va_list& vl)
+				const char* binary_row::field_ptr(size_t index) const
 				{
-					for (inicolumn& item : m_table->m_keys)
-					{
-						const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-						if (typeinfo == typeid(bool))
-						{
-							if (this->value<bool>(item.name()) != !!va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(char))
-						{
-							if (this->value<char>(item.name()) != (char)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(unsigned char))
-						{
-							if (this->value<unsigned char>(item.name()) != (unsigned char)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(short))
-						{
-							if (this->value<short>(item.name()) != (short)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(unsigned short))
-						{
-							if (this->value<unsigned short>(item.name()) != (unsigned short)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(int))
-						{
-							if (this->value<int>(item.name()) != (int)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(unsigned int))
-						{
-							if (this->value<unsigned int>(item.name()) != (unsigned int)va_arg(vl, int))
-								return false;
-						}
-						else if (typeinfo == typeid(float))
-						{
-							if (this->value<float>(item.name()) != (float)va_arg(vl, double))
-								return false;
-						}
-						else if (typeinfo == typeid(double))
-						{
-							if (this->value<double>(item.name()) != (float)va_arg(vl, double))
-								return false;
-						}
-						else if (typeinfo == typeid(long long))
-						{
-							if (this->value<long long>(item.name()) != (long long)va_arg(vl, long long))
-								return false;
-						}
-						else if (typeinfo == typeid(unsigned long long))
-						{
-							if (this->value<unsigned long long>(item.name()) != (unsigned long long)va_arg(vl, long long))
-								return false;
-						}
-						else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
-						{
-							std::string text = va_arg(vl, const char*);
-							if (this->value<std::string>(item.name()) != text)
-								return false;
-						}
-						else if (typeinfo == typeid(std::string))
-						{
-							const std::string& text = *(const std::string*)va_arg(vl, const char*);
-							if (this->value<std::string>(item.name()) != text)
-								return false;
-						}
-					}
-					return true;
+					const int* offsets = (const int*)m_fields;
+					int offset = offsets[index];
+					if (offset == 0)
+						return nullptr;
+					return m_fields + offset;
 				}
 
 				binary_key_array::binary_key_array()
@@ -591,11 +605,68 @@ namespace CremaCode {
 					return iniutil::to_lower(text);
 				}
 
+				binary_key_index::binary_key_index()
+					: m_mask(0)
+				{
+
+				}
+
+				void binary_key_index::reserve(size_t count)
+				{
+					size_t capacity = 8;
+					while (capacity < count * 2)
+						capacity <<= 1;
+
+					slot empty;
+					empty.hash = 0;
+					empty.index = empty_index;
+					m_slots.assign(capacity, empty);
+					m_mask = capacity - 1;
+				}
+
+				void binary_key_index::insert(unsigned long long hash, size_t index)
+				{
+					size_t pos = this->bucket(hash);
+					while (m_slots[pos].index != empty_index)
+						pos = (pos + 1) & m_mask;
+
+					m_slots[pos].hash = hash;
+					m_slots[pos].index = (unsigned int)index;
+				}
+
+				size_t binary_key_index::find_first(unsigned long long hash) const
+				{
+					if (m_slots.empty() == true)
+						return npos;
+
+					for (size_t pos = this->bucket(hash); m_slots[pos].index != empty_index; pos = (pos + 1) & m_mask)
+					{
+						if (m_slots[pos].hash == hash)
+							return pos;
+					}
+					return npos;
+				}
+
+				size_t binary_key_index::find_next(unsigned long long hash, size_t slot) const
+				{
+					for (size_t pos = (slot + 1) & m_mask; m_slots[pos].index != empty_index; pos = (pos + 1) & m_mask)
+					{
+						if (m_slots[pos].hash == hash)
+							return pos;
+					}
+					return npos;
+				}
+
+				size_t binary_key_index::bucket(unsigned long long hash) const
+				{
+					return (size_t)(hash >> 32) & m_mask;
+				}
+
 				binary_row_array::binary_row_array(size_t count)
 					: m_rows(count)
 					, m_table(nullptr)
 				{
-					m_keyTorow.get_allocator().allocate(count);
+
 				}
 
 				binary_row_array::~binary_row_array()
@@ -619,71 +690,53 @@ namespace CremaCode {
 					return m_rows[index];
 				}
 
-				void binary_row_array::generate_key(size_t index)
+				char* binary_row_array::reserve_arena(size_t size)
 				{
-					size_t keysize = this->keys_size(), offset = 0;
+					m_arena.assign(size, 0);
+					if (size == 0)
+						return nullptr;
+					return &m_arena.front();
+				}
 
-					if (keysize == 0)
+				void binary_row_array::generate_key(size_t index)
+				{
+					size_t count = m_keyFields.size();
+					if (count == 0)
 						return;
 
+					long long buffer[8];
+					std::vector<long long> heapBuffer;
+					long long* fields = buffer;
+					if (count > 8)
+					{
+						heapBuffer.resize(count);
+						fields = &heapBuffer.front();
+					}
+
 					binary_row& row = this->at(index);
-					const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
-					std::vector<char> fields(keysize);
-					for (inicolumn& item : m_table->m_keys)
+					for (size_t i = 0; i < count; i++)
 					{
-						const std::type_info& typeinfo = item.datatype();
-						if (typeinfo == typeid(bool))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<bool>(item));
-						}
-						else if (typeinfo == typeid(char))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<char>(item));
-						}
-						else if (typeinfo == typeid(unsigned char))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<unsigned char>(item));
-						}
-						else if (typeinfo == typeid(short))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<short>(item));
-						}
-						else if (typeinfo == typeid(unsigned short))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<unsigned short>(item));
-						}
-						else if (typeinfo == typeid(int))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<int>(item));
-						}
-						else if (typeinfo == typeid(unsigned int))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<unsigned int>(item));
-						}
-						else if (typeinfo == typeid(long long))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<long long>(item));
-						}
-						else if (typeinfo == typeid(unsigned long long))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<unsigned long long>(item));
-						}
-						else if (typeinfo == typeid(float))
-						{
-							this->set_field_value(&fields.front(), offset, row.value<float>(item));
-						}
-						else if (typeinfo == typeid(std::string))
-						{
-							const std::string& text = *(const std::string*)row.value_core(item);
-							this->set_field_value(&fields.front(), offset, iniutil::get_hash_code(text));
-						}
+						fields[i] = this->pack_field(m_keyFields[i], row);
 					}
 
-					long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
+					unsigned long long hash = this->hash_fields(fields, count);
 
 					row.set_hash(hash);
 
-					m_keyTorow.insert(std::multimap<long, binary_row*>::value_type(hash, &row));
+					m_keyToIndex.insert(hash, index);
+				}
+
+				void binary_row_array::generate_keys()
+				{
+					this->prepare_keys();
+					if (m_keyFields.size() == 0)
+						return;
+
+					m_keyToIndex.reserve(m_rows.size());
+					for (size_t i = 0; i < m_rows.size(); i++)
+					{
+						this->generate_key(i);
+					}
 				}
 
 				void binary_row_array::set_table(binary_table& table)
@@ -696,163 +749,213 @@ namespace CremaCode {
 					return *m_table;
 				}
 
-				binary_row_array::iterator binary_row_array::find_core(size_t count, ...)
+				binary_row_array::iterator binary_row_array::find_core(const inikey_value* keys, size_t count)
 				{
-					if (count != m_table->m_keys.size())
+					if (count != m_keyFields.size())
 						throw std::invalid_argument("인자의 갯수가 키의 갯수랑 같지 않습니다.");
-					va_list vl;
-					size_t keysize = this->keys_size();
-					va_start(vl, count);
 
-					size_t offset = 0;
-					std::vector<char> fields(keysize);
-					const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
-
-					for (size_t i = 0; i < count; i++)
+					long long buffer[8];
+					std::vector<long long> heapBuffer;
+					long long* fields = buffer;
+					if (count > 8)
 					{
-						const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-						if (typeinfo == typeid(bool))
-						{
-							this->set_field_value(&fields.front(), offset, !!va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(char))
-						{
-							this->set_field_value(&fields.front(), offset, (char)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(unsigned char))
-						{
-							this->set_field_value(&fields.front(), offset, (unsigned char)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(short))
-						{
-							this->set_field_value(&fields.front(), offset, (short)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(unsigned short))
-						{
-							this->set_field_value(&fields.front(), offset, (unsigned short)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(int))
-						{
-							this->set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(unsigned int))
-						{
-							this->set_field_value(&fields.front(), offset, (unsigned int)va_arg(vl, int));
-						}
-						else if (typeinfo == typeid(float))
-						{
-							this->set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
-						}
-						else if (typeinfo == typeid(double))
-						{
-							this->set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
-						}
-						else if (typeinfo == typeid(long long))
-						{
-							this->set_field_value(&fields.front(), offset, (long long)va_arg(vl, long long));
-						}
-						else if (typeinfo == typeid(unsigned long long))
-						{
-							this->set_field_value(&fields.front(), offset, (unsigned long long)va_arg(vl, long long));
-						}
-						else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
-						{
-							int stringID = iniutil::get_hash_code(va_arg(vl, const char*));
-							this->set_field_value(&fields.front(), offset, stringID);
-						}
-						else if (typeinfo == typeid(std::string))
-						{
-							const std::string& text = *(const std::string*)va_arg(vl, const char*);
-							int stringID = iniutil::get_hash_code(text);
-							this->set_field_value(&fields.front(), offset, stringID);
-						}
+						heapBuffer.resize(count);
+						fields = &heapBuffer.front();
 					}
-					va_end(vl);
 
-					long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
-					std::pair <std::multimap<long, binary_row*>::iterator, std::multimap<long, binary_row*>::iterator> ret = m_keyTorow.equal_range(hash);
-
-					size_t len = std::distance(ret.first, ret.second);
-
-					if (len == 1)
+					for (size_t i = 0; i < count; i++)
 					{
-						size_t index = ret.first->second - (binary_row*)&m_rows.front();
-						return iterator(this, index);
+						fields[i] = this->pack_field(m_keyFields[i], keys[i]);
 					}
 
-					for (std::multimap<long, binary_row*>::iterator itor = ret.first; itor != ret.second; ++itor)
+					unsigned long long hash = this->hash_fields(fields, count);
+
+					for (size_t slot = m_keyToIndex.find_first(hash); slot != binary_key_index::npos; slot = m_keyToIndex.find_next(hash, slot))
 					{
-						va_list vl1;
-						va_start(vl1, count);
-						if (itor->second->equals_key(vl1) == true)
-						{
-							size_t index = itor->second - (binary_row*)&m_rows.front();
+						size_t index = m_keyToIndex.index(slot);
+						if (this->equals_key(m_rows[index], keys) == true)
 							return iterator(this, index);
-						}
-						va_end(vl1);
 					}
 
 					return iterator(this);
 				}
 
-				size_t binary_row_array::keys_size() const
+				void binary_row_array::prepare_keys()
 				{
-					size_t size = 0;
+					m_keyFields.clear();
+					m_keyFields.reserve(m_table->m_keys.size());
 
 					for (inicolumn& item : m_table->m_keys)
 					{
 						const std::type_info& typeinfo = item.datatype();
-#ifdef _DEBUG
-						const char* name = typeinfo.name();
-#endif
+						key_field field;
+						field.column = item.index();
 
 						if (typeinfo == typeid(bool))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_boolean;
 						else if (typeinfo == typeid(char))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_int8;
 						else if (typeinfo == typeid(unsigned char))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_uint8;
 						else if (typeinfo == typeid(short))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_int16;
 						else if (typeinfo == typeid(unsigned short))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_uint16;
 						else if (typeinfo == typeid(int))
-						{
-							size += sizeof(int);
-						}
+							field.type = key_type_int32;
 						else if (typeinfo == typeid(unsigned int))
-						{
-							size += sizeof(int);
-						}
-						else if (typeinfo == typeid(float))
-						{
-							size += sizeof(double);
-						}
+							field.type = key_type_uint32;
 						else if (typeinfo == typeid(long long))
-						{
-							size += sizeof(long long);
-						}
+							field.type = key_type_int64;
 						else if (typeinfo == typeid(unsigned long long))
+							field.type = key_type_uint64;
+						else if (typeinfo == typeid(float))
+							field.type = key_type_float;
+						else if (typeinfo == typeid(double))
+							field.type = key_type_double;
+						else if (typeinfo == typeid(std::string))
+							field.type = key_type_string;
+						else
+							field.type = key_type_int32;
+
+						m_keyFields.push_back(field);
+					}
+				}
+
+				const std::string& binary_row_array::key_text(const key_field& field, const binary_row& row) const
+				{
+					// guid 열은 문자열 아이디가 아니라 16바이트 값이므로 value_core를 거쳐 문자열로 바꾼다
+					return *(const std::string*)row.value_core(m_table->m_columns.at(field.column));
+				}
+
+				long long binary_row_array::pack_field(const key_field& field, const binary_row& row) const
+				{
+					const char* valuePtr = row.field_ptr(field.column);
+					long long value = 0;
+
+					switch (field.type)
+					{
+					case key_type_boolean:
+						value = valuePtr != nullptr && *(const bool*)valuePtr ? 1 : 0;
+						break;
+					case key_type_int8:
+						value = valuePtr != nullptr ? *(const char*)valuePtr : 0;
+						break;
+					case key_type_uint8:
+						value = valuePtr != nullptr ? *(const unsigned char*)valuePtr : 0;
+						break;
+					case key_type_int16:
+						value = valuePtr != nullptr ? *(const short*)valuePtr : 0;
+						break;
+					case key_type_uint16:
+						value = valuePtr != nullptr ? *(const unsigned short*)valuePtr : 0;
+						break;
+					case key_type_int32:
+						value = valuePtr != nullptr ? *(const int*)valuePtr : 0;
+						break;
+					case key_type_uint32:
+						value = valuePtr != nullptr ? *(const unsigned int*)valuePtr : 0;
+						break;
+					case key_type_int64:
+					case key_type_uint64:
+						value = valuePtr != nullptr ? *(const long long*)valuePtr : 0;
+						break;
+					case key_type_float:
+					{
+						double real = valuePtr != nullptr ? (double)*(const float*)valuePtr : 0.0;
+						memcpy(&value, &real, sizeof(double));
+						break;
+					}
+					case key_type_double:
+					{
+						double real = valuePtr != nullptr ? *(const double*)valuePtr : 0.0;
+						memcpy(&value, &real, sizeof(double));
+						break;
+					}
+					case key_type_string:
+						value = iniutil::get_hash_code(this->key_text(field, row));
+						break;
+					}
+					return value;
+				}
+
+				long long binary_row_array::pack_field(const key_field& field, const inikey_value& key) const
+				{
+					if ((field.type == key_type_string) != (key.type() == inikey_value::value_type_string))
+						throw std::invalid_argument("키의 타입이 올바르지 않습니다.");
+
+					long long value = 0;
+
+					switch (field.type)
+					{
+					case key_type_boolean:
+						value = key.to_integer() != 0 ? 1 : 0;
+						break;
+					case key_type_int8:
+						value = (char)key.to_integer();
+						break;
+					case key_type_uint8:
+						value = (unsigned char)key.to_unsigned();
+						break;
+					case key_type_int16:
+						value = (short)key.to_integer();
+						break;
+					case key_type_uint16:
+						value = (unsigned short)key.to_unsigned();
+						break;
+					case key_type_int32:
+						value = (int)key.to_integer();
+						break;
+					case key_type_uint32:
+						value = (unsigned int)key.to_unsigned();
+						break;
+					case key_type_int64:
+						value = key.to_integer();
+						break;
+					case key_type_uint64:
+						value = (long long)key.to_unsigned();
+						break;
+					case key_type_float:
+					{
+						double real = (double)(float)key.to_real();
+						memcpy(&value, &real, sizeof(double));
+						break;
+					}
+					case key_type_double:
+					{
+						double real = key.to_real();
+						memcpy(&value, &real, sizeof(double));
+						break;
+					}
+					case key_type_string:
+						value = iniutil::get_hash_code(key.text(), key.length());
+						break;
+					}
+					return value;
+				}
+
+				bool binary_row_array::equals_key(const binary_row& row, const inikey_value* keys) const
+				{
+					for (size_t i = 0; i < m_keyFields.size(); i++)
+					{
+						const key_field& field = m_keyFields[i];
+						if (field.type == key_type_string)
 						{
-							size += sizeof(long long);
+							const std::string& text = this->key_text(field, row);
+							if (text.length() != keys[i].length() || text.compare(0, text.length(), keys[i].text(), keys[i].length()) != 0)
+								return false;
 						}
-						else if (typeinfo == typeid(std::string))
+						else if (this->pack_field(field, row) != this->pack_field(field, keys[i]))
 						{
-							size += sizeof(int);
+							return false;
 						}
 					}
+					return true;
+				}
 
-					return size;
+				unsigned long long binary_row_array::hash_fields(const long long* fields, size_t count) const
+				{
+					return iniutil::hash(fields, sizeof(long long) * count);
 				}
 
 				binary_table::binary_table(binary_reader* reader, size_t columnCount, size_t rowCount)
@@ -894,6 +997,28 @@ namespace CremaCode {
 					return *m_reader;
 				}
 
+				const std::string& binary_table::guid_string(const char* ptr) const
+				{
+					std::lock_guard<std::mutex> lock(m_guidLock);
+					std::string key(ptr, 16);
+					std::map<std::string, std::string>::const_iterator itor = m_guids.find(key);
+					if (itor != m_guids.end())
+						return itor->second;
+
+					std::vector<unsigned char> bytes(ptr, ptr + 16);
+					std::stringstream stream;
+					stream << std::hex << (int)bytes[3] << (int)bytes[2] << (int)bytes[1] << (int)bytes[0];
+					stream << "-";
+					stream << std::hex << (int)bytes[5] << (int)bytes[4];
+					stream << "-";
+					stream << std::hex << (int)bytes[7] << (int)bytes[6];
+					stream << "-";
+					stream << std::hex << (int)bytes[8] << (int)bytes[9];
+					stream << "-";
+					stream << std::hex << (int)bytes[10] << (int)bytes[11] << (int)bytes[12] << (int)bytes[13] << (int)bytes[14] << (int)bytes[15];
+					return m_guids.insert(std::pair<std::string, std::string>(key, stream.str())).first->second;
+				}
+
 				binary_table::~binary_table()
 				{
 
@@ -908,9 +1033,13 @@ namespace CremaCode {
 
 				binary_table_array::~binary_table_array()
 				{
-					for (binary_table* item : m_tables)
+					for (std::atomic<binary_table*>& item : m_tables)
 					{
-						delete item;
+						delete item.load();
+					}
+					for (size_t i = 0; i < m_retiredTables.size(); i++)
+					{
+						delete m_retiredTables[i];
 					}
 				}
 
@@ -919,53 +1048,92 @@ namespace CremaCode {
 					return m_tables.size();
 				}
 
-				itable& binary_table_array::at(size_t index) const throw()
+				itable& binary_table_array::at(size_t index) const
 				{
-					itable* table = m_tables.at(index);
-					if (table == NULL)
-						return *const_cast<binary_table_array*>(this)->m_reader.read_table(index);
+					binary_table* table = m_tables.at(index).load(std::memory_order_acquire);
+					if (table == nullptr)
+						return *const_cast<binary_table_array*>(this)->load(index);
 					return *table;
 				}
 
-				itable& binary_table_array::at(const std::string& tableName) const throw()
+				itable& binary_table_array::at(const std::string& tableName) const
 				{
-					std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-					if (itor == m_nameToTable.end())
-					{
-						return *const_cast<binary_table_array*>(this)->m_reader.read_table(conv_string(tableName));
-					}
-					return *itor->second;
+					return this->at(this->index_of(tableName));
 				}
 
 				bool binary_table_array::contains(const std::string& tableName) const
 				{
-					return m_nameToTable.find(conv_string(tableName)) != m_nameToTable.end();
+					return this->is_table_loaded(tableName);
 				}
 
 				void binary_table_array::set(size_t index, binary_table* table)
 				{
-					std::string tableName;
-					m_nameToTable[conv_string(table->name())] = table;
-					m_tables[index] = table;
-					dynamic_cast<binary_table*>(table)->set_index(index);
+					table->set_index(index);
+					m_tables[index].store(table, std::memory_order_release);
+				}
 
-#ifdef _DEBUG
-					//std::cout << table->name() << " is loaded : " << index << std::endl;
-#endif
+				// 내려진 테이블은 다른 스레드가 아직 참조하고 있을 수 있으므로 reclaim_tables 까지 보관합니다.
+				void binary_table_array::retire(binary_table* table)
+				{
+					if (table == nullptr)
+						return;
+					std::lock_guard<std::mutex> lock(m_retiredLock);
+					m_retiredTables.push_back(table);
 				}
 
-				void binary_table_array::set_size(const std::vector<table_index>& indexes)
+				size_t binary_table_array::reclaim_tables()
 				{
-					m_tables.assign(indexes.size(), NULL);
+					std::vector<binary_table*> tables;
+					{
+						std::lock_guard<std::mutex> lock(m_retiredLock);
+						tables.swap(m_retiredTables);
+					}
+					for (size_t i = 0; i < tables.size(); i++)
+					{
+						delete tables[i];
+					}
+					return tables.size();
+				}
+
+				void binary_table_array::set_size(const std::vector<table_index>& indexes, const string_pool& strings)
+				{
+					std::vector<std::atomic<binary_table*> > tables(indexes.size());
+					m_tables.swap(tables);
+					m_nameToIndex.clear();
 
 					m_tableNames.reserve(indexes.size());
-					for (std::vector<table_index>::const_iterator itor = indexes.begin(); itor != indexes.end(); itor++)
+					for (size_t i = 0; i < indexes.size(); i++)
 					{
-						const std::string& tableName = string_resource::get(itor->tableName);
+						const std::string& tableName = strings.get(indexes[i].tableName);
 						m_tableNames.push_back(tableName);
+						m_nameToIndex[conv_string(tableName)] = i;
+						m_tables[i].store(nullptr, std::memory_order_relaxed);
 					}
 				}
 
+				size_t binary_table_array::index_of(const std::string& tableName) const
+				{
+					std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+					if (itor == m_nameToIndex.end())
+						throw keynotfoundexception(tableName, "tables");
+					return itor->second;
+				}
+
+				// 여러 스레드가 같은 테이블을 동시에 읽으면 먼저 게시한 테이블을 쓰고 나머지는 버립니다.
+				binary_table* binary_table_array::load(size_t index)
+				{
+					binary_table* table = m_reader.read_table(index);
+					table->set_index(index);
+					binary_table* expected = nullptr;
+
+					if (m_tables[index].compare_exchange_strong(expected, table, std::memory_order_acq_rel, std::memory_order_acquire) == false)
+					{
+						delete table;
+						return expected;
+					}
+					return table;
+				}
+
 				void binary_table_array::set_flag(ReadFlag flag)
 				{
 					m_caseSensitive = (flag & ReadFlag_case_sensitive) != 0;
@@ -985,27 +1153,29 @@ namespace CremaCode {
 
 				bool binary_table_array::is_table_loaded(const std::string& tableName) const
 				{
-					std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-					return itor != m_nameToTable.end();
+					std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+					if (itor == m_nameToIndex.end())
+						return false;
+					return m_tables[itor->second].load(std::memory_order_acquire) != nullptr;
 				}
 
 				void binary_table_array::load_table(const std::string& tableName)
 				{
-					if (this->is_table_loaded(tableName) == true)
-						return;
-
-					m_reader.read_table(conv_string(tableName));
+					this->at(tableName);
 				}
 
 				void binary_table_array::release_table(const std::string& tableName)
 				{
-					std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-					if (itor == m_nameToTable.end())
+					std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+					if (itor == m_nameToIndex.end())
+						return;
+
+					std::atomic<binary_table*>& slot = m_tables[itor->second];
+					binary_table* table = slot.load(std::memory_order_acquire);
+					if (table == nullptr)
 						return;
-					binary_table* table = itor->second;
-					m_nameToTable.erase(itor->first);
-					m_tables[table->index()] = nullptr;
-					delete table;
+					if (slot.compare_exchange_strong(table, nullptr, std::memory_order_acq_rel, std::memory_order_acquire) == true)
+						this->retire(table);
 				}
 			} /*namespace binary*/
 		} /*namespace internal*/
@@ -1296,188 +1466,356 @@ namespace CremaCode {
 			return data;
 		}
 
-		int iniutil::get_hash_code(const std::string& text)
+		namespace
 		{
-			std::wstring wtext = string_to_wstring(text);
-			const wchar_t* chPtr = wtext.c_str();
-
-			int num = 0x15051505;
-			int num2 = num;
-			int* numPtr = (int*)chPtr;
-			for (int i = (int)wtext.length(); i > 0; i -= 4)
+			// .NET 의 String.GetHashCode 와 같은 값을 UTF-16 코드 단위를 하나씩 받아 계산합니다.
+			// 코드 단위 네 개마다 두 상태에 하나씩 섞고, 마지막에 남은 단위는 끝의 null 문자와 함께 섞습니다.
+			class utf16_hash
 			{
-				num = (((num << 5) + num) + (num >> 0x1b)) ^ numPtr[0];
-				if (i <= 2)
-					break;
-				num2 = (((num2 << 5) + num2) + (num2 >> 0x1b)) ^ numPtr[1];
-				numPtr += 2;
-			}
-			return num + (num2 * 0x5d588b65);
-		}
-
-		long iniutil::generate_hash_core(size_t count, size_t keysize, ...)
-		{
-			va_list vl;
+			public:
+				utf16_hash()
+					: m_num(0x15051505), m_num2(0x15051505), m_count(0)
+				{
 
-			va_start(vl, keysize);
-			size_t offset = 0;
-			std::vector<char> fields(keysize);
-			const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
+				}
 
-			for (size_t i = 0; i < count; i++)
-			{
-				const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-#ifdef _DEBUG
-				const char* name = typeinfo.name();
-#endif
+				void push(unsigned int unit)
+				{
+					m_units[m_count++] = unit;
+					if (m_count == 4)
+					{
+						this->push_words(m_units[0] | (m_units[1] << 16), m_units[2] | (m_units[3] << 16));
+						m_count = 0;
+					}
+				}
 
-				if (typeinfo == typeid(bool))
+				// 코드 단위 네 개를 두 단어로 묶어 한번에 섞습니다. 남은 단위가 없을 때만 호출합니다.
+				void push_words(unsigned int word1, unsigned int word2)
 				{
-					internal_util::set_field_value(&fields.front(), offset, !!va_arg(vl, int));
+					m_num = mix(m_num, word1);
+					m_num2 = mix(m_num2, word2);
 				}
-				else if (typeinfo == typeid(char))
+
+				bool aligned() const
 				{
-					internal_util::set_field_value(&fields.front(), offset, (char)va_arg(vl, int));
+					return m_count == 0;
 				}
-				else if (typeinfo == typeid(unsigned char))
+
+				int finish() const
 				{
-					internal_util::set_field_value(&fields.front(), offset, (unsigned char)va_arg(vl, int));
+					unsigned int num = m_num;
+					unsigned int num2 = m_num2;
+					if (m_count != 0)
+						num = mix(num, m_units[0] | (m_count > 1 ? m_units[1] << 16 : 0));
+					if (m_count == 3)
+						num2 = mix(num2, m_units[2]);
+					return (int)(num + num2 * 0x5d588b65U);
 				}
-				else if (typeinfo == typeid(short))
+
+			private:
+				static unsigned int mix(unsigned int num, unsigned int word)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (short)va_arg(vl, int));
+					return ((num << 5) + num + (unsigned int)((int)num >> 27)) ^ word;
 				}
-				else if (typeinfo == typeid(unsigned short))
+
+			private:
+				unsigned int m_num;
+				unsigned int m_num2;
+				unsigned int m_units[4];
+				size_t m_count;
+			};
+
+			// 16 바이트가 모두 ASCII 이면 UTF-16 코드 단위로 넓혀 섞고 true 를 반환합니다.
+			bool push_ascii16(utf16_hash& hash, const unsigned char* text)
+			{
+				unsigned int words[8];
+	#ifdef CREMA_HASH_SSE2
+				const __m128i bytes = _mm_loadu_si128((const __m128i*)text);
+				if (_mm_movemask_epi8(bytes) != 0)
+					return false;
+				const __m128i zero = _mm_setzero_si128();
+				_mm_storeu_si128((__m128i*)words, _mm_unpacklo_epi8(bytes, zero));
+				_mm_storeu_si128((__m128i*)(words + 4), _mm_unpackhi_epi8(bytes, zero));
+	#else
+				unsigned long long blocks[2];
+				memcpy(blocks, text, sizeof(blocks));
+				if (((blocks[0] | blocks[1]) & 0x8080808080808080ULL) != 0)
+					return false;
+				for (size_t i = 0; i < 8; i++)
+				{
+					words[i] = text[i * 2] | ((unsigned int)text[i * 2 + 1] << 16);
+				}
+	#endif
+				for (size_t i = 0; i < 8; i += 2)
+				{
+					hash.push_words(words[i], words[i + 1]);
+				}
+				return true;
+			}
+
+			// UTF-8 문자 하나를 UTF-16 코드 단위로 바꾸어 섞고 읽은 바이트 수를 반환합니다.
+			// 잘못된 바이트는 U+FFFD 로 바꾸어 한 바이트씩 넘깁니다.
+			size_t push_utf8(utf16_hash& hash, const unsigned char* text, size_t length)
+			{
+				const unsigned int lead = text[0];
+				unsigned int code;
+				size_t size;
+				if (lead < 0x80)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (unsigned short)va_arg(vl, int));
+					hash.push(lead);
+					return 1;
 				}
-				else if (typeinfo == typeid(int))
+				else if ((lead & 0xe0) == 0xc0)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
+					code = lead & 0x1f;
+					size = 2;
 				}
-				else if (typeinfo == typeid(unsigned int))
+				else if ((lead & 0xf0) == 0xe0)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (unsigned int)va_arg(vl, int));
+					code = lead & 0x0f;
+					size = 3;
 				}
-				else if (typeinfo == typeid(float))
+				else if ((lead & 0xf8) == 0xf0)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
+					code = lead & 0x07;
+					size = 4;
 				}
-				else if (typeinfo == typeid(double))
+				else
 				{
-					internal_util::set_field_value(&fields.front(), offset, (double)va_arg(vl, double));
+					hash.push(0xfffd);
+					return 1;
 				}
-				else if (typeinfo == typeid(long long))
+
+				if (size > length)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (long long)va_arg(vl, long long));
+					hash.push(0xfffd);
+					return 1;
 				}
-				else if (typeinfo == typeid(unsigned long long))
+
+				for (size_t i = 1; i < size; i++)
 				{
-					internal_util::set_field_value(&fields.front(), offset, (unsigned long long)va_arg(vl, long long));
+					if ((text[i] & 0xc0) != 0x80)
+					{
+						hash.push(0xfffd);
+						return 1;
+					}
+					code = (code << 6) | (text[i] & 0x3f);
 				}
-				else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
+
+				if (code > 0x10ffff)
 				{
-					int stringID = iniutil::get_hash_code(va_arg(vl, const char*));
-					internal_util::set_field_value(&fields.front(), offset, stringID);
+					hash.push(0xfffd);
 				}
-				else if (typeinfo == typeid(std::string))
+				else if (code >= 0x10000)
 				{
-					const std::string text = (const std::string)va_arg(vl, const std::string);
-					int stringID = iniutil::get_hash_code(text);
-					internal_util::set_field_value(&fields.front(), offset, stringID);
+					code -= 0x10000;
+					hash.push(0xd800 | (code >> 10));
+					hash.push(0xdc00 | (code & 0x3ff));
 				}
 				else
 				{
-					internal_util::set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
+					hash.push(code);
+				}
+				return size;
+			}
+
+			int hash_utf8(const char* text, size_t length)
+			{
+				const unsigned char* ptr = (const unsigned char*)text;
+				const unsigned char* end = ptr + length;
+				utf16_hash hash;
+				while (ptr != end)
+				{
+					if (hash.aligned() == true && end - ptr >= 16 && push_ascii16(hash, ptr) == true)
+					{
+						ptr += 16;
+						continue;
+					}
+					ptr += push_utf8(hash, ptr, (size_t)(end - ptr));
 				}
+				return hash.finish();
 			}
-			va_end(vl);
+		}
+
+		int iniutil::get_hash_code(const std::string& text)
+		{
+			return hash_utf8(text.c_str(), text.length());
+		}
 
-			long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
+		int iniutil::get_hash_code(const char* text)
+		{
+			return hash_utf8(text, strlen(text));
+		}
 
-			return hash;
+		int iniutil::get_hash_code(const char* text, size_t length)
+		{
+			return hash_utf8(text, length);
 		}
 
-		size_t iniutil::keys_size(size_t count, ...)
+		namespace
 		{
-			va_list vl;
-			va_start(vl, count);
-			size_t size = 0;
+			const unsigned long long hash_prime1 = 0x9e3779b185ebca87ULL;
+			const unsigned long long hash_prime2 = 0xc2b2ae3d27d4eb4fULL;
+			const unsigned long long hash_prime3 = 0x165667b19e3779f9ULL;
+			const unsigned long long hash_prime4 = 0x85ebca77c2b2ae63ULL;
+			const unsigned long long hash_prime5 = 0x27d4eb2f165667c5ULL;
+
+			inline unsigned long long hash_rotl(unsigned long long value, int count)
+			{
+				return (value << count) | (value >> (64 - count));
+			}
+
+			inline unsigned long long hash_read64(const unsigned char* ptr)
+			{
+				return (unsigned long long)ptr[0] | ((unsigned long long)ptr[1] << 8) | ((unsigned long long)ptr[2] << 16) | ((unsigned long long)ptr[3] << 24) |
+					((unsigned long long)ptr[4] << 32) | ((unsigned long long)ptr[5] << 40) | ((unsigned long long)ptr[6] << 48) | ((unsigned long long)ptr[7] << 56);
+			}
+
+			inline unsigned long long hash_read32(const unsigned char* ptr)
+			{
+				return (unsigned long long)ptr[0] | ((unsigned long long)ptr[1] << 8) | ((unsigned long long)ptr[2] << 16) | ((unsigned long long)ptr[3] << 24);
+			}
+
+			inline unsigned long long hash_round(unsigned long long acc, unsigned long long input)
+			{
+				acc += input * hash_prime2;
+				acc = hash_rotl(acc, 31);
+				return acc * hash_prime1;
+			}
+
+			inline unsigned long long hash_merge(unsigned long long acc, unsigned long long value)
+			{
+				acc ^= hash_round(0, value);
+				return acc * hash_prime1 + hash_prime4;
+			}
+		}
+
+		unsigned long long iniutil::hash(const void* data, size_t length)
+		{
+			return iniutil::hash(data, length, default_hash_seed);
+		}
+
+		unsigned long long iniutil::hash(const void* data, size_t length, unsigned long long seed)
+		{
+			const unsigned char* ptr = (const unsigned char*)data;
+			const unsigned char* end = ptr + length;
+			unsigned long long value;
+
+			if (length >= 32)
+			{
+				unsigned long long v1 = seed + hash_prime1 + hash_prime2;
+				unsigned long long v2 = seed + hash_prime2;
+				unsigned long long v3 = seed;
+				unsigned long long v4 = seed - hash_prime1;
+
+				do
+				{
+					v1 = hash_round(v1, hash_read64(ptr));
+					v2 = hash_round(v2, hash_read64(ptr + 8));
+					v3 = hash_round(v3, hash_read64(ptr + 16));
+					v4 = hash_round(v4, hash_read64(ptr + 24));
+					ptr += 32;
+				} while (ptr + 32 <= end);
+
+				value = hash_rotl(v1, 1) + hash_rotl(v2, 7) + hash_rotl(v3, 12) + hash_rotl(v4, 18);
+				value = hash_merge(value, v1);
+				value = hash_merge(value, v2);
+				value = hash_merge(value, v3);
+				value = hash_merge(value, v4);
+			}
+			else
+			{
+				value = seed + hash_prime5;
+			}
+
+			value += (unsigned long long)length;
+
+			while (ptr + 8 <= end)
+			{
+				value ^= hash_round(0, hash_read64(ptr));
+				value = hash_rotl(value, 27) * hash_prime1 + hash_prime4;
+				ptr += 8;
+			}
+
+			if (ptr + 4 <= end)
+			{
+				value ^= hash_read32(ptr) * hash_prime1;
+				value = hash_rotl(value, 23) * hash_prime2 + hash_prime3;
+				ptr += 4;
+			}
+
+			while (ptr < end)
+			{
+				value ^= (*ptr) * hash_prime5;
+				value = hash_rotl(value, 11) * hash_prime1;
+				ptr++;
+			}
+
+			value ^= value >> 33;
+			value *= hash_prime2;
+			value ^= value >> 29;
+			value *= hash_prime3;
+			value ^= value >> 32;
+			return value;
+		}
+
+		unsigned long long iniutil::generate_hash_core(const inikey_value* keys, size_t count)
+		{
+			long long buffer[8] = { 0 };
+			std::vector<long long> heapBuffer;
+			long long* fields = buffer;
+			if (count > 8)
+			{
+				heapBuffer.resize(count);
+				fields = &heapBuffer.front();
+			}
 
 			for (size_t i = 0; i < count; i++)
 			{
-				const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-				if (typeinfo == typeid(bool))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(char))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(unsigned char))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(short))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(unsigned short))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(int))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(unsigned int))
-				{
-					size += sizeof(int);
-				}
-				else if (typeinfo == typeid(float))
-				{
-					size += sizeof(float);
-				}
-				else if (typeinfo == typeid(double))
-				{
-					size += sizeof(double);
-				}
-				else if (typeinfo == typeid(long long))
-				{
-					size += sizeof(long long);
-				}
-				else if (typeinfo == typeid(unsigned long long))
+				const inikey_value& key = keys[i];
+				long long value = 0;
+
+				switch (key.type())
 				{
-					size += sizeof(long long);
-				}
-				else if (typeinfo == typeid(std::string))
+				case inikey_value::value_type_integer:
+					value = key.to_integer();
+					break;
+				case inikey_value::value_type_unsigned:
+					value = (long long)key.to_unsigned();
+					break;
+				case inikey_value::value_type_real:
 				{
-					size += sizeof(int);
+					double real = key.to_real();
+					memcpy(&value, &real, sizeof(double));
+					break;
 				}
-				else
-				{
-					size += sizeof(int);
+				case inikey_value::value_type_string:
+					value = iniutil::get_hash_code(key.text(), key.length());
+					break;
 				}
+				fields[i] = value;
 			}
-			return size;
+
+			return iniutil::hash(fields, sizeof(long long) * count);
 		}
 
 		const int s_magic_value = 0x04000000;
+		std::atomic<iload_listener*> s_load_listener(nullptr);
 
-		
 
 		CremaReader::CremaReader()
 			: m_stream(nullptr)
 		{
-			string_resource::add_ref();
+			std::lock_guard<std::mutex> lock(static_data.m_lock);
 			static_data.m_readers.push_back(this);
 		}
 
 		CremaReader::~CremaReader()
 		{
-			static_data.m_readers.remove(this);
-			string_resource::remove_ref();
+			{
+				std::lock_guard<std::mutex> lock(static_data.m_lock);
+				static_data.m_readers.remove(this);
+			}
 			if (m_stream != nullptr)
 			{
 				delete m_stream;
@@ -1521,6 +1859,270 @@ namespace CremaCode {
 			return reader;
 		}
 
+		void CremaReader::set_load_listener(iload_listener* listener)
+		{
+			s_load_listener = listener;
+		}
+
+		iload_listener* CremaReader::load_listener()
+		{
+			return s_load_listener;
+		}
+
+		namespace
+		{
+			void write_json_string(std::ostream& stream, const std::string& text)
+			{
+				stream << '"';
+				for (size_t i = 0; i < text.length(); i++)
+				{
+					unsigned char ch = (unsigned char)text[i];
+					if (ch == '"' || ch == '\\')
+						stream << '\\' << (char)ch;
+					else if (ch < 0x20)
+						stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)ch << std::dec << std::setfill(' ');
+					else
+						stream << (char)ch;
+				}
+				stream << '"';
+			}
+
+			// trace event 는 마이크로초 단위입니다.
+			void write_time(std::ostream& stream, long long nanoseconds)
+			{
+				stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+			}
+
+			class trace_writer
+			{
+			public:
+				trace_writer(std::ostream& stream, long long origin)
+					: m_stream(stream), m_origin(origin), m_firstEvent(true), m_firstArg(true)
+				{
+
+				}
+
+				size_t tid(size_t thread)
+				{
+					std::map<size_t, size_t>::iterator itor = m_threads.find(thread);
+					if (itor != m_threads.end())
+						return itor->second;
+					size_t id = m_threads.size() + 1;
+					m_threads.insert(std::make_pair(thread, id));
+					return id;
+				}
+
+				// 이름과 인자를 가진 "X"(complete) 이벤트를 시작합니다. 인자는 arg 로 이어 쓰고 end 로 닫습니다.
+				void begin(const std::string& name, const char* category, size_t thread, long long start, long long duration)
+				{
+					m_stream << (m_firstEvent == true ? "\n" : ",\n") << "{\"name\":";
+					m_firstEvent = false;
+					write_json_string(m_stream, name);
+					m_stream << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << this->tid(thread) << ",\"ts\":";
+					write_time(m_stream, start - m_origin);
+					m_stream << ",\"dur\":";
+					write_time(m_stream, duration);
+					m_stream << ",\"args\":{";
+					m_firstArg = true;
+				}
+
+				template<typename T>
+				void arg(const char* name, const T& value)
+				{
+					m_stream << (m_firstArg == true ? "" : ",") << '"' << name << "\":" << value;
+					m_firstArg = false;
+				}
+
+				void end()
+				{
+					m_stream << "}}";
+				}
+
+				void phase(const char* name, const char* category, size_t thread, long long& start, long long duration)
+				{
+					if (duration > 0)
+					{
+						this->begin(name, category, thread, start, duration);
+						this->end();
+					}
+					start += duration;
+				}
+
+			private:
+				std::ostream& m_stream;
+				long long m_origin;
+				bool m_firstEvent;
+				bool m_firstArg;
+				std::map<size_t, size_t> m_threads;
+			};
+		}
+
+		initable_stats::initable_stats()
+			: index(0), thread(0), start(0), wall_time(0), read_time(0), decompress_time(0), strings_time(0), columns_time(0), rows_time(0), index_time(0),
+			bytes_read(0), raw_bytes(0), rows(0), columns(0), strings(0), allocations(-1)
+		{
+
+		}
+
+		inidataset_stats::inidataset_stats()
+			: thread(0), start(0), wall_time(0), header_time(0), string_resources_time(0), tables_time(0), bytes_read(0), table_count(0), strings(0)
+		{
+
+		}
+
+		const initable_stats* iniload_stats::find(const std::string& tableName) const
+		{
+			for (size_t i = tables.size(); i > 0; i--)
+			{
+				if (tables[i - 1].name == tableName)
+					return &tables[i - 1];
+			}
+			return nullptr;
+		}
+
+		std::vector<const initable_stats*> iniload_stats::slowest(size_t count) const
+		{
+			std::vector<const initable_stats*> items;
+			items.reserve(tables.size());
+			for (size_t i = 0; i < tables.size(); i++)
+			{
+				items.push_back(&tables[i]);
+			}
+
+			count = std::min(count, items.size());
+			std::partial_sort(items.begin(), items.begin() + count, items.end(), [](const initable_stats* x, const initable_stats* y)
+			{
+				return x->wall_time > y->wall_time;
+			});
+			items.resize(count);
+			return items;
+		}
+
+		long long iniload_stats::total_wall_time() const
+		{
+			long long total = 0;
+			for (size_t i = 0; i < datasets.size(); i++)
+			{
+				total += datasets[i].wall_time;
+			}
+			return total;
+		}
+
+		size_t iniload_stats::total_bytes_read() const
+		{
+			size_t total = 0;
+			for (size_t i = 0; i < datasets.size(); i++)
+			{
+				total += datasets[i].bytes_read;
+			}
+			for (size_t i = 0; i < tables.size(); i++)
+			{
+				total += tables[i].bytes_read;
+			}
+			return total;
+		}
+
+		iniload_trace::iniload_trace()
+		{
+
+		}
+
+		iniload_trace::~iniload_trace()
+		{
+
+		}
+
+		void iniload_trace::dataset_loaded(const inidataset_stats& stats)
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_stats.datasets.push_back(stats);
+		}
+
+		void iniload_trace::table_loaded(const initable_stats& stats)
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_stats.tables.push_back(stats);
+		}
+
+		iniload_stats iniload_trace::stats() const
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			return m_stats;
+		}
+
+		void iniload_trace::clear()
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_stats.datasets.clear();
+			m_stats.tables.clear();
+		}
+
+		void iniload_trace::write_chrome_trace(const std::string& filename) const
+		{
+			std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+			if (stream.is_open() == false)
+				throw std::invalid_argument("파일을 만들 수 없습니다: " + filename);
+			this->write_chrome_trace(stream);
+		}
+
+		void iniload_trace::write_chrome_trace(std::ostream& stream) const
+		{
+			iniload_stats stats = this->stats();
+
+			std::vector<long long> starts;
+			for (size_t i = 0; i < stats.datasets.size(); i++)
+			{
+				starts.push_back(stats.datasets[i].start);
+			}
+			for (size_t i = 0; i < stats.tables.size(); i++)
+			{
+				starts.push_back(stats.tables[i].start);
+			}
+			long long origin = starts.empty() == true ? 0 : *std::min_element(starts.begin(), starts.end());
+
+			trace_writer writer(stream, origin);
+			stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+			for (size_t i = 0; i < stats.datasets.size(); i++)
+			{
+				const inidataset_stats& item = stats.datasets[i];
+				writer.begin(item.name.empty() == true ? "read" : item.name, "dataset", item.thread, item.start, item.wall_time);
+				writer.arg("bytes_read", item.bytes_read);
+				writer.arg("tables", item.table_count);
+				writer.arg("strings", item.strings);
+				writer.end();
+
+				long long start = item.start;
+				writer.phase("header", "dataset", item.thread, start, item.header_time);
+				writer.phase("string resources", "dataset", item.thread, start, item.string_resources_time);
+			}
+
+			for (size_t i = 0; i < stats.tables.size(); i++)
+			{
+				const initable_stats& item = stats.tables[i];
+				writer.begin(item.name, "table", item.thread, item.start, item.wall_time);
+				writer.arg("index", item.index);
+				writer.arg("bytes_read", item.bytes_read);
+				writer.arg("raw_bytes", item.raw_bytes);
+				writer.arg("rows", item.rows);
+				writer.arg("columns", item.columns);
+				writer.arg("strings", item.strings);
+				if (item.allocations >= 0)
+					writer.arg("allocations", item.allocations);
+				writer.end();
+
+				long long start = item.start;
+				writer.phase("read", "table", item.thread, start, item.read_time);
+				writer.phase("decompress", "table", item.thread, start, item.decompress_time);
+				writer.phase("strings", "table", item.thread, start, item.strings_time);
+				writer.phase("columns", "table", item.thread, start, item.columns_time);
+				writer.phase("rows", "table", item.thread, start, item.rows_time);
+				writer.phase("index", "table", item.thread, start, item.index_time);
+			}
+
+			stream << "\n]}\n";
+		}
+
 #ifdef _MSC_VER
 		keynotfoundexception::keynotfoundexception(const std::string& key, const std::string& container_name)
 			: out_of_range(format_string(key, container_name).c_str())
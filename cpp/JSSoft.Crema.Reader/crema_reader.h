@@ -32,7 +32,16 @@
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
-#include <cstdarg>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+
+// 생성 코드와 함께 컴파일하는 단일 파일 리더입니다. 생성 코드는 행 단위 접근과 지연 로딩만 쓰므로
+// 라이브러리(include/crema)의 다음 기능은 이 파일에 옮기지 않았습니다.
+// - ReadFlag_memory_mapped: 파일을 메모리에 매핑해 행을 복사하지 않고 여는 경로
+// - ReadFlag_parallel_loading: 여는 동안 여러 스레드에서 테이블을 읽는 경로
+// - itable::column_data: 열 단위로 값을 모아 보는 보기
+// - itable::select, inipredicate: 조건으로 행을 고르는 API
 
 namespace CremaCode {
 	namespace reader {
@@ -57,7 +66,7 @@ namespace CremaCode {
 			cremaiterator(_inicontainer* c, size_t i) : i(i), c(c) { }
 			cremaiterator(const cremaiterator& mit) : i(mit.i), c(mit.c) { }
 
-			cremaiterator& operator++() { i = std::min(c->size(), ++i); return *this; }
+			cremaiterator& operator++() { i = std::min(c->size(), i + 1); return *this; }
 			cremaiterator operator++(int) { cremaiterator tmp(*this); operator++(); return tmp; }
 			bool operator==(const cremaiterator& rhs) { return i == rhs.i; }
 			bool operator!=(const cremaiterator& rhs) { return i != rhs.i; }
@@ -77,7 +86,7 @@ namespace CremaCode {
 			const_cremaiterator(const _inicontainer* c, size_t i) : i(i), c(c) { }
 			const_cremaiterator(const const_cremaiterator& mit) : i(mit.i), c(mit.c) { }
 
-			const_cremaiterator& operator++() { i = std::min(c->size(), ++i); return *this; }
+			const_cremaiterator& operator++() { i = std::min(c->size(), i + 1); return *this; }
 			const_cremaiterator operator++(int) { const_cremaiterator tmp(*this); operator++(); return tmp; }
 			bool operator==(const const_cremaiterator& rhs) { return i == rhs.i; }
 			bool operator!=(const const_cremaiterator& rhs) { return i != rhs.i; }
@@ -113,7 +122,8 @@ namespace CremaCode {
 
 			virtual void set_value(const std::string& columnName, const std::string& text) = 0;
 			virtual itable& table() const = 0;
-			virtual long hash() const = 0;
+			virtual unsigned long long hash() const = 0;
+			virtual const char* fields() const = 0;
 
 			template<typename T>
 			const T& value(const std::string& columnName) const;
@@ -232,6 +242,53 @@ namespace CremaCode {
 			const_iterator end() const { return const_iterator(this); }
 		};
 
+		class inikey_value
+		{
+		public:
+			enum value_type
+			{
+				value_type_integer,
+				value_type_unsigned,
+				value_type_real,
+				value_type_string,
+			};
+
+			inikey_value(bool value) : m_type(value_type_integer), m_length(0) { m_integer = value ? 1 : 0; }
+			inikey_value(char value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(signed char value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(unsigned char value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+			inikey_value(short value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(unsigned short value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+			inikey_value(int value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(unsigned int value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+			inikey_value(long value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(unsigned long value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+			inikey_value(long long value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+			inikey_value(unsigned long long value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+			inikey_value(float value) : m_type(value_type_real), m_length(0) { m_real = value; }
+			inikey_value(double value) : m_type(value_type_real), m_length(0) { m_real = value; }
+			inikey_value(const char* value) : m_type(value_type_string), m_length(strlen(value)) { m_text = value; }
+			inikey_value(const std::string& value) : m_type(value_type_string), m_length(value.length()) { m_text = value.c_str(); }
+
+			value_type type() const { return m_type; }
+			long long to_integer() const { return m_type == value_type_real ? (long long)m_real : m_integer; }
+			unsigned long long to_unsigned() const { return m_type == value_type_real ? (unsigned long long)m_real : m_unsigned; }
+			double to_real() const { return m_type == value_type_real ? m_real : m_type == value_type_unsigned ? (double)m_unsigned : (double)m_integer; }
+			const char* text() const { return m_text; }
+			size_t length() const { return m_length; }
+
+		private:
+			value_type m_type;
+			union
+			{
+				long long m_integer;
+				unsigned long long m_unsigned;
+				double m_real;
+				const char* m_text;
+			};
+			size_t m_length;
+		};
+
 		class irow_array
 		{
 		public:
@@ -251,72 +308,15 @@ namespace CremaCode {
 			const_iterator begin() const { return const_iterator(this, 0); }
 			const_iterator end() const { return const_iterator(this); }
 
-			template<typename key_type>
-			iterator find(key_type key_value)
+			template<typename... key_types>
+			iterator find(const key_types&... key_values)
 			{
-				this->type_validation<key_type>();
-				return this->find_core(1, &typeid(key_type), key_value);
-			}
-
-			template<typename key_type1, typename key_type2>
-			iterator find(key_type1 key_value1, key_type2 key_value2)
-			{
-				this->type_validation<key_type1>();
-				this->type_validation<key_type2>();
-				return this->find_core(2,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2);
-			}
-
-			template<typename key_type1, typename key_type2, typename key_type3>
-			iterator find(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3)
-			{
-				this->type_validation<key_type1>();
-				this->type_validation<key_type2>();
-				this->type_validation<key_type3>();
-				return this->find_core(3,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2,
-					&typeid(key_type3), key_value3);
-			}
-
-			template<typename key_type1, typename key_type2, typename key_type3, typename key_type4>
-			iterator find(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4)
-			{
-				this->type_validation<key_type1>();
-				this->type_validation<key_type2>();
-				this->type_validation<key_type3>();
-				this->type_validation<key_type4>();
-				return this->find_core(4,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2,
-					&typeid(key_type3), key_value3,
-					&typeid(key_type4), key_value4);
+				const inikey_value keys[] = { inikey_value(key_values)... };
+				return this->find_core(keys, sizeof...(key_types));
 			}
 
 		protected:
-			virtual iterator find_core(size_t count, ...) = 0;
-
-		private:
-			template<typename type>
-			void type_validation()
-			{
-#ifdef _MSC_VER
-				bool value = std::is_integral<type>::value ||
-					std::is_floating_point<type>::value ||
-					typeid(type) == typeid(const char*) ||
-					typeid(type) == typeid(char*) ||
-					typeid(type) == typeid(std::string) ||
-					typeid(type) == typeid(const std::string);
-				if (value == false)
-				{
-					std::ostringstream stream;
-					const char* werewr = typeid(type).name();
-					stream << typeid(type).name() << "은(는) 올바른 타입이 아닙니다.";
-					throw std::invalid_argument(stream.str());
-				}
-#endif
-			}
+			virtual iterator find_core(const inikey_value* keys, size_t count) = 0;
 		};
 
 		class itable
@@ -351,13 +351,17 @@ namespace CremaCode {
 			virtual ~itable_array() {};
 
 			virtual size_t size() const = 0;
-			virtual itable& at(size_t index) const throw() = 0;
-			virtual itable& at(const std::string& tableName) const throw() = 0;
+			virtual itable& at(size_t index) const = 0;
+			virtual itable& at(const std::string& tableName) const = 0;
 			virtual bool contains(const std::string& tableName) const = 0;
 			virtual const itableNameArray& names() const = 0;
 			virtual bool is_table_loaded(const std::string& tableName) const = 0;
 			virtual void load_table(const std::string& tableName) = 0;
+			// 테이블을 바로 해제하지 않고 보관합니다. 이전에 얻은 itable, irow 참조는 reclaim_tables 가 불릴 때까지 유효합니다.
 			virtual void release_table(const std::string& tableName) = 0;
+			// release_table 로 보관한 테이블을 해제하고 해제한 개수를 반환합니다.
+			// 호출하는 쪽에서 보관된 테이블을 참조하는 스레드가 없음을 보장해야 합니다.
+			virtual size_t reclaim_tables() = 0;
 
 			itable& operator [] (const std::string& tableName) const;
 			itable& operator [] (size_t index) const;
@@ -413,6 +417,100 @@ namespace CremaCode {
 			ReadFlag_mask = 0xff,
 		};
 
+		// 시간은 모두 std::chrono::steady_clock 기준 나노초입니다.
+		struct initable_stats
+		{
+			initable_stats();
+
+			std::string name;
+			size_t index;
+			// 테이블을 읽은 스레드의 std::hash<std::thread::id> 값입니다.
+			size_t thread;
+			long long start;
+			long long wall_time;
+			// 아래 단계는 이 순서대로 이어서 실행됩니다. 이 리더는 압축된 테이블을 읽지 않으므로 decompress_time 은 항상 0 입니다.
+			long long read_time;
+			long long decompress_time;
+			long long strings_time;
+			long long columns_time;
+			long long rows_time;
+			long long index_time;
+			size_t bytes_read;
+			size_t raw_bytes;
+			size_t rows;
+			size_t columns;
+			size_t strings;
+			// iload_listener::allocation_count 로 잰 값이며, 잴 수 없으면 -1 입니다.
+			long long allocations;
+		};
+
+		struct inidataset_stats
+		{
+			inidataset_stats();
+
+			std::string name;
+			size_t thread;
+			long long start;
+			long long wall_time;
+			long long header_time;
+			long long string_resources_time;
+			// 지연 읽기가 아닐 때 모든 테이블을 읽는데 걸린 시간입니다.
+			long long tables_time;
+			// 헤더와 테이블 목록, 파일 문자열을 읽은 크기입니다.
+			size_t bytes_read;
+			size_t table_count;
+			size_t strings;
+		};
+
+		struct iniload_stats
+		{
+			std::vector<inidataset_stats> datasets;
+			std::vector<initable_stats> tables;
+
+			// 같은 이름이 여러번 읽혔으면 마지막 것을 돌려줍니다.
+			const initable_stats* find(const std::string& tableName) const;
+			// wall_time 이 긴 순서로 count 개까지 돌려줍니다.
+			std::vector<const initable_stats*> slowest(size_t count) const;
+			long long total_wall_time() const;
+			size_t total_bytes_read() const;
+		};
+
+		// CremaReader::set_load_listener 로 등록하면 읽기 단계가 끝날 때마다 호출됩니다.
+		class iload_listener
+		{
+		public:
+			virtual void dataset_loaded(const inidataset_stats& stats) = 0;
+			virtual void table_loaded(const initable_stats& stats) = 0;
+
+			// 호출한 스레드에서 지금까지 일어난 할당 횟수입니다. 테이블 하나를 읽기 전과 후의 차이가 allocations 가 됩니다.
+			virtual long long allocation_count() { return -1; }
+
+		protected:
+			iload_listener() {};
+			virtual ~iload_listener() {};
+		};
+
+		// 받은 통계를 모아 두고 조회하거나 Chrome trace event 형식(chrome://tracing, Perfetto)으로 내보냅니다.
+		class iniload_trace : public iload_listener
+		{
+		public:
+			iniload_trace();
+			virtual ~iniload_trace();
+
+			virtual void dataset_loaded(const inidataset_stats& stats);
+			virtual void table_loaded(const initable_stats& stats);
+
+			iniload_stats stats() const;
+			void clear();
+
+			void write_chrome_trace(std::ostream& stream) const;
+			void write_chrome_trace(const std::string& filename) const;
+
+		private:
+			mutable std::mutex m_lock;
+			iniload_stats m_stats;
+		};
+
 		class CremaReader : public idataset
 		{
 		public:
@@ -424,6 +522,10 @@ namespace CremaCode {
 				return read(filename, flag);
 			}
 
+			// 등록한 listener 는 그것을 쓰는 모든 리더보다 오래 살아야 합니다. 지연 읽기에서는 테이블을 처음 읽을 때도 호출됩니다.
+			static void set_load_listener(iload_listener* listener);
+			static iload_listener* load_listener();
+
 			virtual void destroy() = 0;
 
 			//virtual const itable_array& tables() const = 0;
@@ -510,71 +612,28 @@ namespace CremaCode {
 			static std::string utf8_to_string(const char* text);
 			static std::wstring string_to_wstring(const std::string& text);
 			static const std::type_info& name_to_type(const std::string& typeName);
+			// 문자열을 UTF-16 으로 보았을 때의 .NET 해시 값입니다. 메모리를 할당하거나 로캘을 바꾸지 않습니다.
 			static int get_hash_code(const std::string& text);
+			static int get_hash_code(const char* text);
+			static int get_hash_code(const char* text, size_t length);
 			static std::string to_lower(const std::string& text);
 
 			//static int get_type_size(const std::type_info& typeinfo);
 
-			template<typename key_type>
-			static long generate_hash(key_type key_value)
-			{
-				size_t size = keys_size(1, &typeid(key_type));
-				return generate_hash_core(1, size, &typeid(key_type), key_value);
-			}
-
-			template<typename key_type1, typename key_type2>
-			static long generate_hash(key_type1 key_value1, key_type2 key_value2)
-			{
-				size_t size = keys_size(2, &typeid(key_type1), &typeid(key_type2));
-				return generate_hash_core(2, size,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2);
-			}
-
-			template<typename key_type1, typename key_type2, typename key_type3>
-			static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3)
-			{
-				size_t size = keys_size(3, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3));
-				return generate_hash_core(3, size,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2,
-					&typeid(key_type3), key_value3);
-			}
+			static const unsigned long long default_hash_seed = 0x43524d4152454144ULL;
+			static unsigned long long hash(const void* data, size_t length);
+			static unsigned long long hash(const void* data, size_t length, unsigned long long seed);
 
-			template<typename key_type1, typename key_type2, typename key_type3, typename key_type4>
-			static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4)
+			template<typename... key_types>
+			static unsigned long long generate_hash(const key_types&... key_values)
 			{
-				size_t size = keys_size(4, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3), &typeid(key_type4));
-				return generate_hash_core(4, size,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2,
-					&typeid(key_type3), key_value3,
-					&typeid(key_type4), key_value4);
-			}
-
-			template<typename key_type1, typename key_type2, typename key_type3, typename key_type4, typename key_type5>
-			static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4, key_type5 key_value5)
-			{
-				size_t size = keys_size(5, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3), &typeid(key_type4), &typeid(key_type5));
-				return generate_hash_core(5, size,
-					&typeid(key_type1), key_value1,
-					&typeid(key_type2), key_value2,
-					&typeid(key_type3), key_value3,
-					&typeid(key_type4), key_value4,
-					&typeid(key_type5), key_value5);
+				const inikey_value keys[] = { inikey_value(key_values)... };
+				return generate_hash_core(keys, sizeof...(key_types));
 			}
 
 		private:
-			static long generate_hash_core(size_t count, size_t keysize, ...);
-			static size_t keys_size(size_t count, ...);
-
-			template<typename _type>
-			static void set_field_value(const char* buffer, size_t& offset, _type value)
-			{
-				_type* value_ptr = (_type*)(buffer + offset);
-				*value_ptr = value;
-				offset += sizeof(_type);
-			}
+			// 키 값을 타입별로 long long 하나씩 채운 뒤 해시합니다. 키가 8개 이하이면 메모리를 할당하지 않습니다.
+			static unsigned long long generate_hash_core(const inikey_value* keys, size_t count);
 		};
 
 		namespace internal {
@@ -585,37 +644,40 @@ namespace CremaCode {
 				internal_util();
 				~internal_util();
 
-				template<typename _type>
-				static void set_field_value(const char* buffer, size_t& offset, _type value)
-				{
-					_type* value_ptr = (_type*)(buffer + offset);
-					*value_ptr = value;
-					offset += sizeof(_type);
-				}
-
 				std::list<CremaReader*> m_readers;
+				std::mutex m_lock;
 			};
 
 			class string_resource
 			{
 			public:
-				static void read(std::istream& stream);
-				static const std::string& get(int id);
+				static std::string empty_string;
+				static std::string invalid_type;
+			};
 
-				static const std::string& getByPtr(const char* ptr);
-				static void add(const char* ptr, std::string text);
-				static bool contains(const char* ptr);
+			// 리더와 테이블이 각자 가지는 문자열 목록입니다. 값은 한 배열에 모아 두고 아이디로 정렬한 색인으로 찾습니다.
+			class string_pool
+			{
+			public:
+				void read(std::istream& stream);
+				const std::string& get(int id) const;
+				size_t size() const;
 
-				static void add_ref();
-				static void remove_ref();
+			private:
+				void add(int id, const char* text, size_t length);
+				void build_index();
 
-			public:
-				static std::string empty_string;
-				static std::string invalid_type;
 			private:
-				static std::map<int, std::string> m_strings;
-				static std::map<const char*, std::string> m_stringsByPtr;
-				static int m_ref;
+				struct entry
+				{
+					int id;
+					unsigned int index;
+
+					bool operator < (const entry& other) const { return id < other.id; }
+				};
+
+				std::vector<entry> m_entries;
+				std::vector<std::string> m_values;
 			};
 
 			namespace binary
@@ -714,18 +776,18 @@ namespace CremaCode {
 					virtual bool has_value_core(const inicolumn& column) const;
 					virtual void set_value(const std::string& columnName, const std::string& text);
 					virtual itable& table() const;
-					virtual long hash() const;
+					virtual unsigned long long hash() const;
+					virtual const char* fields() const;
 
-					void reserve_fields_ptr(size_t size);
-					char* fields_ptr();
+					void set_fields(const char* fields);
 					void set_table(binary_table& table);
-					void set_hash(long hash);
-					bool equals_key(va_list& vl);
+					void set_hash(unsigned long long hash);
+					const char* field_ptr(size_t index) const;
 
 				private:
-					std::vector<char> m_fields;
+					const char* m_fields;
 					binary_table* m_table;
-					long m_hash;
+					unsigned long long m_hash;
 				};
 
 				class binary_column_array : public icolumn_array
@@ -766,6 +828,36 @@ namespace CremaCode {
 					std::vector<binary_column*> m_columns;
 				};
 
+				class binary_key_index
+				{
+				public:
+					static const size_t npos = (size_t)-1;
+
+					binary_key_index();
+
+					void reserve(size_t count);
+					void insert(unsigned long long hash, size_t index);
+
+					size_t find_first(unsigned long long hash) const;
+					size_t find_next(unsigned long long hash, size_t slot) const;
+					size_t index(size_t slot) const { return m_slots[slot].index; }
+
+				private:
+					size_t bucket(unsigned long long hash) const;
+
+					struct slot
+					{
+						unsigned long long hash;
+						unsigned int index;
+					};
+
+					static const unsigned int empty_index = 0xffffffff;
+
+				private:
+					std::vector<slot> m_slots;
+					size_t m_mask;
+				};
+
 				class binary_row_array : public irow_array
 				{
 				public:
@@ -776,25 +868,49 @@ namespace CremaCode {
 					virtual binary_row& at(size_t index) const;
 
 					binary_row& at(size_t index);
+					char* reserve_arena(size_t size);
 					void generate_key(size_t index);
+					void generate_keys();
 					void set_table(binary_table& table);
 					binary_table& table() const;
 
-					iterator find_core(size_t count, ...);
+					iterator find_core(const inikey_value* keys, size_t count);
 
 				private:
-					size_t keys_size() const;
-					template<typename _type>
-					void set_field_value(const char* buffer, size_t& offset, _type value)
+					enum key_type
 					{
-						_type* value_ptr = (_type*)(buffer + offset);
-						*value_ptr = value;
-						offset += sizeof(_type);
-					}
+						key_type_boolean,
+						key_type_int8,
+						key_type_uint8,
+						key_type_int16,
+						key_type_uint16,
+						key_type_int32,
+						key_type_uint32,
+						key_type_int64,
+						key_type_uint64,
+						key_type_float,
+						key_type_double,
+						key_type_string,
+					};
+
+					struct key_field
+					{
+						size_t column;
+						key_type type;
+					};
+
+					void prepare_keys();
+					const std::string& key_text(const key_field& field, const binary_row& row) const;
+					long long pack_field(const key_field& field, const binary_row& row) const;
+					long long pack_field(const key_field& field, const inikey_value& key) const;
+					bool equals_key(const binary_row& row, const inikey_value* keys) const;
+					unsigned long long hash_fields(const long long* fields, size_t count) const;
 
 				private:
 					std::vector<binary_row> m_rows;
-					std::multimap<long, binary_row*> m_keyTorow;
+					std::vector<char> m_arena;
+					std::vector<key_field> m_keyFields;
+					binary_key_index m_keyToIndex;
 					binary_table* m_table;
 				};
 
@@ -817,6 +933,9 @@ namespace CremaCode {
 
 					virtual idataset& dataset() const;
 
+					const string_pool& strings() const { return m_strings; }
+					const std::string& guid_string(const char* ptr) const;
+
 					binary_key_array m_keys;
 					binary_column_array m_columns;
 					binary_row_array m_rows;
@@ -827,6 +946,10 @@ namespace CremaCode {
 					size_t m_index;
 					std::string m_hashValue;
 					binary_reader* m_reader;
+					string_pool m_strings;
+					// guid 문자열은 16 바이트 값을 키로 처음 읽을 때 만듭니다.
+					mutable std::map<std::string, std::string> m_guids;
+					mutable std::mutex m_guidLock;
 
 					friend class binary_reader;
 				};
@@ -838,26 +961,32 @@ namespace CremaCode {
 					virtual ~binary_table_array();
 
 					virtual size_t size() const;
-					virtual itable& at(size_t index) const throw();
-					virtual itable& at(const std::string& tableName) const throw();
+					virtual itable& at(size_t index) const;
+					virtual itable& at(const std::string& tableName) const;
 					virtual bool contains(const std::string& tableName) const;
 					virtual const itableNameArray& names() const;
 					virtual bool is_table_loaded(const std::string& tableName) const;
 					virtual void load_table(const std::string& tableName);
 					virtual void release_table(const std::string& tableName);
+					virtual size_t reclaim_tables();
 
 					void set(size_t index, binary_table* dataTable);
-					void set_size(const std::vector<table_index>& indexes);
+					size_t index_of(const std::string& tableName) const;
+					void set_size(const std::vector<table_index>& indexes, const string_pool& strings);
 					void set_flag(ReadFlag flag);
 
 					binary_table_array& operator=(const binary_table_array&) { return *this; }
 
 				private:
 					std::string conv_string(const std::string& text) const;
+					binary_table* load(size_t index);
+					void retire(binary_table* table);
 
 				private:
-					std::map<std::string, binary_table*> m_nameToTable;
-					std::vector<binary_table*> m_tables;
+					std::map<std::string, size_t> m_nameToIndex;
+					std::vector<std::atomic<binary_table*> > m_tables;
+					std::vector<binary_table*> m_retiredTables;
+					std::mutex m_retiredLock;
 					itableNameArray m_tableNames;
 					binary_reader& m_reader;
 					bool m_caseSensitive;
@@ -872,7 +1001,7 @@ namespace CremaCode {
 					virtual void read_core(std::istream& stream, ReadFlag flag);
 					virtual void destroy();
 
-					binary_table* read_table(const std::string& tableName);
+					// 여러 스레드에서 동시에 불러도 됩니다. 스트림은 테이블 블럭을 읽는 동안만 잠급니다.
 					binary_table* read_table(size_t index);
 
 					virtual const itable_array& tables() const { return m_tables; }
@@ -885,23 +1014,17 @@ namespace CremaCode {
 					binary_table_array m_tables;
 
 				private:
-					binary_table * read_table(std::istream& stream, std::streamoff offset, ReadFlag flag);
+					binary_table * read_table(std::istream& stream, std::streamoff offset, ReadFlag flag, size_t index);
+					void read_block(std::streamoff offset, std::vector<char>& buffer);
 					void read_columns(std::istream& stream, binary_table& dataTable, size_t columnCount, ReadFlag flag);
-					void read_rows(std::istream& stream, binary_table& dataTable, size_t rowCount);
-
-					class findif
-					{
-					public:
-						findif(ReadFlag flag, const std::string& tableName) : m_tableName(tableName), m_flag(flag) {}
-						bool operator() (const table_index& index);
-					private:
-						std::string m_tableName;
-						ReadFlag m_flag;
-					};
+					void read_rows(std::istream& stream, binary_table& dataTable, size_t rowCount, size_t length);
+					static long long now();
 
 				private:
 					std::istream* m_stream;
+					std::mutex m_streamLock;
 					std::vector<table_index> m_tableIndexes;
+					string_pool m_strings;
 					ReadFlag m_flag;
 					std::string m_name;
 					std::string m_revision;
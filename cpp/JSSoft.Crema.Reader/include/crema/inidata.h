@@ -4,10 +4,8 @@
 #include <typeinfo>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 #include "iniexception.h"
-#ifdef _MSC_VER
-#include <type_traits>
-#endif
 
 
 namespace CremaReader
@@ -22,7 +20,7 @@ namespace CremaReader
 		cremaiterator(_inicontainer* c, size_t i) : i(i), c(c) { }
 		cremaiterator(const cremaiterator& mit) : i(mit.i), c(mit.c) { }
 
-		cremaiterator& operator++() { i = std::min(c->size(), ++i); return *this; }
+		cremaiterator& operator++() { i = std::min(c->size(), i + 1); return *this; }
 		cremaiterator operator++(int) { cremaiterator tmp(*this); operator++(); return tmp; }
 		bool operator==(const cremaiterator& rhs) { return i == rhs.i; }
 		bool operator!=(const cremaiterator& rhs) { return i != rhs.i; }
@@ -42,7 +40,7 @@ namespace CremaReader
 		const_cremaiterator(const _inicontainer* c, size_t i) : i(i), c(c) { }
 		const_cremaiterator(const const_cremaiterator& mit) : i(mit.i), c(mit.c) { }
 
-		const_cremaiterator& operator++() { i = std::min(c->size(), ++i); return *this; }
+		const_cremaiterator& operator++() { i = std::min(c->size(), i + 1); return *this; }
 		const_cremaiterator operator++(int) { const_cremaiterator tmp(*this); operator++(); return tmp; }
 		bool operator==(const const_cremaiterator& rhs) { return i == rhs.i; }
 		bool operator!=(const const_cremaiterator& rhs) { return i != rhs.i; }
@@ -83,7 +81,8 @@ namespace CremaReader
 
 		virtual void set_value(const std::string& columnName, const std::string& text) = 0;
 		virtual itable& table() const = 0;
-		virtual long hash() const = 0;
+		virtual unsigned long long hash() const = 0;
+		virtual const char* fields() const = 0;
 
 		template<typename T>
 		const T& value(const std::string& columnName) const;
@@ -202,6 +201,53 @@ namespace CremaReader
 		const_iterator end() const { return const_iterator(this); }
 	};
 
+	class DLL_EXPORT inikey_value
+	{
+	public:
+		enum value_type
+		{
+			value_type_integer,
+			value_type_unsigned,
+			value_type_real,
+			value_type_string,
+		};
+
+		inikey_value(bool value) : m_type(value_type_integer), m_length(0) { m_integer = value ? 1 : 0; }
+		inikey_value(char value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(signed char value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(unsigned char value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+		inikey_value(short value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(unsigned short value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+		inikey_value(int value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(unsigned int value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+		inikey_value(long value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(unsigned long value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+		inikey_value(long long value) : m_type(value_type_integer), m_length(0) { m_integer = value; }
+		inikey_value(unsigned long long value) : m_type(value_type_unsigned), m_length(0) { m_unsigned = value; }
+		inikey_value(float value) : m_type(value_type_real), m_length(0) { m_real = value; }
+		inikey_value(double value) : m_type(value_type_real), m_length(0) { m_real = value; }
+		inikey_value(const char* value) : m_type(value_type_string), m_length(strlen(value)) { m_text = value; }
+		inikey_value(const std::string& value) : m_type(value_type_string), m_length(value.length()) { m_text = value.c_str(); }
+
+		value_type type() const { return m_type; }
+		long long to_integer() const { return m_type == value_type_real ? (long long)m_real : m_integer; }
+		unsigned long long to_unsigned() const { return m_type == value_type_real ? (unsigned long long)m_real : m_unsigned; }
+		double to_real() const { return m_type == value_type_real ? m_real : m_type == value_type_unsigned ? (double)m_unsigned : (double)m_integer; }
+		const char* text() const { return m_text; }
+		size_t length() const { return m_length; }
+
+	private:
+		value_type m_type;
+		union
+		{
+			long long m_integer;
+			unsigned long long m_unsigned;
+			double m_real;
+			const char* m_text;
+		};
+		size_t m_length;
+	};
+
 	class DLL_EXPORT irow_array abstract
 	{
 	public:
@@ -221,74 +267,81 @@ namespace CremaReader
 		const_iterator begin() const { return const_iterator(this, 0); }
 		const_iterator end() const { return const_iterator(this); }
 
-		template<typename key_type>
-		iterator find(key_type key_value)
+		template<typename... key_types>
+		iterator find(const key_types&... key_values)
 		{
-			this->type_validation<key_type>();
-			return this->find_core(1, &typeid(key_type), key_value);
+			const inikey_value keys[] = { inikey_value(key_values)... };
+			return this->find_core(keys, sizeof...(key_types));
 		}
 
-		template<typename key_type1, typename key_type2>
-		iterator find(key_type1 key_value1, key_type2 key_value2)
-		{
-			this->type_validation<key_type1>();
-			this->type_validation<key_type2>();
-			return this->find_core(2,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2);
-		}
+	protected:
+		virtual iterator find_core(const inikey_value* keys, size_t count) = 0;
+	};
 
-		template<typename key_type1, typename key_type2, typename key_type3>
-		iterator find(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3)
-		{
-			this->type_validation<key_type1>();
-			this->type_validation<key_type2>();
-			this->type_validation<key_type3>();
-			return this->find_core(3,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2,
-				&typeid(key_type3), key_value3);
-		}
+	class DLL_EXPORT icolumn_data abstract
+	{
+	public:
+		virtual const inicolumn& column() const = 0;
+		virtual size_t size() const = 0;
+		virtual const void* data() const = 0;
+		virtual const unsigned long long* null_bitmap() const = 0;
 
-		template<typename key_type1, typename key_type2, typename key_type3, typename key_type4>
-		iterator find(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4)
-		{
-			this->type_validation<key_type1>();
-			this->type_validation<key_type2>();
-			this->type_validation<key_type3>();
-			this->type_validation<key_type4>();
-			return this->find_core(4,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2,
-				&typeid(key_type3), key_value3,
-				&typeid(key_type4), key_value4);
-		}
+		bool has_value(size_t index) const { return ((this->null_bitmap()[index >> 6] >> (index & 63)) & 1) != 0; }
+
+		template<typename T>
+		const T* values() const;
+		const std::string* const* strings() const;
 
 	protected:
-		virtual iterator find_core(size_t count, ...) = 0;
+		icolumn_data() {};
+		virtual ~icolumn_data() {};
+	};
 
-	private:
-		template<typename type>
-		void type_validation()
+	class DLL_EXPORT inipredicate
+	{
+	public:
+		enum op_type
 		{
-#ifdef _MSC_VER
-			bool value = std::is_integral<type>::value ||
-				std::is_floating_point<type>::value ||
-				typeid(type) == typeid(const char*) ||
-				typeid(type) == typeid(char*) ||
-				typeid(type) == typeid(std::string) ||
-				typeid(type) == typeid(const std::string);
-			if (value == false)
-			{
-				std::ostringstream stream;
-				const char* werewr = typeid(type).name();
-				stream << typeid(type).name() << "은(는) 올바른 타입이 아닙니다.";
-				throw std::invalid_argument(stream.str());
-			}
-#endif
-		}
+			op_equal,
+			op_not_equal,
+			op_less,
+			op_less_equal,
+			op_greater,
+			op_greater_equal,
+			op_between,
+			op_in,
+			op_is_null,
+			op_is_not_null,
+		};
+
+		inipredicate(const inicolumn& column, op_type op);
+		inipredicate(const inicolumn& column, op_type op, const inikey_value& value);
+		inipredicate(const inicolumn& column, op_type op, const inikey_value& low, const inikey_value& high);
+		inipredicate(const inicolumn& column, op_type op, const inikey_value* values, size_t count);
+
+		static inipredicate equal(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_equal, value); }
+		static inipredicate not_equal(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_not_equal, value); }
+		static inipredicate less(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_less, value); }
+		static inipredicate less_equal(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_less_equal, value); }
+		static inipredicate greater(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_greater, value); }
+		static inipredicate greater_equal(const inicolumn& column, const inikey_value& value) { return inipredicate(column, op_greater_equal, value); }
+		static inipredicate between(const inicolumn& column, const inikey_value& low, const inikey_value& high) { return inipredicate(column, op_between, low, high); }
+		static inipredicate in(const inicolumn& column, const inikey_value* values, size_t count) { return inipredicate(column, op_in, values, count); }
+		static inipredicate is_null(const inicolumn& column) { return inipredicate(column, op_is_null); }
+		static inipredicate is_not_null(const inicolumn& column) { return inipredicate(column, op_is_not_null); }
+
+		const inicolumn& column() const { return *m_column; }
+		op_type op() const { return m_op; }
+		const std::vector<inikey_value>& values() const { return m_values; }
+
+	private:
+		const inicolumn* m_column;
+		op_type m_op;
+		std::vector<inikey_value> m_values;
 	};
 
+	typedef std::vector<size_t> iniselection;
+
 	class DLL_EXPORT itable abstract
 	{
 	public:
@@ -301,6 +354,13 @@ namespace CremaReader
 		virtual const icolumn_array& columns() const = 0;
 		virtual const irow_array& rows() const = 0;
 
+		virtual const icolumn_data& column_data(const inicolumn& column) const = 0;
+		const icolumn_data& column_data(const std::string& columnName) const;
+		const icolumn_data& column_data(size_t index) const;
+
+		iniselection select(const inipredicate& predicate) const;
+		iniselection select(const inipredicate* predicates, size_t count) const;
+
 		virtual idataset& dataset() const = 0;
 
 	protected:
@@ -321,13 +381,18 @@ namespace CremaReader
 		virtual ~itable_array() {};
 
 		virtual size_t size() const = 0;
-		virtual itable& at(size_t index) const throw() = 0;
-		virtual itable& at(const std::string& tableName) const throw() = 0;
+		virtual itable& at(size_t index) const = 0;
+		virtual itable& at(const std::string& tableName) const = 0;
 		virtual bool contains(const std::string& tableName) const = 0;
 		virtual const itableNameArray& names() const = 0;
 		virtual bool is_table_loaded(const std::string& tableName) const = 0;
 		virtual void load_table(const std::string& tableName) = 0;
+		// 테이블을 바로 해제하지 않고 보관합니다. 이전에 얻은 itable, irow 참조는 reclaim_tables 가 불릴 때까지 유효합니다.
+		// CremaReader::update 로 받은 테이블은 다시 읽을 곳이 없으므로 내리지 않습니다.
 		virtual void release_table(const std::string& tableName) = 0;
+		// release_table 로 보관한 테이블을 해제하고 해제한 개수를 반환합니다.
+		// 호출하는 쪽에서 보관된 테이블을 참조하는 스레드가 없음을 보장해야 합니다.
+		virtual size_t reclaim_tables() = 0;
 
 		itable& operator [] (const std::string& tableName) const;
 		itable& operator [] (size_t index) const;
@@ -362,4 +427,18 @@ namespace CremaReader
 		}
 		return *(T*)this->value_core(column);
 	}
+
+	template<typename T>
+	const T* icolumn_data::values() const
+	{
+		const inicolumn& column = this->column();
+		if (column.datatype() != typeid(T))
+		{
+			std::ostringstream stream;
+			stream << column.datatype().name() << " 에서 " << typeid(T).name() << " 으로 변환할 수 없습니다. ";
+
+			throw std::invalid_argument(stream.str());
+		}
+		return (const T*)this->data();
+	}
 } /*namespace CremaReader*/
@@ -1,7 +1,10 @@
 ﻿#pragma once
 
 #define _CREMA_READER_VER 209
+// _USE_BOOST 를 정의하고 빌드하면 boost.asio 로 된 원격 읽기(read, read_async, update)를 씁니다.
+#ifndef _USE_BOOST
 #define _IGNORE_BOOST
+#endif
 
 #ifdef _MSC_VER
 #ifdef _WINDLL
@@ -16,8 +19,12 @@
 #else
 #define DLL_EXPORT 
 #define abstract
+#if __cplusplus < 201103L
 #define nullptr NULL
+#endif
+#ifndef _USE_BOOST
 #define _IGNORE_BOOST
+#endif
 
 #include <string>
 namespace std
@@ -1,10 +1,25 @@
 ﻿#pragma once
 #include "inidata.h"
 #include "initype.h"
+#include "initrace.h"
 #include <vector>
+#ifndef _IGNORE_BOOST
+#include <exception>
+#include <future>
+#include <boost/asio/io_service.hpp>
+#include <boost/function.hpp>
+#include <boost/system/error_code.hpp>
+#endif
 
 namespace CremaReader
 {
+#ifndef _IGNORE_BOOST
+	namespace internal
+	{
+		class socket_loader;
+	} /*namespace internal*/
+#endif
+
 	class DLL_EXPORT idataset abstract
 	{
 	public:
@@ -22,6 +37,12 @@ namespace CremaReader
 #ifndef _IGNORE_BOOST
 		//static CremaReader& read(const std::string& address, int port, const std::string& name = "default", ReadFlag flag = ReadFlag_none);
 		static CremaReader& read(const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag = ReadFlag_none);
+
+		typedef boost::function<void (CremaReader* reader, std::exception_ptr error)> read_handler;
+		// 받기와 받은 데이터 읽기, handler 호출을 모두 io_service 에서 합니다. 읽는 동안 다른 작업도 돌리려면 io_service::run 을 여러 스레드에서 부르세요.
+		// io_service 는 handler 가 불릴 때까지 살아 있어야 합니다.
+		static void read_async(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag, const read_handler& handler);
+		static std::future<CremaReader*> read_async(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag = ReadFlag_none);
 #endif
 		static CremaReader& read(const std::string& filename, ReadFlag flag = ReadFlag_none);
 		static CremaReader& read(std::istream& stream, ReadFlag flag = ReadFlag_none);
@@ -31,7 +52,28 @@ namespace CremaReader
 			return read(filename, flag);
 		}
 
+		static void set_thread_count(size_t count);
+		static size_t thread_count();
+		// 등록한 listener 는 그것을 쓰는 모든 리더보다 오래 살아야 합니다. 지연 읽기에서는 테이블을 처음 읽을 때도 호출됩니다.
+		static void set_load_listener(iload_listener* listener);
+		static iload_listener* load_listener();
+#ifndef _IGNORE_BOOST
+		// 리더는 만들어질 때의 경로를 쓰므로, 바꾸면 그 뒤에 시작한 읽기부터 반영됩니다.
+		static void set_cache_directory(const std::string& path);
+		static std::string cache_directory();
+#endif
+
 		virtual void destroy() = 0;
+		// update 와 release_table 로 보관해 둔 이전 테이블과 revision(), tables_hash_value() 문자열을 해제하고 해제한 테이블 수를 반환합니다.
+		// 호출하는 쪽에서 보관된 것을 참조하는 스레드가 없음을 보장해야 합니다.
+		virtual size_t reclaim() = 0;
+
+#ifndef _IGNORE_BOOST
+		// 서버와 테이블 해시를 비교해 바뀐 테이블만 받아 교체하고 교체한 테이블 수를 반환합니다.
+		// 지연 읽기에서 아직 읽지 않은 테이블도 이때 받으므로 update 뒤에는 모든 테이블이 새 리비전입니다.
+		// 이전 테이블과 리비전 문자열은 reclaim 을 부를 때까지 유효합니다. 실패하면 예외를 던지고 아무것도 바꾸지 않습니다.
+		size_t update(const std::string& address, int port, const std::string& database, DataLocation datalocation);
+#endif
 
 		//virtual const itable_array& tables() const = 0;
 
@@ -40,6 +82,16 @@ namespace CremaReader
 		virtual ~CremaReader();
 		CremaReader& operator=(const CremaReader&) { return *this; }
 		virtual void read_core(std::istream& stream, ReadFlag flag) = 0;
+#ifndef _IGNORE_BOOST
+		virtual size_t update_core(const std::string& address, int port, const std::string& name) = 0;
+#endif
+
+	private:
+#ifndef _IGNORE_BOOST
+		static CremaReader& read(const std::string& address, int port, const std::string& name, ReadFlag flag);
+		static std::string connection_name(const std::string& database, DataLocation datalocation);
+		static void read_completed(boost::shared_ptr<internal::socket_loader> loader, ReadFlag flag, read_handler handler, const boost::system::error_code& error);
+#endif
 
 	private:
 		std::istream* m_stream;
@@ -0,0 +1,106 @@
+﻿#pragma once
+#include "inidefine.h"
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CremaReader
+{
+	// 시간은 모두 std::chrono::steady_clock 기준 나노초입니다.
+	struct DLL_EXPORT initable_stats
+	{
+		initable_stats();
+
+		std::string name;
+		size_t index;
+		// 테이블을 읽은 스레드의 std::hash<std::thread::id> 값입니다.
+		size_t thread;
+		long long start;
+		long long wall_time;
+		// 아래 단계는 이 순서대로 이어서 실행됩니다.
+		long long read_time;
+		long long decompress_time;
+		long long strings_time;
+		long long columns_time;
+		long long rows_time;
+		long long index_time;
+		// 파일에서 읽은 크기입니다. 압축된 테이블이면 압축된 크기입니다.
+		size_t bytes_read;
+		size_t raw_bytes;
+		size_t rows;
+		size_t columns;
+		size_t strings;
+		// iload_listener::allocation_count 로 잰 값이며, 잴 수 없으면 -1 입니다.
+		long long allocations;
+	};
+
+	struct DLL_EXPORT inidataset_stats
+	{
+		inidataset_stats();
+
+		std::string name;
+		size_t thread;
+		long long start;
+		long long wall_time;
+		long long header_time;
+		long long string_resources_time;
+		// 지연 읽기가 아닐 때 모든 테이블을 읽는데 걸린 시간입니다.
+		long long tables_time;
+		// 헤더와 테이블 목록, 파일 문자열을 읽은 크기입니다.
+		size_t bytes_read;
+		size_t table_count;
+		size_t strings;
+	};
+
+	struct DLL_EXPORT iniload_stats
+	{
+		std::vector<inidataset_stats> datasets;
+		std::vector<initable_stats> tables;
+
+		// 같은 이름이 여러번 읽혔으면 마지막 것을 돌려줍니다.
+		const initable_stats* find(const std::string& tableName) const;
+		// wall_time 이 긴 순서로 count 개까지 돌려줍니다.
+		std::vector<const initable_stats*> slowest(size_t count) const;
+		long long total_wall_time() const;
+		size_t total_bytes_read() const;
+	};
+
+	// CremaReader::set_load_listener 로 등록하면 읽기 단계가 끝날 때마다 호출됩니다.
+	// 병렬 읽기에서는 여러 스레드에서 동시에 호출될 수 있습니다.
+	class DLL_EXPORT iload_listener abstract
+	{
+	public:
+		virtual void dataset_loaded(const inidataset_stats& stats) = 0;
+		virtual void table_loaded(const initable_stats& stats) = 0;
+
+		// 호출한 스레드에서 지금까지 일어난 할당 횟수입니다. 테이블 하나를 읽기 전과 후의 차이가 allocations 가 됩니다.
+		// 라이브러리는 operator new 를 바꾸지 않으므로 기본값은 -1(재지 않음)입니다.
+		virtual long long allocation_count() { return -1; }
+
+	protected:
+		iload_listener() {};
+		virtual ~iload_listener() {};
+	};
+
+	// 받은 통계를 모아 두고 조회하거나 Chrome trace event 형식(chrome://tracing, Perfetto)으로 내보냅니다.
+	class DLL_EXPORT iniload_trace : public iload_listener
+	{
+	public:
+		iniload_trace();
+		virtual ~iniload_trace();
+
+		virtual void dataset_loaded(const inidataset_stats& stats);
+		virtual void table_loaded(const initable_stats& stats);
+
+		iniload_stats stats() const;
+		void clear();
+
+		void write_chrome_trace(std::ostream& stream) const;
+		void write_chrome_trace(const std::string& filename) const;
+
+	private:
+		mutable std::mutex m_lock;
+		iniload_stats m_stats;
+	};
+} /*namespace CremaReader*/
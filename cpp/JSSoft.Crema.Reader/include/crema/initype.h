@@ -7,6 +7,8 @@ namespace CremaReader
 		ReadFlag_none = 0,
 		ReadFlag_lazy_loading = 1,
 		ReadFlag_case_sensitive = 2,
+		ReadFlag_memory_mapped = 4,
+		ReadFlag_parallel_loading = 8,
 
 		ReadFlag_mask = 0xff,
 	};
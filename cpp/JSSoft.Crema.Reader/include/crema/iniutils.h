@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "inidefine.h"
+#include "inidata.h"
 #include <vector>
 #include <map>
 #include <string>
@@ -80,70 +81,27 @@ namespace CremaReader
 		static std::string utf8_to_string(const char* text);
 		static std::wstring string_to_wstring(const std::string& text);
 		static const std::type_info& name_to_type(const std::string& typeName);
+		// 문자열을 UTF-16 으로 보았을 때의 .NET 해시 값입니다. 메모리를 할당하거나 로캘을 바꾸지 않습니다.
 		static int get_hash_code(const std::string& text);
+		static int get_hash_code(const char* text);
+		static int get_hash_code(const char* text, size_t length);
 		static std::string to_lower(const std::string& text);
 
 		static int get_type_size(const std::type_info& typeinfo);
 
-		template<typename key_type>
-		static long generate_hash(key_type key_value)
-		{
-			size_t size = keys_size(1, &typeid(key_type));
-			return generate_hash_core(1, size, &typeid(key_type), key_value);
-		}
-
-		template<typename key_type1, typename key_type2>
-		static long generate_hash(key_type1 key_value1, key_type2 key_value2)
-		{
-			size_t size = keys_size(2, &typeid(key_type1), &typeid(key_type2));
-			return generate_hash_core(2, size,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2);
-		}
-
-		template<typename key_type1, typename key_type2, typename key_type3>
-		static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3)
-		{
-			size_t size = keys_size(3, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3));
-			return generate_hash_core(3, size,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2,
-				&typeid(key_type3), key_value3);
-		}
-
-		template<typename key_type1, typename key_type2, typename key_type3, typename key_type4>
-		static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4)
-		{
-			size_t size = keys_size(4, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3), &typeid(key_type4));
-			return generate_hash_core(4, size,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2,
-				&typeid(key_type3), key_value3,
-				&typeid(key_type4), key_value4);
-		}
+		static const unsigned long long default_hash_seed = 0x43524d4152454144ULL;
+		static unsigned long long hash(const void* data, size_t length);
+		static unsigned long long hash(const void* data, size_t length, unsigned long long seed);
 
-		template<typename key_type1, typename key_type2, typename key_type3, typename key_type4, typename key_type5>
-		static long generate_hash(key_type1 key_value1, key_type2 key_value2, key_type3 key_value3, key_type4 key_value4, key_type5 key_value5)
+		template<typename... key_types>
+		static unsigned long long generate_hash(const key_types&... key_values)
 		{
-			size_t size = keys_size(5, &typeid(key_type1), &typeid(key_type2), &typeid(key_type3), &typeid(key_type4), &typeid(key_type5));
-			return generate_hash_core(5, size,
-				&typeid(key_type1), key_value1,
-				&typeid(key_type2), key_value2,
-				&typeid(key_type3), key_value3,
-				&typeid(key_type4), key_value4,
-				&typeid(key_type5), key_value5);
+			const inikey_value keys[] = { inikey_value(key_values)... };
+			return generate_hash_core(keys, sizeof...(key_types));
 		}
 
 	private:
-		static long generate_hash_core(size_t count, size_t keysize, ...);
-		static size_t keys_size(size_t count, ...);
-
-		template<typename _type>
-		static void set_field_value(const char* buffer, size_t& offset, _type value)
-		{
-			_type* value_ptr = (_type*)(buffer + offset);
-			*value_ptr = value;
-			offset += sizeof(_type);
-		}
+		// 키 값을 타입별로 long long 하나씩 채운 뒤 해시합니다. 키가 8개 이하이면 메모리를 할당하지 않습니다.
+		static unsigned long long generate_hash_core(const inikey_value* keys, size_t count);
 	};
 } /*namespace CremaReader*/
@@ -0,0 +1,78 @@
+﻿#pragma once
+#include "inidefine.h"
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace CremaReader
+{
+	struct DLL_EXPORT iniwriter_column
+	{
+		iniwriter_column(const std::string& name, const std::string& typeName, bool isKey = false)
+			: name(name), type_name(typeName), is_key(isKey)
+		{
+
+		}
+
+		std::string name;
+		// boolean, byte, unsignedByte, short, unsignedShort, int, unsignedInt, long, unsignedLong,
+		// float, double, dateTime, duration, string 중 하나입니다.
+		std::string type_name;
+		bool is_key;
+	};
+
+	// 행 하나의 값을 채웁니다. 값은 열의 타입으로 변환되어 쓰이며, 채우지 않은 열은 값이 없는 열이 됩니다.
+	class DLL_EXPORT iwriter_row abstract
+	{
+	public:
+		void set_value(size_t index, bool value) { this->set_integer(index, value ? 1 : 0); }
+		void set_value(size_t index, int value) { this->set_integer(index, value); }
+		void set_value(size_t index, unsigned int value) { this->set_integer(index, value); }
+		void set_value(size_t index, long long value) { this->set_integer(index, value); }
+		void set_value(size_t index, unsigned long long value) { this->set_integer(index, (long long)value); }
+		void set_value(size_t index, float value) { this->set_real(index, value); }
+		void set_value(size_t index, double value) { this->set_real(index, value); }
+		void set_value(size_t index, const std::string& value) { this->set_string(index, value.c_str(), value.length()); }
+		void set_value(size_t index, const char* value);
+
+		virtual void set_null(size_t index) = 0;
+
+	protected:
+		iwriter_row() {};
+		virtual ~iwriter_row() {};
+
+		virtual void set_integer(size_t index, long long value) = 0;
+		virtual void set_real(size_t index, double value) = 0;
+		virtual void set_string(size_t index, const char* text, size_t length) = 0;
+	};
+
+	// row 번째 행을 채우는 함수입니다. 테이블마다 다른 스레드에서 호출될 수 있습니다.
+	typedef std::function<void(size_t row, iwriter_row& values)> row_generator;
+
+	// crema.dat 형식으로 데이터를 씁니다. 테이블은 여러 스레드에서 따로 만들어지고 추가한 순서대로 파일에 쓰입니다.
+	// 한번에 메모리에 두는 테이블은 스레드 수의 두배까지입니다.
+	class DLL_EXPORT CremaWriter abstract
+	{
+	public:
+		static CremaWriter& create(const std::string& name);
+
+		virtual void add_table(const std::string& tableName, const std::string& categoryName, const std::vector<iniwriter_column>& columns, size_t rowCount, const row_generator& generator) = 0;
+
+		virtual void set_revision(const std::string& revision) = 0;
+		virtual void set_tags(const std::string& tags) = 0;
+		// 테이블을 LZ4 로 압축해서 씁니다. 압축한 파일은 이 라이브러리의 리더로만 읽을 수 있습니다.
+		virtual void set_compression(bool compression) = 0;
+		// 0 이면 하드웨어 스레드 수를 씁니다.
+		virtual void set_thread_count(size_t count) = 0;
+
+		virtual void write(const std::string& filename) = 0;
+		virtual void write(std::ostream& stream) = 0;
+
+		virtual void destroy() = 0;
+
+	protected:
+		CremaWriter() {};
+		virtual ~CremaWriter() {};
+	};
+} /*namespace CremaReader*/
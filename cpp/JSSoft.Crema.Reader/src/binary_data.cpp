@@ -6,8 +6,7 @@
 #include "../include/crema/iniexception.h"
 #include "internal_utils.h"
 #include "../include/crema/iniutils.h"
-#include <stdarg.h>
-#include <locale>
+#include <cstring>
 
 namespace CremaReader {
 	namespace internal {
@@ -62,6 +61,7 @@ namespace CremaReader {
 			}
 
 			binary_row::binary_row()
+				: m_fields(nullptr)
 			{
 
 			}
@@ -74,10 +74,10 @@ namespace CremaReader {
 			const void* binary_row::value_core(const inicolumn& column) const
 			{
 				static long long nullvalue = 0;
-				const int* offsets = (const int*)&m_fields.front();
+				const int* offsets = (const int*)m_fields;
 				int offset = offsets[column.index()];
 
-				const char* valuePtr = &m_fields.front() + offset;
+				const char* valuePtr = m_fields + offset;
 				const std::type_info& typeinfo = column.datatype();
 
 				if (typeinfo == typeid(std::string))
@@ -85,7 +85,7 @@ namespace CremaReader {
 					if (offset == 0)
 						return &string_resource::empty_string;
 					int id = *(int*)valuePtr;
-					return &string_resource::get(id);
+					return &m_table->strings().get(id);
 				}
 				else
 				{
@@ -97,7 +97,7 @@ namespace CremaReader {
 
 			bool binary_row::has_value_core(const inicolumn& column) const
 			{
-				const int* offsets = (const int*)&m_fields.front();
+				const int* offsets = (const int*)m_fields;
 				int offset = offsets[column.index()];
 				return offset != 0;
 			}
@@ -112,19 +112,19 @@ namespace CremaReader {
 				return *m_table;
 			}
 
-			long binary_row::hash() const
+			unsigned long long binary_row::hash() const
 			{
 				return m_hash;
 			}
 
-			void binary_row::reserve_fields_ptr(size_t size)
+			const char* binary_row::fields() const
 			{
-				m_fields.resize(size, 0);
+				return m_fields;
 			}
 
-			char* binary_row::fields_ptr()
+			void binary_row::set_fields(const char* fields)
 			{
-				return &m_fields.front();
+				m_fields = fields;
 			}
 
 			void binary_row::set_table(binary_table& table)
@@ -132,85 +132,18 @@ namespace CremaReader {
 				m_table = &table;
 			}
 
-			void binary_row::set_hash(long hash)
+			void binary_row::set_hash(unsigned long long hash)
 			{
 				m_hash = hash;
 			}
 
-			bool binary_row::equals_key(va_list& vl)
+			const char* binary_row::field_ptr(size_t index) const
 			{
-				for (inicolumn& item : m_table->m_keys)
-				{
-					const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-					if (typeinfo == typeid(bool))
-					{
-						if (this->value<bool>(item.name()) != !!va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(char))
-					{
-						if (this->value<char>(item.name()) != (char)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(unsigned char))
-					{
-						if (this->value<unsigned char>(item.name()) != (unsigned char)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(short))
-					{
-						if (this->value<short>(item.name()) != (short)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(unsigned short))
-					{
-						if (this->value<unsigned short>(item.name()) != (unsigned short)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(int))
-					{
-						if (this->value<int>(item.name()) != (int)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(unsigned int))
-					{
-						if (this->value<unsigned int>(item.name()) != (unsigned int)va_arg(vl, int))
-							return false;
-					}
-					else if (typeinfo == typeid(float))
-					{
-						if (this->value<float>(item.name()) != (float)va_arg(vl, double))
-							return false;
-					}
-					else if (typeinfo == typeid(double))
-					{
-						if (this->value<double>(item.name()) != (float)va_arg(vl, double))
-							return false;
-					}
-					else if (typeinfo == typeid(long long))
-					{
-						if (this->value<long long>(item.name()) != (long long)va_arg(vl, long long))
-							return false;
-					}
-					else if (typeinfo == typeid(unsigned long long))
-					{
-						if (this->value<unsigned long long>(item.name()) != (unsigned long long)va_arg(vl, long long))
-							return false;
-					}
-					else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
-					{
-						std::string text = va_arg(vl, const char*);
-						if (this->value<std::string>(item.name()) != text)
-							return false;
-					}
-					else if (typeinfo == typeid(std::string))
-					{
-						std::string text = (std::string)va_arg(vl, std::string);
-						if (this->value<std::string>(item.name()) != text)
-							return false;
-					}
-				}
-				return true;
+				const int* offsets = (const int*)m_fields;
+				int offset = offsets[index];
+				if (offset == 0)
+					return nullptr;
+				return m_fields + offset;
 			}
 
 			binary_key_array::binary_key_array()
@@ -294,10 +227,67 @@ namespace CremaReader {
 				return iniutil::to_lower(text);
 			}
 
+			binary_key_index::binary_key_index()
+				: m_mask(0)
+			{
+
+			}
+
+			void binary_key_index::reserve(size_t count)
+			{
+				size_t capacity = 8;
+				while (capacity < count * 2)
+					capacity <<= 1;
+
+				slot empty;
+				empty.hash = 0;
+				empty.index = empty_index;
+				m_slots.assign(capacity, empty);
+				m_mask = capacity - 1;
+			}
+
+			void binary_key_index::insert(unsigned long long hash, size_t index)
+			{
+				size_t pos = this->bucket(hash);
+				while (m_slots[pos].index != empty_index)
+					pos = (pos + 1) & m_mask;
+
+				m_slots[pos].hash = hash;
+				m_slots[pos].index = (unsigned int)index;
+			}
+
+			size_t binary_key_index::find_first(unsigned long long hash) const
+			{
+				if (m_slots.empty() == true)
+					return npos;
+
+				for (size_t pos = this->bucket(hash); m_slots[pos].index != empty_index; pos = (pos + 1) & m_mask)
+				{
+					if (m_slots[pos].hash == hash)
+						return pos;
+				}
+				return npos;
+			}
+
+			size_t binary_key_index::find_next(unsigned long long hash, size_t slot) const
+			{
+				for (size_t pos = (slot + 1) & m_mask; m_slots[pos].index != empty_index; pos = (pos + 1) & m_mask)
+				{
+					if (m_slots[pos].hash == hash)
+						return pos;
+				}
+				return npos;
+			}
+
+			size_t binary_key_index::bucket(unsigned long long hash) const
+			{
+				return (size_t)(hash >> 32) & m_mask;
+			}
+
 			binary_row_array::binary_row_array(size_t count)
 				: m_rows(count)
 			{
-				m_keyTorow.get_allocator().allocate(count);
+
 			}
 
 			binary_row_array::~binary_row_array()
@@ -321,71 +311,53 @@ namespace CremaReader {
 				return m_rows[index];
 			}
 
-			void binary_row_array::generate_key(size_t index)
+			const char* binary_row_array::assign_arena(const char* data, size_t size)
 			{
-				size_t keysize = this->keys_size(), offset = 0;
+				m_arena.assign(data, data + size);
+				if (size == 0)
+					return nullptr;
+				return &m_arena.front();
+			}
 
-				if (keysize == 0)
+			void binary_row_array::generate_key(size_t index)
+			{
+				size_t count = m_keyFields.size();
+				if (count == 0)
 					return;
 
+				long long buffer[8];
+				std::vector<long long> heapBuffer;
+				long long* fields = buffer;
+				if (count > 8)
+				{
+					heapBuffer.resize(count);
+					fields = &heapBuffer.front();
+				}
+
 				binary_row& row = this->at(index);
-				const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
-				std::vector<char> fields(keysize);
-				for (inicolumn& item : m_table->m_keys)
+				for (size_t i = 0; i < count; i++)
 				{
-					const std::type_info& typeinfo = item.datatype();
-					if (typeinfo == typeid(bool))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<bool>(item));
-					}
-					else if (typeinfo == typeid(char))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<char>(item));
-					}
-					else if (typeinfo == typeid(unsigned char))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<unsigned char>(item));
-					}
-					else if (typeinfo == typeid(short))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<short>(item));
-					}
-					else if (typeinfo == typeid(unsigned short))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<unsigned short>(item));
-					}
-					else if (typeinfo == typeid(int))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<int>(item));
-					}
-					else if (typeinfo == typeid(unsigned int))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<unsigned int>(item));
-					}
-					else if (typeinfo == typeid(long long))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<long long>(item));
-					}
-					else if (typeinfo == typeid(unsigned long long))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<unsigned long long>(item));
-					}
-					else if (typeinfo == typeid(float))
-					{
-						this->set_field_value(&fields.front(), offset, row.value<float>(item));
-					}
-					else if (typeinfo == typeid(std::string))
-					{
-						const std::string& text = *(const std::string*)row.value_core(item);
-						this->set_field_value(&fields.front(), offset, iniutil::get_hash_code(text));
-					}
+					fields[i] = this->pack_field(m_keyFields[i], row);
 				}
 
-				long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
+				unsigned long long hash = this->hash_fields(fields, count);
 
 				row.set_hash(hash);
 
-				m_keyTorow.insert(std::multimap<long, binary_row*>::value_type(hash, &row));
+				m_keyToIndex.insert(hash, index);
+			}
+
+			void binary_row_array::generate_keys()
+			{
+				this->prepare_keys();
+				if (m_keyFields.size() == 0)
+					return;
+
+				m_keyToIndex.reserve(m_rows.size());
+				for (size_t i = 0; i < m_rows.size(); i++)
+				{
+					this->generate_key(i);
+				}
 			}
 
 			void binary_row_array::set_table(binary_table& table)
@@ -398,170 +370,223 @@ namespace CremaReader {
 				return *m_table;
 			}
 
-			binary_row_array::iterator binary_row_array::find_core(size_t count, ...)
+			binary_row_array::iterator binary_row_array::find_core(const inikey_value* keys, size_t count)
 			{
-				if (count != m_table->m_keys.size())
+				if (count != m_keyFields.size())
 					throw std::invalid_argument("인자의 갯수가 키의 갯수랑 같지 않습니다.");
-				va_list vl;
-				size_t keysize = this->keys_size();
-				va_start(vl, count);
 
-				size_t offset = 0;
-				std::vector<char> fields(keysize);
-				const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
-
-				for (size_t i = 0; i < count; i++)
+				long long buffer[8];
+				std::vector<long long> heapBuffer;
+				long long* fields = buffer;
+				if (count > 8)
 				{
-					const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-					if (typeinfo == typeid(bool))
-					{
-						this->set_field_value(&fields.front(), offset, !!va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(char))
-					{
-						this->set_field_value(&fields.front(), offset, (char)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(unsigned char))
-					{
-						this->set_field_value(&fields.front(), offset, (unsigned char)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(short))
-					{
-						this->set_field_value(&fields.front(), offset, (short)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(unsigned short))
-					{
-						this->set_field_value(&fields.front(), offset, (unsigned short)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(int))
-					{
-						this->set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(unsigned int))
-					{
-						this->set_field_value(&fields.front(), offset, (unsigned int)va_arg(vl, int));
-					}
-					else if (typeinfo == typeid(float))
-					{
-						this->set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
-					}
-					else if (typeinfo == typeid(double))
-					{
-						this->set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
-					}
-					else if (typeinfo == typeid(long long))
-					{
-						this->set_field_value(&fields.front(), offset, (long long)va_arg(vl, long long));
-					}
-					else if (typeinfo == typeid(unsigned long long))
-					{
-						this->set_field_value(&fields.front(), offset, (unsigned long long)va_arg(vl, long long));
-					}
-					else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
-					{
-						int stringID = iniutil::get_hash_code(va_arg(vl, const char*));
-						this->set_field_value(&fields.front(), offset, stringID);
-					}
-					else if (typeinfo == typeid(std::string))
-					{
-						std::string text = (std::string)va_arg(vl, std::string);
-						int stringID = iniutil::get_hash_code(text);
-						this->set_field_value(&fields.front(), offset, stringID);
-					}
+					heapBuffer.resize(count);
+					fields = &heapBuffer.front();
 				}
-				va_end(vl);
-
-				long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
-				std::pair <std::multimap<long, binary_row*>::iterator, std::multimap<long, binary_row*>::iterator> ret = m_keyTorow.equal_range(hash);
 
-				size_t len = std::distance(ret.first, ret.second);
-
-				if (len == 1)
+				for (size_t i = 0; i < count; i++)
 				{
-					size_t index = ret.first->second - (binary_row*)&m_rows.front();
-					return iterator(this, index);
+					fields[i] = this->pack_field(m_keyFields[i], keys[i]);
 				}
 
-				for (std::multimap<long, binary_row*>::iterator itor = ret.first; itor != ret.second; ++itor)
+				unsigned long long hash = this->hash_fields(fields, count);
+
+				for (size_t slot = m_keyToIndex.find_first(hash); slot != binary_key_index::npos; slot = m_keyToIndex.find_next(hash, slot))
 				{
-					va_list vl1;
-					va_start(vl1, count);
-					if (itor->second->equals_key(vl1) == true)
-					{
-						size_t index = itor->second - (binary_row*)&m_rows.front();
+					size_t index = m_keyToIndex.index(slot);
+					if (this->equals_key(m_rows[index], keys) == true)
 						return iterator(this, index);
-					}
-					va_end(vl1);
 				}
 
 				return iterator(this);
 			}
 
-			size_t binary_row_array::keys_size() const
+			void binary_row_array::prepare_keys()
 			{
-				size_t size = 0;
+				m_keyFields.clear();
+				m_keyFields.reserve(m_table->m_keys.size());
 
 				for (inicolumn& item : m_table->m_keys)
 				{
 					const std::type_info& typeinfo = item.datatype();
-#ifdef _DEBUG
-					const char* name = typeinfo.name();
-#endif
+					key_field field;
+					field.column = item.index();
 
 					if (typeinfo == typeid(bool))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_boolean;
 					else if (typeinfo == typeid(char))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_int8;
 					else if (typeinfo == typeid(unsigned char))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_uint8;
 					else if (typeinfo == typeid(short))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_int16;
 					else if (typeinfo == typeid(unsigned short))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_uint16;
 					else if (typeinfo == typeid(int))
-					{
-						size += sizeof(int);
-					}
+						field.type = key_type_int32;
 					else if (typeinfo == typeid(unsigned int))
-					{
-						size += sizeof(int);
-					}
-					else if (typeinfo == typeid(float))
-					{
-						size += sizeof(double);
-					}
+						field.type = key_type_uint32;
 					else if (typeinfo == typeid(long long))
-					{
-						size += sizeof(long long);
-					}
+						field.type = key_type_int64;
 					else if (typeinfo == typeid(unsigned long long))
+						field.type = key_type_uint64;
+					else if (typeinfo == typeid(float))
+						field.type = key_type_float;
+					else if (typeinfo == typeid(double))
+						field.type = key_type_double;
+					else if (typeinfo == typeid(std::string))
+						field.type = key_type_string;
+					else
+						field.type = key_type_int32;
+
+					m_keyFields.push_back(field);
+				}
+			}
+
+			long long binary_row_array::pack_field(const key_field& field, const binary_row& row) const
+			{
+				const char* valuePtr = row.field_ptr(field.column);
+				long long value = 0;
+
+				switch (field.type)
+				{
+				case key_type_boolean:
+					value = valuePtr != nullptr && *(const bool*)valuePtr ? 1 : 0;
+					break;
+				case key_type_int8:
+					value = valuePtr != nullptr ? *(const char*)valuePtr : 0;
+					break;
+				case key_type_uint8:
+					value = valuePtr != nullptr ? *(const unsigned char*)valuePtr : 0;
+					break;
+				case key_type_int16:
+					value = valuePtr != nullptr ? *(const short*)valuePtr : 0;
+					break;
+				case key_type_uint16:
+					value = valuePtr != nullptr ? *(const unsigned short*)valuePtr : 0;
+					break;
+				case key_type_int32:
+					value = valuePtr != nullptr ? *(const int*)valuePtr : 0;
+					break;
+				case key_type_uint32:
+					value = valuePtr != nullptr ? *(const unsigned int*)valuePtr : 0;
+					break;
+				case key_type_int64:
+				case key_type_uint64:
+					value = valuePtr != nullptr ? *(const long long*)valuePtr : 0;
+					break;
+				case key_type_float:
+				{
+					double real = valuePtr != nullptr ? (double)*(const float*)valuePtr : 0.0;
+					memcpy(&value, &real, sizeof(double));
+					break;
+				}
+				case key_type_double:
+				{
+					double real = valuePtr != nullptr ? *(const double*)valuePtr : 0.0;
+					memcpy(&value, &real, sizeof(double));
+					break;
+				}
+				case key_type_string:
+				{
+					const std::string& text = valuePtr != nullptr ? m_table->strings().get(*(const int*)valuePtr) : string_resource::empty_string;
+					value = iniutil::get_hash_code(text);
+					break;
+				}
+				}
+				return value;
+			}
+
+			long long binary_row_array::pack_field(const key_field& field, const inikey_value& key) const
+			{
+				if ((field.type == key_type_string) != (key.type() == inikey_value::value_type_string))
+					throw std::invalid_argument("키의 타입이 올바르지 않습니다.");
+
+				long long value = 0;
+
+				switch (field.type)
+				{
+				case key_type_boolean:
+					value = key.to_integer() != 0 ? 1 : 0;
+					break;
+				case key_type_int8:
+					value = (char)key.to_integer();
+					break;
+				case key_type_uint8:
+					value = (unsigned char)key.to_unsigned();
+					break;
+				case key_type_int16:
+					value = (short)key.to_integer();
+					break;
+				case key_type_uint16:
+					value = (unsigned short)key.to_unsigned();
+					break;
+				case key_type_int32:
+					value = (int)key.to_integer();
+					break;
+				case key_type_uint32:
+					value = (unsigned int)key.to_unsigned();
+					break;
+				case key_type_int64:
+					value = key.to_integer();
+					break;
+				case key_type_uint64:
+					value = (long long)key.to_unsigned();
+					break;
+				case key_type_float:
+				{
+					double real = (double)(float)key.to_real();
+					memcpy(&value, &real, sizeof(double));
+					break;
+				}
+				case key_type_double:
+				{
+					double real = key.to_real();
+					memcpy(&value, &real, sizeof(double));
+					break;
+				}
+				case key_type_string:
+					value = iniutil::get_hash_code(key.text(), key.length());
+					break;
+				}
+				return value;
+			}
+
+			bool binary_row_array::equals_key(const binary_row& row, const inikey_value* keys) const
+			{
+				for (size_t i = 0; i < m_keyFields.size(); i++)
+				{
+					const key_field& field = m_keyFields[i];
+					if (field.type == key_type_string)
 					{
-						size += sizeof(long long);
+						const char* valuePtr = row.field_ptr(field.column);
+						const std::string& text = valuePtr != nullptr ? m_table->strings().get(*(const int*)valuePtr) : string_resource::empty_string;
+						if (text.length() != keys[i].length() || text.compare(0, text.length(), keys[i].text(), keys[i].length()) != 0)
+							return false;
 					}
-					else if (typeinfo == typeid(std::string))
+					else if (this->pack_field(field, row) != this->pack_field(field, keys[i]))
 					{
-						size += sizeof(int);
+						return false;
 					}
 				}
+				return true;
+			}
 
-				return size;
+			unsigned long long binary_row_array::hash_fields(const long long* fields, size_t count) const
+			{
+				return iniutil::hash(fields, sizeof(long long) * count);
 			}
 
 			binary_table::binary_table(binary_reader* reader, size_t columnCount, size_t rowCount)
-				: m_columns(columnCount), m_rows(rowCount)
+				: m_columns(columnCount), m_rows(rowCount), m_updated(false), m_columnData(columnCount)
 			{
 				this->m_reader = reader;
 				this->m_rows.set_table(*this);
+
+				for (size_t i = 0; i < columnCount; i++)
+				{
+					m_columnData[i].store(nullptr, std::memory_order_relaxed);
+				}
 			}
 
 			std::string binary_table::category() const
@@ -594,11 +619,88 @@ namespace CremaReader {
 				return *m_reader;
 			}
 
+			const icolumn_data& binary_table::column_data(const inicolumn& column) const
+			{
+				size_t index = column.index();
+				if (&column.table() != this || index >= m_columnData.size())
+					throw std::invalid_argument("테이블에 속한 열이 아닙니다.");
+
+				binary_column_data* data = m_columnData[index].load(std::memory_order_acquire);
+				if (data != nullptr)
+					return *data;
+
+				binary_column_data* created = new binary_column_data(*this, static_cast<const binary_column&>(m_columns.at(index)));
+				if (m_columnData[index].compare_exchange_strong(data, created, std::memory_order_acq_rel, std::memory_order_acquire) == false)
+				{
+					delete created;
+					return *data;
+				}
+				return *created;
+			}
+
 			binary_table::~binary_table()
+			{
+				for (std::atomic<binary_column_data*>& item : m_columnData)
+				{
+					delete item.load();
+				}
+			}
+
+			binary_column_data::binary_column_data(const binary_table& table, const binary_column& column)
+				: m_column(column), m_size(table.m_rows.size())
+			{
+				const binary_row_array& rows = table.m_rows;
+				const std::type_info& typeinfo = column.datatype();
+				bool isString = typeinfo == typeid(std::string);
+				size_t stride = isString ? sizeof(const std::string*) : (size_t)iniutil::get_type_size(typeinfo);
+
+				m_values.assign((m_size * stride + sizeof(long long) - 1) / sizeof(long long) + 1, 0);
+				m_bitmap.assign((m_size + 63) / 64 + 1, 0);
+
+				char* values = (char*)&m_values.front();
+				for (size_t i = 0; i < m_size; i++)
+				{
+					const char* valuePtr = rows.at(i).field_ptr(column.index());
+					if (isString == true)
+					{
+						const std::string* text = valuePtr != nullptr ? &table.strings().get(*(const int*)valuePtr) : &string_resource::empty_string;
+						memcpy(values + i * stride, &text, stride);
+					}
+					else if (valuePtr != nullptr)
+					{
+						memcpy(values + i * stride, valuePtr, stride);
+					}
+
+					if (valuePtr != nullptr)
+						m_bitmap[i >> 6] |= 1ULL << (i & 63);
+				}
+			}
+
+			binary_column_data::~binary_column_data()
 			{
 
 			}
 
+			const inicolumn& binary_column_data::column() const
+			{
+				return m_column;
+			}
+
+			size_t binary_column_data::size() const
+			{
+				return m_size;
+			}
+
+			const void* binary_column_data::data() const
+			{
+				return &m_values.front();
+			}
+
+			const unsigned long long* binary_column_data::null_bitmap() const
+			{
+				return &m_bitmap.front();
+			}
+
 			binary_table_array::binary_table_array(binary_reader& reader)
 				: m_reader(reader)
 			{
@@ -607,9 +709,13 @@ namespace CremaReader {
 
 			binary_table_array::~binary_table_array()
 			{
-				for (binary_table* item : m_tables)
+				for (std::atomic<binary_table*>& item : m_tables)
 				{
-					delete item;
+					delete item.load();
+				}
+				for (size_t i = 0; i < m_retiredTables.size(); i++)
+				{
+					delete m_retiredTables[i];
 				}
 			}
 
@@ -618,51 +724,121 @@ namespace CremaReader {
 				return m_tables.size();
 			}
 
-			itable& binary_table_array::at(size_t index) const throw()
+			itable& binary_table_array::at(size_t index) const
 			{
-				itable* table = m_tables.at(index);
-				if (table == NULL)
-					return *const_cast<binary_table_array*>(this)->m_reader.read_table(index);
+				binary_table* table = m_tables.at(index).load(std::memory_order_acquire);
+				if (table == nullptr)
+					return *const_cast<binary_table_array*>(this)->load(index);
 				return *table;
 			}
 
-			itable& binary_table_array::at(const std::string& tableName) const throw()
+			itable& binary_table_array::at(const std::string& tableName) const
 			{
-				std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-				if (itor == m_nameToTable.end())
-				{
-					return *const_cast<binary_table_array*>(this)->m_reader.read_table(conv_string(tableName));
-				}
-				return *itor->second;
+				return this->at(this->index_of(tableName));
 			}
 
 			bool binary_table_array::contains(const std::string& tableName) const
 			{
-				return m_nameToTable.find(conv_string(tableName)) != m_nameToTable.end();
+				return this->is_table_loaded(tableName);
 			}
 
 			void binary_table_array::set(size_t index, binary_table* table)
 			{
-				std::string tableName;
-				m_nameToTable[conv_string(table->name())] = table;
-				m_tables[index] = table;
-				dynamic_cast<binary_table*>(table)->set_index(index);
+				m_tables[index].store(table, std::memory_order_release);
+			}
 
-#ifdef _DEBUG
-				//std::cout << table->name() << " is loaded : " << index << std::endl;
-#endif
+			void binary_table_array::replace(const std::string& tableName, binary_table* table)
+			{
+				this->replace(this->index_of(tableName), table);
+			}
+
+			void binary_table_array::replace(size_t index, binary_table* table)
+			{
+				table->set_index(index);
+
+				this->retire(m_tables[index].exchange(table, std::memory_order_acq_rel));
+			}
+
+			void binary_table_array::replace(const std::vector<size_t>& indexes, std::vector<std::unique_ptr<binary_table> >& tables)
+			{
+				std::lock_guard<std::mutex> lock(m_retiredLock);
+				m_retiredTables.reserve(m_retiredTables.size() + tables.size());
+
+				for (size_t i = 0; i < tables.size(); i++)
+				{
+					binary_table* table = tables[i].release();
+					table->set_index(indexes[i]);
+
+					binary_table* previous = m_tables[indexes[i]].exchange(table, std::memory_order_acq_rel);
+					if (previous != nullptr)
+						m_retiredTables.push_back(previous);
+				}
+			}
+
+			// 읽혀 있는 테이블을 반환하고 읽혀 있지 않으면 읽지 않고 nullptr 를 반환합니다.
+			binary_table* binary_table_array::loaded(size_t index) const
+			{
+				return m_tables.at(index).load(std::memory_order_acquire);
+			}
+
+			// 교체되거나 내려진 테이블은 다른 스레드가 아직 참조하고 있을 수 있으므로 reclaim_tables 까지 보관합니다.
+			void binary_table_array::retire(binary_table* table)
+			{
+				if (table == nullptr)
+					return;
+				std::lock_guard<std::mutex> lock(m_retiredLock);
+				m_retiredTables.push_back(table);
 			}
 
-			void binary_table_array::set_size(const std::vector<table_index>& indexes)
+			size_t binary_table_array::reclaim_tables()
 			{
-				m_tables.assign(indexes.size(), NULL);
+				std::vector<binary_table*> tables;
+				{
+					std::lock_guard<std::mutex> lock(m_retiredLock);
+					tables.swap(m_retiredTables);
+				}
+				for (size_t i = 0; i < tables.size(); i++)
+				{
+					delete tables[i];
+				}
+				return tables.size();
+			}
+
+			void binary_table_array::set_size(const std::vector<table_index>& indexes, const string_pool& strings)
+			{
+				std::vector<std::atomic<binary_table*> > tables(indexes.size());
+				m_tables.swap(tables);
+				m_nameToIndex.clear();
 
 				m_tableNames.reserve(indexes.size());
-				for (std::vector<table_index>::const_iterator itor = indexes.begin(); itor != indexes.end(); itor++)
+				for (size_t i = 0; i < indexes.size(); i++)
 				{
-					const std::string& tableName = string_resource::get(itor->tableName);
+					const std::string& tableName = strings.get(indexes[i].tableName);
 					m_tableNames.push_back(tableName);
+					m_nameToIndex[conv_string(tableName)] = i;
+					m_tables[i].store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			size_t binary_table_array::index_of(const std::string& tableName) const
+			{
+				std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+				if (itor == m_nameToIndex.end())
+					throw keynotfoundexception(tableName, "tables");
+				return itor->second;
+			}
+
+			binary_table* binary_table_array::load(size_t index)
+			{
+				binary_table* table = m_reader.read_table(index);
+				binary_table* expected = nullptr;
+
+				if (m_tables[index].compare_exchange_strong(expected, table, std::memory_order_acq_rel, std::memory_order_acquire) == false)
+				{
+					delete table;
+					return expected;
 				}
+				return table;
 			}
 
 			void binary_table_array::set_flag(ReadFlag flag)
@@ -684,27 +860,29 @@ namespace CremaReader {
 
 			bool binary_table_array::is_table_loaded(const std::string& tableName) const
 			{
-				std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-				return itor != m_nameToTable.end();
+				std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+				if (itor == m_nameToIndex.end())
+					return false;
+				return m_tables[itor->second].load(std::memory_order_acquire) != nullptr;
 			}
 
 			void binary_table_array::load_table(const std::string& tableName)
 			{
-				if (this->is_table_loaded(tableName) == true)
-					return;
-
-				m_reader.read_table(conv_string(tableName));
+				this->at(tableName);
 			}
 
 			void binary_table_array::release_table(const std::string& tableName)
 			{
-				std::map<std::string, binary_table*>::const_iterator itor = m_nameToTable.find(conv_string(tableName));
-				if (itor == m_nameToTable.end())
+				std::map<std::string, size_t>::const_iterator itor = m_nameToIndex.find(conv_string(tableName));
+				if (itor == m_nameToIndex.end())
+					return;
+
+				std::atomic<binary_table*>& slot = m_tables[itor->second];
+				binary_table* table = slot.load(std::memory_order_acquire);
+				if (table == nullptr || table->is_updated() == true)
 					return;
-				binary_table* table = itor->second;
-				m_nameToTable.erase(itor->first);
-				m_tables[table->index()] = nullptr;
-				delete table;
+				if (slot.compare_exchange_strong(table, nullptr, std::memory_order_acq_rel, std::memory_order_acquire) == true)
+					this->retire(table);
 			}
 		} /*namespace binary*/
 	} /*namespace internal*/
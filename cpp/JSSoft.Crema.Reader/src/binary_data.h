@@ -2,9 +2,13 @@
 #include "../include/crema/inidata.h"
 #include "../include/crema/initype.h"
 #include "binary_type.h"
+#include "internal_utils.h"
 #include <map>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <memory>
 
 namespace CremaReader {
 	namespace internal {
@@ -49,18 +53,18 @@ namespace CremaReader {
 				virtual bool has_value_core(const inicolumn& column) const;
 				virtual void set_value(const std::string& columnName, const std::string& text);
 				virtual itable& table() const;
-				virtual long hash() const;
+				virtual unsigned long long hash() const;
+				virtual const char* fields() const;
 
-				void reserve_fields_ptr(size_t size);
-				char* fields_ptr();
+				void set_fields(const char* fields);
 				void set_table(binary_table& table);
-				void set_hash(long hash);
-				bool equals_key(va_list& vl);
+				void set_hash(unsigned long long hash);
+				const char* field_ptr(size_t index) const;
 
 			private:
-				std::vector<char> m_fields;
+				const char* m_fields;
 				binary_table* m_table;
-				long m_hash;
+				unsigned long long m_hash;
 			};
 
 			class binary_column_array : public icolumn_array
@@ -101,6 +105,36 @@ namespace CremaReader {
 				std::vector<binary_column*> m_columns;
 			};
 
+			class binary_key_index
+			{
+			public:
+				static const size_t npos = (size_t)-1;
+
+				binary_key_index();
+
+				void reserve(size_t count);
+				void insert(unsigned long long hash, size_t index);
+
+				size_t find_first(unsigned long long hash) const;
+				size_t find_next(unsigned long long hash, size_t slot) const;
+				size_t index(size_t slot) const { return m_slots[slot].index; }
+
+			private:
+				size_t bucket(unsigned long long hash) const;
+
+				struct slot
+				{
+					unsigned long long hash;
+					unsigned int index;
+				};
+
+				static const unsigned int empty_index = 0xffffffff;
+
+			private:
+				std::vector<slot> m_slots;
+				size_t m_mask;
+			};
+
 			class binary_row_array : public irow_array
 			{
 			public:
@@ -111,28 +145,70 @@ namespace CremaReader {
 				virtual binary_row& at(size_t index) const;
 
 				binary_row& at(size_t index);
+				const char* assign_arena(const char* data, size_t size);
+				size_t arena_size() const { return m_arena.size(); }
 				void generate_key(size_t index);
+				void generate_keys();
 				void set_table(binary_table& table);
 				binary_table& table() const;
 
-				iterator find_core(size_t count, ...);
+				iterator find_core(const inikey_value* keys, size_t count);
 
 			private:
-				size_t keys_size() const;
-				template<typename _type>
-				void set_field_value(const char* buffer, size_t& offset, _type value)
+				enum key_type
 				{
-					_type* value_ptr = (_type*)(buffer + offset);
-					*value_ptr = value;
-					offset += sizeof(_type);
-				}
+					key_type_boolean,
+					key_type_int8,
+					key_type_uint8,
+					key_type_int16,
+					key_type_uint16,
+					key_type_int32,
+					key_type_uint32,
+					key_type_int64,
+					key_type_uint64,
+					key_type_float,
+					key_type_double,
+					key_type_string,
+				};
+
+				struct key_field
+				{
+					size_t column;
+					key_type type;
+				};
+
+				void prepare_keys();
+				long long pack_field(const key_field& field, const binary_row& row) const;
+				long long pack_field(const key_field& field, const inikey_value& key) const;
+				bool equals_key(const binary_row& row, const inikey_value* keys) const;
+				unsigned long long hash_fields(const long long* fields, size_t count) const;
 
 			private:
 				std::vector<binary_row> m_rows;
-				std::multimap<long, binary_row*> m_keyTorow;
+				std::vector<char> m_arena;
+				std::vector<key_field> m_keyFields;
+				binary_key_index m_keyToIndex;
 				binary_table* m_table;
 			};
 
+			class binary_column_data : public icolumn_data
+			{
+			public:
+				binary_column_data(const binary_table& table, const binary_column& column);
+				virtual ~binary_column_data();
+
+				virtual const inicolumn& column() const;
+				virtual size_t size() const;
+				virtual const void* data() const;
+				virtual const unsigned long long* null_bitmap() const;
+
+			private:
+				const binary_column& m_column;
+				size_t m_size;
+				std::vector<long long> m_values;
+				std::vector<unsigned long long> m_bitmap;
+			};
+
 			class binary_table : public itable
 			{
 			public:
@@ -145,13 +221,20 @@ namespace CremaReader {
 				virtual std::string hash_value() const;
 
 				void set_index(size_t index);
+				// update 로 받은 테이블이면 원본 스트림의 내용과 다를 수 있으므로 내렸다가 다시 읽을 수 없습니다.
+				bool is_updated() const { return m_updated; }
 
 				virtual const inikey_array& keys() const { return m_keys; }
 				virtual const icolumn_array& columns() const { return m_columns; }
 				virtual const irow_array& rows() const { return m_rows; }
 
+				virtual const icolumn_data& column_data(const inicolumn& column) const;
+				using itable::column_data;
+
 				virtual idataset& dataset() const;
 
+				const string_pool& strings() const { return m_strings; }
+
 				binary_key_array m_keys;
 				binary_column_array m_columns;
 				binary_row_array m_rows;
@@ -161,7 +244,10 @@ namespace CremaReader {
 				std::string m_categoryName;
 				size_t m_index;
 				std::string m_hashValue;
+				bool m_updated;
 				binary_reader* m_reader;
+				string_pool m_strings;
+				mutable std::vector<std::atomic<binary_column_data*> > m_columnData;
 
 				friend class binary_reader;
 			};
@@ -173,27 +259,37 @@ namespace CremaReader {
 				virtual ~binary_table_array();
 
 				virtual size_t size() const;
-				virtual itable& at(size_t index) const throw();
-				virtual itable& at(const std::string& tableName) const throw();
+				virtual itable& at(size_t index) const;
+				virtual itable& at(const std::string& tableName) const;
 				virtual bool contains(const std::string& tableName) const;
 				virtual const itableNameArray& names() const;
 				virtual bool is_table_loaded(const std::string& tableName) const;
 				virtual void load_table(const std::string& tableName);
 				virtual void release_table(const std::string& tableName);
-
+				virtual size_t reclaim_tables();
 
 				void set(size_t index, binary_table* dataTable);
-				void set_size(const std::vector<table_index>& indexes);
+				void replace(const std::string& tableName, binary_table* dataTable);
+				void replace(size_t index, binary_table* dataTable);
+				// 보관할 자리를 먼저 마련하므로 예외가 나면 아무것도 바뀌지 않고, 자리를 마련한 뒤에는 예외 없이 모두 바꿉니다.
+				void replace(const std::vector<size_t>& indexes, std::vector<std::unique_ptr<binary_table> >& tables);
+				size_t index_of(const std::string& tableName) const;
+				binary_table* loaded(size_t index) const;
+				void set_size(const std::vector<table_index>& indexes, const string_pool& strings);
 				void set_flag(ReadFlag flag);
 
 				binary_table_array& operator=(const binary_table_array&) { return *this; }
 
 			private:
 				std::string conv_string(const std::string& text) const;
+				binary_table* load(size_t index);
+				void retire(binary_table* table);
 
 			private:
-				std::map<std::string, binary_table*> m_nameToTable;
-				std::vector<binary_table*> m_tables;
+				std::map<std::string, size_t> m_nameToIndex;
+				std::vector<std::atomic<binary_table*> > m_tables;
+				std::vector<binary_table*> m_retiredTables;
+				std::mutex m_retiredLock;
 				itableNameArray m_tableNames;
 				binary_reader& m_reader;
 				bool m_caseSensitive;
@@ -1,7 +1,16 @@
 ﻿#include "binary_reader.h"
 #include "internal_utils.h"
+#include "mapped_istream.h"
+#include "socket_delta.h"
+#include "lz4_block.h"
 #include "../include/crema/iniutils.h"
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <cstring>
 #include "../include/crema/iniexception.h"
 
 namespace CremaReader {
@@ -9,14 +18,18 @@ namespace CremaReader {
 		namespace binary
 		{
 			binary_reader::binary_reader()
-				: m_tables(*this)
+				: m_tables(*this), m_stream(nullptr), m_file(nullptr), m_image(nullptr), m_revisionInfo(new revision_info())
 			{
 
 			}
 
 			binary_reader::~binary_reader()
 			{
-
+				delete m_revisionInfo.load();
+				for (size_t i = 0; i < m_retiredRevisions.size(); i++)
+				{
+					delete m_retiredRevisions[i];
+				}
 			}
 
 			void binary_reader::destroy()
@@ -24,109 +37,410 @@ namespace CremaReader {
 				delete this;
 			}
 
+			size_t binary_reader::reclaim()
+			{
+				std::lock_guard<std::mutex> lock(m_updateLock);
+				for (size_t i = 0; i < m_retiredRevisions.size(); i++)
+				{
+					delete m_retiredRevisions[i];
+				}
+				m_retiredRevisions.clear();
+				return m_tables.reclaim_tables();
+			}
+
+			binary_reader::revision_info* binary_reader::create_revision(const std::string& revision, const std::string& tablesHashValue)
+			{
+				std::unique_ptr<revision_info> info(new revision_info());
+				info->revision = revision;
+				info->tablesHashValue = tablesHashValue;
+				return info.release();
+			}
+
+			// 호출하는 쪽에서 m_retiredRevisions 에 자리를 마련해 두어야 예외 없이 바꿉니다.
+			void binary_reader::publish_revision(const revision_info* info)
+			{
+				const revision_info* previous = m_revisionInfo.exchange(info, std::memory_order_acq_rel);
+				if (previous != nullptr)
+					m_retiredRevisions.push_back(previous);
+			}
+
 			void binary_reader::read_core(std::istream& stream, ReadFlag flag)
 			{
+				iload_listener* listener = CremaReader::load_listener();
+				inidataset_stats stats;
+				stats.start = listener != nullptr ? binary_reader::now() : 0;
+
 				file_header fileHeader;
 				m_stream = &stream;
 				m_flag = flag;
 
+				mapped_istream* mapped = dynamic_cast<mapped_istream*>(&stream);
+				m_image = mapped != nullptr ? mapped->data() : nullptr;
+				file_istream* file = dynamic_cast<file_istream*>(&stream);
+				m_file = file != nullptr && file->can_read_at() == true ? file : nullptr;
+
 				stream.seekg(0, std::ios_base::beg);
 				stream.read((char*)&fileHeader, sizeof(file_header));
 				m_tableIndexes.assign(fileHeader.tableCount, table_index());
 				if (fileHeader.tableCount == 0)
 					return;
 				stream.read((char*)&m_tableIndexes.front(), sizeof(table_index) * fileHeader.tableCount);
+				if (listener != nullptr)
+					stats.header_time = binary_reader::now() - stats.start;
+
 				stream.seekg(fileHeader.stringResourcesOffset);
-				string_resource::read(stream);
-				m_name = string_resource::get(fileHeader.name);
-				m_revision = string_resource::get(fileHeader.revision);
+				m_strings.read(stream);
+				if (listener != nullptr)
+				{
+					stats.string_resources_time = binary_reader::now() - stats.start - stats.header_time;
+					stats.bytes_read = sizeof(file_header) + sizeof(table_index) * m_tableIndexes.size() + (size_t)((long long)stream.tellg() - fileHeader.stringResourcesOffset);
+				}
+				m_name = m_strings.get(fileHeader.name);
+				m_retiredRevisions.reserve(1);
+				this->publish_revision(binary_reader::create_revision(m_strings.get(fileHeader.revision), m_strings.get(fileHeader.tablesHashValue)));
 
-				this->m_tables.set_size(m_tableIndexes);
 				this->m_tables.set_flag(flag);
-				m_typesHashValue = string_resource::get(fileHeader.typesHashValue);
-				m_tablesHashValue = string_resource::get(fileHeader.tablesHashValue);
-				m_tags = string_resource::get(fileHeader.tags);
+				this->m_tables.set_size(m_tableIndexes, m_strings);
+				m_typesHashValue = m_strings.get(fileHeader.typesHashValue);
+				m_tags = m_strings.get(fileHeader.tags);
 
+				long long tablesStart = listener != nullptr ? binary_reader::now() : 0;
 				if ((flag & ReadFlag_lazy_loading) == false)
 				{
-					for (size_t i = 0; i < m_tableIndexes.size(); i++)
+					if ((flag & ReadFlag_parallel_loading) != 0)
+					{
+						this->read_tables(CremaReader::thread_count());
+					}
+					else
+					{
+						for (size_t i = 0; i < m_tableIndexes.size(); i++)
+						{
+							this->m_tables.set(i, read_table(i));
+						}
+					}
+				}
+
+				if (listener != nullptr)
+				{
+					long long end = binary_reader::now();
+					stats.name = m_name;
+					stats.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+					stats.wall_time = end - stats.start;
+					stats.tables_time = (flag & ReadFlag_lazy_loading) == false ? end - tablesStart : 0;
+					stats.table_count = m_tableIndexes.size();
+					stats.strings = m_strings.size();
+					listener->dataset_loaded(stats);
+				}
+			}
+
+			long long binary_reader::now()
+			{
+				return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+#ifndef _IGNORE_BOOST
+			size_t binary_reader::update_core(const std::string& address, int port, const std::string& name)
+			{
+				std::lock_guard<std::mutex> lock(m_updateLock);
+				const itableNameArray& tableNames = m_tables.names();
+				std::vector<socket_delta::table_hash> hashes(tableNames.size());
+
+				// 아직 읽지 않은 테이블은 원본 스트림에 있는 테이블 헤더의 해시를 보냅니다.
+				// 서버에서 바뀐 테이블만 받아 교체하고, 바뀌지 않은 테이블은 나중에 원본 스트림에서 지연 읽기로 읽습니다.
+				for (size_t i = 0; i < tableNames.size(); i++)
+				{
+					const binary_table* table = m_tables.loaded(i);
+					hashes[i].name = tableNames[i];
+					hashes[i].hash = table != nullptr ? table->hash_value() : this->read_hash_value(i);
+				}
+
+				socket_delta delta(address, port, name);
+				if (delta.compare(this->tables_hash_value(), hashes) == false)
+					throw std::runtime_error("테이블 구성이 바뀌어 전체를 다시 읽어야 합니다.");
+
+				// 교체하기 전에 이름을 모두 찾고 모두 읽어 두어서 중간에 실패해도 아무것도 바뀌지 않게 합니다.
+				std::vector<socket_delta::table_image>& images = delta.tables();
+				std::vector<size_t> indexes(images.size());
+				std::vector<std::unique_ptr<binary_table> > tables(images.size());
+				for (size_t i = 0; i < images.size(); i++)
+				{
+					indexes[i] = m_tables.index_of(images[i].name);
+				}
+				for (size_t i = 0; i < images.size(); i++)
+				{
+					std::vector<char>& data = images[i].data;
+					if (data.size() < sizeof(table_header))
+						throw std::runtime_error("잘못된 테이블 데이터입니다.");
+					if (binary_reader::is_compressed(&data.front(), data.size()) == true)
 					{
-						const table_index& tableIndex = m_tableIndexes[i];
+						std::vector<char> compressed;
+						compressed.swap(data);
+						binary_reader::decompress_table(&compressed.front(), data);
+					}
+					tables[i].reset(binary_reader::read_table(&data.front(), data, nullptr));
+					tables[i]->m_updated = true;
+				}
+				std::unique_ptr<revision_info> info(binary_reader::create_revision(delta.revision(), delta.tables_hash_value()));
+				m_retiredRevisions.reserve(m_retiredRevisions.size() + 1);
+
+				// 여기부터는 예외가 나지 않으므로 테이블과 리비전이 함께 바뀝니다.
+				size_t count = tables.size();
+				m_tables.replace(indexes, tables);
+				this->publish_revision(info.release());
+				return count;
+			}
+#endif
 
-						binary_table* table = read_table(stream, tableIndex.offset, flag);
-						this->m_tables.set(i, table);
+			void binary_reader::read_tables(size_t threadCount)
+			{
+				if (threadCount == 0)
+					threadCount = std::thread::hardware_concurrency();
+				if (threadCount == 0)
+					threadCount = 1;
+				if (threadCount > m_tableIndexes.size())
+					threadCount = m_tableIndexes.size();
+
+				std::atomic<size_t> next(0);
+				std::atomic<bool> failed(false);
+				std::exception_ptr error;
+				std::mutex errorLock;
+
+				auto worker = [&]()
+				{
+					try
+					{
+						for (size_t i = next++; i < m_tableIndexes.size() && failed == false; i = next++)
+						{
+							this->m_tables.set(i, read_table(i));
+						}
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(errorLock);
+						if (error == nullptr)
+							error = std::current_exception();
+						failed = true;
 					}
+				};
+
+				std::vector<std::thread> threads;
+				threads.reserve(threadCount - 1);
+				for (size_t i = 1; i < threadCount; i++)
+				{
+					threads.push_back(std::thread(worker));
+				}
+				worker();
+
+				for (size_t i = 0; i < threads.size(); i++)
+				{
+					threads[i].join();
 				}
+
+				if (error != nullptr)
+					std::rethrow_exception(error);
 			}
 
 			binary_table* binary_reader::read_table(size_t index)
 			{
-				const table_index& table_index = m_tableIndexes.at(index);
-				binary_table* table = binary_reader::read_table(*m_stream, table_index.offset, m_flag);
-				this->m_tables.set(index, table);
+				const table_index& tableIndex = m_tableIndexes.at(index);
+				std::vector<char> buffer;
+				binary_table* table;
+
+				iload_listener* listener = CremaReader::load_listener();
+				initable_stats stats;
+				initable_stats* tracking = listener != nullptr ? &stats : nullptr;
+				long long allocations = listener != nullptr ? listener->allocation_count() : -1;
+				long long time = listener != nullptr ? binary_reader::now() : 0;
+				stats.start = time;
+
+				const char* data = m_image != nullptr ? m_image + tableIndex.offset : nullptr;
+				if (data == nullptr)
+				{
+					binary_reader::read_block(tableIndex.offset, buffer);
+					data = &buffer.front();
+				}
+				bool compressed = binary_reader::is_compressed(data, m_image != nullptr ? sizeof(compressed_table_header) : buffer.size());
+				if (tracking != nullptr)
+				{
+					compressed_table_header header;
+					memcpy(&header, data, sizeof(compressed_table_header));
+					stats.bytes_read = compressed == true ? sizeof(compressed_table_header) + (size_t)header.compressedSize : (size_t)((const table_header*)data)->userOffset;
+					stats.read_time = binary_reader::now() - time;
+					time += stats.read_time;
+				}
+
+				if (compressed == true)
+				{
+					std::vector<char> block;
+					block.swap(buffer);
+					binary_reader::decompress_table(data, buffer);
+					data = &buffer.front();
+					if (tracking != nullptr)
+					{
+						stats.decompress_time = binary_reader::now() - time;
+					}
+				}
+				table = binary_reader::read_table(data, buffer, tracking);
+
+				table->set_index(index);
+				if (listener != nullptr)
+				{
+					stats.name = table->name();
+					stats.index = index;
+					stats.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+					stats.wall_time = binary_reader::now() - stats.start;
+					if (allocations >= 0)
+						stats.allocations = listener->allocation_count() - allocations;
+					listener->table_loaded(stats);
+				}
 				return table;
 			}
 
-			bool binary_reader::findif::operator() (const table_index& index)
+			// 파일에서 열었으면 위치를 지정해 읽으므로 잠그지 않고, 다른 스트림이면 읽는 동안 스트림을 잠급니다.
+			void binary_reader::read_block(std::streamoff offset, std::vector<char>& buffer)
+			{
+				table_header tableHeader;
+				binary_reader::read_range(offset, (char*)&tableHeader, sizeof(table_header));
+
+				// 압축된 테이블이면 압축된 블럭 그대로 읽습니다. 압축은 잠금 밖에서 read_table 이 풉니다.
+				// table_header 로 읽은 앞부분을 compressed_table_header 로 다시 해석할 때는 복사해서 씁니다.
+				compressed_table_header header;
+				memcpy(&header, &tableHeader, sizeof(compressed_table_header));
+				if (header.magicValue == compressed_table_magic_value)
+					buffer.assign(sizeof(compressed_table_header) + (size_t)header.compressedSize, 0);
+				else
+					buffer.assign((size_t)tableHeader.userOffset, 0);
+				binary_reader::read_range(offset, &buffer.front(), buffer.size());
+			}
+
+			void binary_reader::read_range(std::streamoff offset, char* buffer, size_t size)
 			{
-				if ((m_flag & ReadFlag_case_sensitive) != 0)
-					return m_tableName == string_resource::get(index.tableName);
-				return m_tableName == iniutil::to_lower(string_resource::get(index.tableName));
+				if (m_file != nullptr)
+				{
+					if (m_file->read_at(offset, buffer, size) == false)
+						throw std::runtime_error("테이블을 읽을 수 없습니다.");
+					return;
+				}
+
+				std::lock_guard<std::mutex> lock(m_streamLock);
+				m_stream->clear();
+				m_stream->seekg(offset, std::ios::beg);
+				m_stream->read(buffer, size);
 			}
 
-			binary_table* binary_reader::read_table(const std::string& tableName)
+			// 읽지 않은 테이블의 해시를 읽습니다. 해시 문자열은 테이블의 문자열 목록에 있으므로 압축되지 않은 테이블은 헤더와 문자열 목록만 읽습니다.
+			std::string binary_reader::read_hash_value(size_t index)
 			{
-				std::vector<table_index>::const_iterator itor = std::find_if(m_tableIndexes.begin(), m_tableIndexes.end(), findif(m_flag, tableName));
+				const table_index& tableIndex = m_tableIndexes.at(index);
+				std::vector<char> buffer;
+				const char* data = m_image != nullptr ? m_image + tableIndex.offset : nullptr;
+				if (data == nullptr)
+				{
+					table_header tableHeader;
+					binary_reader::read_range(tableIndex.offset, (char*)&tableHeader, sizeof(table_header));
+					if (binary_reader::is_compressed((const char*)&tableHeader, sizeof(table_header)) == false)
+					{
+						buffer.assign((size_t)(tableHeader.userOffset - tableHeader.stringResourcesOffset), 0);
+						binary_reader::read_range(tableIndex.offset + tableHeader.stringResourcesOffset, &buffer.front(), buffer.size());
 
-				if (itor == m_tableIndexes.end())
-					throw keynotfoundexception(tableName, "tables");
+						string_pool strings;
+						strings.read(&buffer.front());
+						return strings.get(tableHeader.hashValue);
+					}
+					binary_reader::read_block(tableIndex.offset, buffer);
+					data = &buffer.front();
+				}
 
-				size_t index = itor - m_tableIndexes.begin();
+				std::vector<char> decompressed;
+				if (binary_reader::is_compressed(data, sizeof(compressed_table_header)) == true)
+				{
+					binary_reader::decompress_table(data, decompressed);
+					data = &decompressed.front();
+				}
 
-				binary_table* table = binary_reader::read_table(*m_stream, itor->offset, m_flag);
-				this->m_tables.set(index, table);
-				return table;
+				const table_header& tableHeader = *(const table_header*)data;
+				string_pool strings;
+				strings.read(data + tableHeader.stringResourcesOffset);
+				return strings.get(tableHeader.hashValue);
 			}
 
-			binary_table* binary_reader::read_table(std::istream& stream, std::streamoff offset, ReadFlag flag)
+			bool binary_reader::is_compressed(const char* data, size_t size)
 			{
-				table_header tableHeader;
-				table_info tableInfo;
+				if (size < sizeof(compressed_table_header))
+					return false;
+				int magicValue;
+				memcpy(&magicValue, data, sizeof(int));
+				return magicValue == compressed_table_magic_value;
+			}
 
-				stream.seekg(offset, std::ios::beg);
-				stream.read((char*)&tableHeader, sizeof(table_header));
+			void binary_reader::decompress_table(const char* data, std::vector<char>& buffer)
+			{
+				compressed_table_header header;
+				memcpy(&header, data, sizeof(compressed_table_header));
+				if (header.codec != table_codec_lz4 || header.rawSize < (long long)sizeof(table_header) || header.compressedSize < 0)
+					throw std::runtime_error("지원하지 않는 테이블 압축 형식입니다.");
 
-				stream.seekg(tableHeader.tableInfoOffset + offset, std::ios::beg);
-				stream.read((char*)&tableInfo, sizeof(table_info));
+				buffer.assign((size_t)header.rawSize, 0);
+				lz4_block::decompress(data + sizeof(compressed_table_header), (size_t)header.compressedSize, &buffer.front(), buffer.size());
+			}
+
+			// stats 가 있으면 단계마다 걸린 시간과 크기를 채웁니다.
+			binary_table* binary_reader::read_table(const char* data, const std::vector<char>& buffer, initable_stats* stats)
+			{
+				const table_header& tableHeader = *(const table_header*)data;
+				const table_info& tableInfo = *(const table_info*)(data + tableHeader.tableInfoOffset);
+				long long last = stats != nullptr ? binary_reader::now() : 0;
+				auto lap = [&](long long initable_stats::* phase)
+				{
+					if (stats == nullptr)
+						return;
+					long long time = binary_reader::now();
+					stats->*phase = time - last;
+					last = time;
+				};
 
 				binary_table* table = new binary_table(this, tableInfo.columnCount, tableInfo.rowCount);
 
-				stream.seekg(tableHeader.stringResourcesOffset + offset, std::ios::beg);
-				string_resource::read(stream);
+				table->m_strings.read(data + tableHeader.stringResourcesOffset);
+				lap(&initable_stats::strings_time);
+
+				binary_reader::read_columns(data + tableHeader.columnsOffset, *table, tableInfo.columnCount);
+				lap(&initable_stats::columns_time);
 
-				stream.seekg(tableHeader.columnsOffset + offset);
-				binary_reader::read_columns(stream, *table, tableInfo.columnCount, flag);
+				// 읽어 온 블럭에는 헤더와 열, 문자열 목록도 있으므로 행 구간만 따로 남기고 블럭은 부른 쪽에서 버립니다.
+				// 메모리 맵으로 연 경우에는 buffer 가 비어 있고 행은 이미지를 그대로 가리킵니다.
+				const char* rows = data + tableHeader.rowsOffset;
+				if (buffer.empty() == false)
+					rows = table->m_rows.assign_arena(rows, (size_t)(tableHeader.stringResourcesOffset - tableHeader.rowsOffset));
+				binary_reader::read_rows(rows, *table, tableInfo.rowCount);
+				lap(&initable_stats::rows_time);
 
-				stream.seekg(tableHeader.rowsOffset + offset, std::ios::beg);
-				binary_reader::read_rows(stream, *table, tableInfo.rowCount);
+				table->m_rows.generate_keys();
+				lap(&initable_stats::index_time);
+				if (stats != nullptr)
+				{
+					stats->raw_bytes = (size_t)tableHeader.userOffset;
+					stats->rows = (size_t)tableInfo.rowCount;
+					stats->columns = (size_t)tableInfo.columnCount;
+					stats->strings = table->m_strings.size();
+				}
 
-				table->m_tableName = string_resource::get(tableInfo.tableName);
-				table->m_categoryName = string_resource::get(tableInfo.categoryName);
-				table->m_hashValue = string_resource::get(tableHeader.hashValue);
+				table->m_tableName = table->m_strings.get(tableInfo.tableName);
+				table->m_categoryName = table->m_strings.get(tableInfo.categoryName);
+				table->m_hashValue = table->m_strings.get(tableHeader.hashValue);
 				return table;
 			}
 
-			void binary_reader::read_columns(std::istream& stream, binary_table& table, size_t columnCount, ReadFlag flag)
+			void binary_reader::read_columns(const char* data, binary_table& table, size_t columnCount)
 			{
-				table.m_columns.set_flag(flag);
+				table.m_columns.set_flag(m_flag);
 
 				for (size_t i = 0; i < columnCount; i++)
 				{
-					column_info columninfo;
-					stream.read((char*)&columninfo, sizeof(column_info));
+					const column_info& columninfo = *((const column_info*)data + i);
 
-					const std::string& columnName = string_resource::get(columninfo.columnName);
-					const std::string& typeName = string_resource::get(columninfo.dataType);
+					const std::string& columnName = table.m_strings.get(columninfo.columnName);
+					const std::string& typeName = table.m_strings.get(columninfo.dataType);
 					bool isKey = columninfo.iskey == 0 ? false : true;
 
 					binary_column* column = new binary_column(columnName, iniutil::name_to_type(typeName), isKey);
@@ -140,19 +454,18 @@ namespace CremaReader {
 				}
 			}
 
-			void binary_reader::read_rows(std::istream& stream, binary_table& table, size_t rowCount)
+			void binary_reader::read_rows(const char* data, binary_table& table, size_t rowCount)
 			{
 				for (size_t i = 0; i < rowCount; i++)
 				{
 					binary_row& dataRow = table.m_rows.at(i);
 
-					int length;
-					stream.read((char*)&length, sizeof(int));
+					int length = *(const int*)data;
+					data += sizeof(int);
 
-					dataRow.reserve_fields_ptr(length);
-					stream.read(dataRow.fields_ptr(), length);
+					dataRow.set_fields(data);
+					data += length;
 					dataRow.set_table(table);
-					table.m_rows.generate_key(i);
 				}
 			}
 		} /*namespace binary*/
@@ -2,8 +2,11 @@
 #include "../include/crema/inireader.h"
 #include "binary_type.h"
 #include "binary_data.h"
+#include "file_istream.h"
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <mutex>
 
 namespace CremaReader {
 	namespace internal {
@@ -17,42 +20,56 @@ namespace CremaReader {
 
 				virtual void read_core(std::istream& stream, ReadFlag flag);
 				virtual void destroy();
+				virtual size_t reclaim();
+#ifndef _IGNORE_BOOST
+				virtual size_t update_core(const std::string& address, int port, const std::string& name);
+#endif
 
-				binary_table* read_table(const std::string& tableName);
 				binary_table* read_table(size_t index);
 
 				virtual const itable_array& tables() const { return m_tables; }
 				virtual const std::string& name() const { return m_name; }
-				virtual const std::string& revision() const { return m_revision; }
+				virtual const std::string& revision() const { return m_revisionInfo.load(std::memory_order_acquire)->revision; }
 				virtual const std::string& types_hash_value() const { return m_typesHashValue; };
-				virtual const std::string& tables_hash_value() const { return m_tablesHashValue; };
+				virtual const std::string& tables_hash_value() const { return m_revisionInfo.load(std::memory_order_acquire)->tablesHashValue; };
 				virtual const std::string& tags() const { return m_tags; };
 
 				binary_table_array m_tables;
 
 			private:
-				binary_table * read_table(std::istream& stream, std::streamoff offset, ReadFlag flag);
-				void read_columns(std::istream& stream, binary_table& dataTable, size_t columnCount, ReadFlag flag);
-				void read_rows(std::istream& stream, binary_table& dataTable, size_t rowCount);
-
-				class findif
+				// update 가 바꾸는 값들입니다. 읽는 쪽이 잠그지 않도록 바꿀 때마다 새로 만들어 교체하고 이전 것은 reclaim 까지 보관합니다.
+				struct revision_info
 				{
-				public:
-					findif(ReadFlag flag, const std::string& tableName) : m_tableName(tableName), m_flag(flag) {}
-					bool operator() (const table_index& index);
-				private:
-					std::string m_tableName;
-					ReadFlag m_flag;
+					std::string revision;
+					std::string tablesHashValue;
 				};
 
+				static revision_info* create_revision(const std::string& revision, const std::string& tablesHashValue);
+				void publish_revision(const revision_info* info);
+				void read_tables(size_t threadCount);
+				binary_table* read_table(const char* data, const std::vector<char>& buffer, initable_stats* stats);
+				void read_block(std::streamoff offset, std::vector<char>& buffer);
+				void read_range(std::streamoff offset, char* buffer, size_t size);
+				std::string read_hash_value(size_t index);
+				static long long now();
+				static bool is_compressed(const char* data, size_t size);
+				static void decompress_table(const char* data, std::vector<char>& buffer);
+				void read_columns(const char* data, binary_table& dataTable, size_t columnCount);
+				void read_rows(const char* data, binary_table& dataTable, size_t rowCount);
+
 			private:
 				std::istream* m_stream;
+				const file_istream* m_file;
+				std::mutex m_streamLock;
+				std::mutex m_updateLock;
+				const char* m_image;
 				std::vector<table_index> m_tableIndexes;
+				string_pool m_strings;
 				ReadFlag m_flag;
 				std::string m_name;
-				std::string m_revision;
+				std::atomic<const revision_info*> m_revisionInfo;
+				std::vector<const revision_info*> m_retiredRevisions;
 				std::string m_typesHashValue;
-				std::string m_tablesHashValue;
 				std::string m_tags;
 			};
 		} /*namespace binary*/
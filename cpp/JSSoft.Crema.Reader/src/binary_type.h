@@ -5,8 +5,16 @@ namespace CremaReader {
 	namespace internal {
 		namespace binary
 		{
+			const int file_magic_value = 0x04000000;
 			const int magic_value_obsolete = 0x6cfc4a14;
 			const int magic_value = 0x03050000;
+			const int compressed_table_magic_value = 0x04000100;
+
+			enum table_codec
+			{
+				table_codec_none,
+				table_codec_lz4,
+			};
 
 			struct table_header
 			{
@@ -20,6 +28,14 @@ namespace CremaReader {
 				long long userOffset;
 			};
 
+			struct compressed_table_header
+			{
+				int magicValue;
+				int codec;
+				long long compressedSize;
+				long long rawSize;
+			};
+
 			struct table_info
 			{
 				int tableName;
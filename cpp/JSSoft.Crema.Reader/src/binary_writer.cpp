@@ -0,0 +1,567 @@
+﻿#include "binary_writer.h"
+#include "lz4_block.h"
+#include "../include/crema/iniutils.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace CremaReader {
+	namespace internal {
+		namespace binary
+		{
+			namespace
+			{
+				template<typename T>
+				inline void append(std::vector<char>& buffer, const T& value)
+				{
+					const char* bytes = (const char*)&value;
+					buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+				}
+
+				inline void append(std::vector<char>& buffer, const void* data, size_t size)
+				{
+					const char* bytes = (const char*)data;
+					buffer.insert(buffer.end(), bytes, bytes + size);
+				}
+
+				template<typename T>
+				inline void patch(std::vector<char>& buffer, size_t offset, const T& value)
+				{
+					memcpy(&buffer[offset], &value, sizeof(T));
+				}
+
+				std::string to_hex(unsigned long long value)
+				{
+					std::ostringstream stream;
+					stream << std::hex << std::setw(16) << std::setfill('0') << value;
+					return stream.str();
+				}
+			}
+
+			binary_string_ids::binary_string_ids()
+			{
+				for (unsigned int i = 0; i < shard_count; i++)
+				{
+					m_shards[i].slots.assign(16, slot());
+					m_shards[i].count = 0;
+					m_shards[i].shift = 64 - 4;
+				}
+			}
+
+			size_t binary_string_ids::position(const shard& item, int id)
+			{
+				return (size_t)(((unsigned long long)(unsigned int)id * 0x9e3779b97f4a7c15ULL) >> item.shift);
+			}
+
+			void binary_string_ids::grow(shard& item)
+			{
+				std::vector<slot> slots(item.slots.size() * 2, slot());
+				slots.swap(item.slots);
+				item.shift--;
+
+				const size_t mask = item.slots.size() - 1;
+				for (size_t i = 0; i < slots.size(); i++)
+				{
+					if (slots[i].id == 0)
+						continue;
+					size_t index = binary_string_ids::position(item, slots[i].id);
+					while (item.slots[index].id != 0)
+						index = (index + 1) & mask;
+					item.slots[index] = slots[i];
+				}
+			}
+
+			int binary_string_ids::get(const char* text, size_t length, unsigned long long fingerprint)
+			{
+				unsigned int id = (unsigned int)iniutil::get_hash_code(text, length);
+				shard& item = m_shards[id % shard_count];
+
+				std::lock_guard<std::mutex> lock(item.lock);
+				if ((item.count + 1) * 2 > item.slots.size())
+					binary_string_ids::grow(item);
+
+				const size_t mask = item.slots.size() - 1;
+				for (;; id += shard_count)
+				{
+					if (id == 0)
+						continue;
+					size_t index = binary_string_ids::position(item, (int)id);
+					while (item.slots[index].id != 0 && item.slots[index].id != (int)id)
+						index = (index + 1) & mask;
+
+					slot& found = item.slots[index];
+					if (found.id == 0)
+					{
+						found.id = (int)id;
+						found.fingerprint = fingerprint;
+						item.count++;
+						return (int)id;
+					}
+					if (found.fingerprint == fingerprint)
+						return (int)id;
+				}
+			}
+
+			binary_string_block::binary_string_block(binary_string_ids& ids)
+				: m_ids(ids), m_slots(16, 0)
+			{
+
+			}
+
+			void binary_string_block::grow()
+			{
+				m_slots.assign(m_slots.size() * 2, 0);
+				const size_t mask = m_slots.size() - 1;
+				for (size_t i = 0; i < m_entries.size(); i++)
+				{
+					size_t index = (size_t)m_entries[i].fingerprint & mask;
+					while (m_slots[index] != 0)
+						index = (index + 1) & mask;
+					m_slots[index] = (unsigned int)(i + 1);
+				}
+			}
+
+			int binary_string_block::add(const char* text, size_t length)
+			{
+				if (length == 0)
+					return 0;
+
+				const unsigned long long fingerprint = iniutil::hash(text, length);
+				const size_t mask = m_slots.size() - 1;
+				size_t index = (size_t)fingerprint & mask;
+				for (; m_slots[index] != 0; index = (index + 1) & mask)
+				{
+					const entry& item = m_entries[m_slots[index] - 1];
+					if (item.fingerprint == fingerprint && item.length == length && memcmp(&m_text[item.offset], text, length) == 0)
+						return item.id;
+				}
+
+				entry item;
+				item.offset = m_text.size();
+				item.length = length;
+				item.fingerprint = fingerprint;
+				item.id = m_ids.get(text, length, fingerprint);
+				m_text.insert(m_text.end(), text, text + length);
+				m_entries.push_back(item);
+				m_slots[index] = (unsigned int)m_entries.size();
+
+				if (m_entries.size() * 2 > m_slots.size())
+					this->grow();
+				return item.id;
+			}
+
+			void binary_string_block::write(std::vector<char>& buffer) const
+			{
+				append(buffer, (int)m_entries.size());
+				for (size_t i = 0; i < m_entries.size(); i++)
+				{
+					const entry& item = m_entries[i];
+					append(buffer, item.id);
+					append(buffer, (int)item.length);
+					if (item.length != 0)
+						append(buffer, &m_text[item.offset], item.length);
+				}
+			}
+
+			binary_table_writer::binary_table_writer(binary_string_ids& ids, const std::string& tableName, const std::string& categoryName, const std::vector<iniwriter_column>& columns)
+				: m_strings(ids), m_tableName(tableName), m_categoryName(categoryName), m_columns(columns),
+				m_values(columns.size(), 0), m_hasValues(columns.size(), false)
+			{
+				for (size_t i = 0; i < columns.size(); i++)
+				{
+					m_layouts.push_back(binary_table_writer::layout(columns[i].type_name));
+				}
+			}
+
+			binary_table_writer::~binary_table_writer()
+			{
+
+			}
+
+			binary_table_writer::column_layout binary_table_writer::layout(const std::string& typeName)
+			{
+				column_layout layout;
+				if (typeName == "string" || typeName == "guid")
+				{
+					layout.kind = value_kind_string;
+					layout.size = sizeof(int);
+				}
+				else if (typeName == "float" || typeName == "double")
+				{
+					layout.kind = value_kind_real;
+					layout.size = typeName == "float" ? sizeof(float) : sizeof(double);
+				}
+				else if (typeName == "boolean" || typeName == "byte" || typeName == "unsignedByte" || typeName == "short" || typeName == "unsignedShort" ||
+					typeName == "int" || typeName == "unsignedInt" || typeName == "long" || typeName == "unsignedLong" || typeName == "dateTime" || typeName == "duration")
+				{
+					layout.kind = value_kind_integer;
+					layout.size = (size_t)iniutil::get_type_size(iniutil::name_to_type(typeName));
+				}
+				else
+				{
+					throw std::invalid_argument("지원하지 않는 열 타입입니다: " + typeName);
+				}
+				return layout;
+			}
+
+			void binary_table_writer::set_null(size_t index)
+			{
+				m_hasValues.at(index) = false;
+			}
+
+			void binary_table_writer::set_integer(size_t index, long long value)
+			{
+				switch (m_layouts.at(index).kind)
+				{
+				case value_kind_integer:
+					m_values[index] = value;
+					break;
+				case value_kind_real:
+					this->set_real(index, (double)value);
+					return;
+				default:
+					throw std::invalid_argument("열의 타입과 맞지 않는 값입니다.");
+				}
+				m_hasValues[index] = true;
+			}
+
+			void binary_table_writer::set_real(size_t index, double value)
+			{
+				const column_layout& layout = m_layouts.at(index);
+				switch (layout.kind)
+				{
+				case value_kind_integer:
+					m_values[index] = (long long)value;
+					break;
+				case value_kind_real:
+					if (layout.size == sizeof(float))
+					{
+						float real = (float)value;
+						memcpy(&m_values[index], &real, sizeof(float));
+					}
+					else
+					{
+						memcpy(&m_values[index], &value, sizeof(double));
+					}
+					break;
+				default:
+					throw std::invalid_argument("열의 타입과 맞지 않는 값입니다.");
+				}
+				m_hasValues[index] = true;
+			}
+
+			void binary_table_writer::set_string(size_t index, const char* text, size_t length)
+			{
+				if (m_layouts.at(index).kind != value_kind_string)
+					throw std::invalid_argument("열의 타입과 맞지 않는 값입니다.");
+				m_values[index] = m_strings.add(text, length);
+				m_hasValues[index] = true;
+			}
+
+			void binary_table_writer::write_row(std::vector<char>& buffer)
+			{
+				size_t lengthOffset = buffer.size();
+				append(buffer, (int)0);
+
+				size_t fieldsOffset = buffer.size();
+				buffer.resize(buffer.size() + sizeof(int) * m_columns.size(), 0);
+
+				for (size_t i = 0; i < m_columns.size(); i++)
+				{
+					if (m_hasValues[i] == false)
+						continue;
+					patch(buffer, fieldsOffset + sizeof(int) * i, (int)(buffer.size() - fieldsOffset));
+					append(buffer, &m_values[i], m_layouts[i].size);
+				}
+
+				patch(buffer, lengthOffset, (int)(buffer.size() - fieldsOffset));
+			}
+
+			void binary_table_writer::write(size_t rowCount, const row_generator& generator, std::vector<char>& buffer)
+			{
+				buffer.clear();
+
+				table_header header;
+				memset(&header, 0, sizeof(header));
+				header.magicValue = magic_value;
+				header.modifiedTime = (long long)time(nullptr);
+				append(buffer, header);
+
+				table_info info;
+				info.tableName = m_strings.add(m_tableName);
+				info.categoryName = m_strings.add(m_categoryName);
+				info.columnCount = (int)m_columns.size();
+				info.rowCount = (int)rowCount;
+				header.tableInfoOffset = (long long)buffer.size();
+				append(buffer, info);
+
+				header.columnsOffset = (long long)buffer.size();
+				for (size_t i = 0; i < m_columns.size(); i++)
+				{
+					column_info column;
+					column.columnName = m_strings.add(m_columns[i].name);
+					column.dataType = m_strings.add(m_columns[i].type_name);
+					column.iskey = m_columns[i].is_key == true ? 1 : 0;
+					append(buffer, column);
+				}
+
+				header.rowsOffset = (long long)buffer.size();
+				for (size_t i = 0; i < rowCount; i++)
+				{
+					std::fill(m_hasValues.begin(), m_hasValues.end(), false);
+					generator(i, *this);
+					this->write_row(buffer);
+				}
+
+				const char* rows = buffer.data() + header.rowsOffset;
+				header.hashValue = m_strings.add(to_hex(iniutil::hash(rows, buffer.size() - (size_t)header.rowsOffset)));
+
+				header.stringResourcesOffset = (long long)buffer.size();
+				m_strings.write(buffer);
+
+				header.userOffset = (long long)buffer.size();
+				patch(buffer, 0, header);
+			}
+
+			binary_writer::binary_writer(const std::string& name)
+				: m_name(name), m_compression(false), m_threadCount(0)
+			{
+
+			}
+
+			binary_writer::~binary_writer()
+			{
+
+			}
+
+			void binary_writer::destroy()
+			{
+				delete this;
+			}
+
+			void binary_writer::add_table(const std::string& tableName, const std::string& categoryName, const std::vector<iniwriter_column>& columns, size_t rowCount, const row_generator& generator)
+			{
+				for (size_t i = 0; i < columns.size(); i++)
+				{
+					binary_table_writer::layout(columns[i].type_name);
+				}
+
+				table_entry entry;
+				entry.tableName = tableName;
+				entry.categoryName = categoryName;
+				entry.columns = columns;
+				entry.rowCount = rowCount;
+				entry.generator = generator;
+				m_tables.push_back(entry);
+			}
+
+			void binary_writer::set_revision(const std::string& revision)
+			{
+				m_revision = revision;
+			}
+
+			void binary_writer::set_tags(const std::string& tags)
+			{
+				m_tags = tags;
+			}
+
+			void binary_writer::set_compression(bool compression)
+			{
+				m_compression = compression;
+			}
+
+			void binary_writer::set_thread_count(size_t count)
+			{
+				m_threadCount = count;
+			}
+
+			// hash 는 modifiedTime 이 있는 헤더를 뺀 나머지로 만들어서 같은 내용이면 같은 값이 되도록 합니다.
+			void binary_writer::encode_table(binary_string_ids& ids, size_t index, std::vector<char>& buffer, unsigned long long& hash) const
+			{
+				const table_entry& entry = m_tables[index];
+				binary_table_writer writer(ids, entry.tableName, entry.categoryName, entry.columns);
+				writer.write(entry.rowCount, entry.generator, buffer);
+				hash = iniutil::hash(buffer.data() + sizeof(table_header), buffer.size() - sizeof(table_header));
+				if (m_compression == true)
+					binary_writer::compress_table(buffer);
+			}
+
+			void binary_writer::compress_table(std::vector<char>& buffer)
+			{
+				std::vector<char> compressed(sizeof(compressed_table_header) + lz4_block::compress_bound(buffer.size()));
+				size_t size = lz4_block::compress(buffer.data(), buffer.size(), &compressed.front() + sizeof(compressed_table_header));
+
+				compressed_table_header header;
+				header.magicValue = compressed_table_magic_value;
+				header.codec = table_codec_lz4;
+				header.compressedSize = (long long)size;
+				header.rawSize = (long long)buffer.size();
+				patch(compressed, 0, header);
+
+				compressed.resize(sizeof(compressed_table_header) + size);
+				buffer.swap(compressed);
+			}
+
+			void binary_writer::write(const std::string& filename)
+			{
+				std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+				if (stream.is_open() == false)
+					throw std::invalid_argument("파일을 만들 수 없습니다: " + filename);
+				this->write(stream);
+			}
+
+			// 테이블 블럭은 작업 스레드가 만들고 이 스레드가 순서대로 씁니다. 헤더와 인덱스는 마지막에 처음 위치로 돌아가 채우므로
+			// stream 은 seekp 를 지원해야 합니다.
+			void binary_writer::write(std::ostream& stream)
+			{
+				binary_string_ids ids;
+				binary_string_block strings(ids);
+				const size_t tableCount = m_tables.size();
+				const std::streamoff origin = (std::streamoff)stream.tellp();
+
+				file_header header;
+				memset(&header, 0, sizeof(header));
+				header.magicValue = file_magic_value;
+				header.tableCount = (int)tableCount;
+				header.indexOffset = (long long)sizeof(file_header);
+				header.tablesOffset = header.indexOffset + (long long)(sizeof(table_index) * tableCount);
+
+				std::vector<table_index> indexes(tableCount);
+				std::vector<char> placeholder((size_t)header.tablesOffset, 0);
+				stream.write(placeholder.data(), placeholder.size());
+
+				size_t threadCount = m_threadCount != 0 ? m_threadCount : std::thread::hardware_concurrency();
+				threadCount = std::max<size_t>(1, std::min(threadCount, tableCount));
+				const size_t window = threadCount * 2;
+
+				std::vector<std::vector<char> > blocks(tableCount);
+				std::vector<unsigned long long> hashes(tableCount);
+				std::vector<bool> ready(tableCount, false);
+				size_t next = 0;
+				size_t written = 0;
+				bool failed = false;
+				std::exception_ptr error;
+				std::mutex lock;
+				std::condition_variable changed;
+
+				auto worker = [&]()
+				{
+					std::vector<char> buffer;
+					for (;;)
+					{
+						size_t index;
+						{
+							std::unique_lock<std::mutex> guard(lock);
+							changed.wait(guard, [&]() { return failed == true || next >= tableCount || next < written + window; });
+							if (failed == true || next >= tableCount)
+								return;
+							index = next++;
+						}
+
+						try
+						{
+							this->encode_table(ids, index, buffer, hashes[index]);
+						}
+						catch (...)
+						{
+							std::lock_guard<std::mutex> guard(lock);
+							if (error == nullptr)
+								error = std::current_exception();
+							failed = true;
+							changed.notify_all();
+							return;
+						}
+
+						std::lock_guard<std::mutex> guard(lock);
+						blocks[index].swap(buffer);
+						ready[index] = true;
+						changed.notify_all();
+					}
+				};
+
+				std::vector<std::thread> threads;
+				threads.reserve(threadCount);
+				for (size_t i = 0; i < threadCount && tableCount != 0; i++)
+				{
+					threads.push_back(std::thread(worker));
+				}
+
+				long long offset = header.tablesOffset;
+				std::vector<char> buffer;
+				for (size_t i = 0; i < tableCount; i++)
+				{
+					{
+						std::unique_lock<std::mutex> guard(lock);
+						changed.wait(guard, [&]() { return failed == true || ready[i] == true; });
+						if (failed == true)
+							break;
+						buffer.swap(blocks[i]);
+						written = i + 1;
+						changed.notify_all();
+					}
+
+					stream.write(buffer.data(), buffer.size());
+					if (stream.good() == false)
+					{
+						std::lock_guard<std::mutex> guard(lock);
+						failed = true;
+						changed.notify_all();
+						break;
+					}
+
+					indexes[i].tableName = strings.add(m_tables[i].tableName);
+					indexes[i].dummy = 0;
+					indexes[i].offset = offset;
+					offset += (long long)buffer.size();
+					std::vector<char>().swap(buffer);
+				}
+
+				for (size_t i = 0; i < threads.size(); i++)
+				{
+					threads[i].join();
+				}
+				if (error != nullptr)
+					std::rethrow_exception(error);
+				if (failed == true)
+					throw std::runtime_error("파일을 쓸 수 없습니다.");
+
+				std::vector<char> types;
+				for (size_t i = 0; i < tableCount; i++)
+				{
+					const std::vector<iniwriter_column>& columns = m_tables[i].columns;
+					for (size_t j = 0; j < columns.size(); j++)
+					{
+						append(types, columns[j].type_name.data(), columns[j].type_name.length() + 1);
+					}
+				}
+
+				header.name = strings.add(m_name);
+				header.revision = strings.add(m_revision);
+				header.typesHashValue = strings.add(to_hex(iniutil::hash(types.data(), types.size())));
+				header.tablesHashValue = strings.add(to_hex(tableCount != 0 ? iniutil::hash(&hashes.front(), sizeof(unsigned long long) * tableCount) : 0));
+				header.tags = strings.add(m_tags);
+				header.stringResourcesOffset = offset;
+
+				strings.write(buffer);
+				stream.write(buffer.data(), buffer.size());
+
+				std::streamoff end = (std::streamoff)stream.tellp();
+				stream.seekp(origin);
+				stream.write((const char*)&header, sizeof(header));
+				if (tableCount != 0)
+					stream.write((const char*)&indexes.front(), sizeof(table_index) * tableCount);
+				stream.seekp(end);
+				if (stream.good() == false)
+					throw std::runtime_error("파일을 쓸 수 없습니다.");
+			}
+		} /*namespace binary*/
+	} /*namespace internal*/
+} /*namespace CremaReader*/
@@ -0,0 +1,162 @@
+﻿#pragma once
+#include "../include/crema/iniwriter.h"
+#include "binary_type.h"
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CremaReader {
+	namespace internal {
+		namespace binary
+		{
+			// 문자열 아이디를 데이터 전체에서 한번만 정합니다. 리더는 아이디가 같으면 같은 문자열로 보기 때문입니다.
+			// 아이디는 문자열 해시에서 시작하고, 다른 문자열이 이미 쓰고 있으면 shard_count 씩 건너뛰어 같은 조각 안에서 찾습니다.
+			// 조각마다 잠금이 따로 있고, 문자열 대신 64비트 지문만 열린 주소 표에 보관합니다.
+			class binary_string_ids
+			{
+			public:
+				binary_string_ids();
+
+				int get(const char* text, size_t length, unsigned long long fingerprint);
+
+			private:
+				static const unsigned int shard_count = 64;
+
+				struct slot
+				{
+					int id;
+					unsigned long long fingerprint;
+				};
+
+				struct shard
+				{
+					std::mutex lock;
+					std::vector<slot> slots;
+					size_t count;
+					unsigned int shift;
+				};
+
+				static void grow(shard& item);
+				static size_t position(const shard& item, int id);
+
+			private:
+				shard m_shards[shard_count];
+			};
+
+			// 테이블이나 파일 하나가 참조하는 문자열 목록입니다. 문자열은 한 버퍼에 이어 붙여 두고 지문으로 찾습니다.
+			class binary_string_block
+			{
+			public:
+				binary_string_block(binary_string_ids& ids);
+
+				int add(const char* text, size_t length);
+				int add(const std::string& text) { return this->add(text.c_str(), text.length()); }
+				void write(std::vector<char>& buffer) const;
+
+			private:
+				struct entry
+				{
+					size_t offset;
+					size_t length;
+					unsigned long long fingerprint;
+					int id;
+				};
+
+				void grow();
+
+			private:
+				binary_string_ids& m_ids;
+				std::vector<char> m_text;
+				std::vector<entry> m_entries;
+				// m_entries 의 순번 + 1 입니다. 0 은 빈 칸입니다.
+				std::vector<unsigned int> m_slots;
+			};
+
+			// 테이블 하나를 table_header 부터 문자열 목록까지 한 블럭으로 만듭니다.
+			class binary_table_writer : public iwriter_row
+			{
+			public:
+				enum value_kind
+				{
+					value_kind_integer,
+					value_kind_real,
+					value_kind_string,
+				};
+
+				struct column_layout
+				{
+					value_kind kind;
+					size_t size;
+				};
+
+				// 지원하지 않는 타입이면 std::invalid_argument 를 던집니다.
+				static column_layout layout(const std::string& typeName);
+
+				binary_table_writer(binary_string_ids& ids, const std::string& tableName, const std::string& categoryName, const std::vector<iniwriter_column>& columns);
+				virtual ~binary_table_writer();
+
+				void write(size_t rowCount, const row_generator& generator, std::vector<char>& buffer);
+
+				virtual void set_null(size_t index);
+
+			protected:
+				virtual void set_integer(size_t index, long long value);
+				virtual void set_real(size_t index, double value);
+				virtual void set_string(size_t index, const char* text, size_t length);
+
+			private:
+				void write_row(std::vector<char>& buffer);
+
+			private:
+				binary_string_block m_strings;
+				std::string m_tableName;
+				std::string m_categoryName;
+				std::vector<iniwriter_column> m_columns;
+				std::vector<column_layout> m_layouts;
+				std::vector<long long> m_values;
+				std::vector<bool> m_hasValues;
+			};
+
+			class binary_writer : public CremaWriter
+			{
+			public:
+				binary_writer(const std::string& name);
+				virtual ~binary_writer();
+
+				virtual void add_table(const std::string& tableName, const std::string& categoryName, const std::vector<iniwriter_column>& columns, size_t rowCount, const row_generator& generator);
+
+				virtual void set_revision(const std::string& revision);
+				virtual void set_tags(const std::string& tags);
+				virtual void set_compression(bool compression);
+				virtual void set_thread_count(size_t count);
+
+				virtual void write(const std::string& filename);
+				virtual void write(std::ostream& stream);
+
+				virtual void destroy();
+
+			private:
+				struct table_entry
+				{
+					std::string tableName;
+					std::string categoryName;
+					std::vector<iniwriter_column> columns;
+					size_t rowCount;
+					row_generator generator;
+				};
+
+				void encode_table(binary_string_ids& ids, size_t index, std::vector<char>& buffer, unsigned long long& hash) const;
+				static void compress_table(std::vector<char>& buffer);
+
+			private:
+				std::string m_name;
+				std::string m_revision;
+				std::string m_tags;
+				bool m_compression;
+				size_t m_threadCount;
+				std::vector<table_entry> m_tables;
+			};
+		} /*namespace binary*/
+	} /*namespace internal*/
+} /*namespace CremaReader*/
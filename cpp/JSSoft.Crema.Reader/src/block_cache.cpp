@@ -0,0 +1,113 @@
+﻿#include "block_cache.h"
+#include "../include/crema/iniutils.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace CremaReader {
+	namespace internal
+	{
+		namespace
+		{
+			unsigned long long process_id()
+			{
+#ifdef _MSC_VER
+				return (unsigned long long)_getpid();
+#else
+				return (unsigned long long)getpid();
+#endif
+			}
+		}
+
+		block_cache::block_cache()
+		{
+
+		}
+
+		void block_cache::open(const std::string& directory, const std::string& name, const binary::file_header& header, long long length)
+		{
+			m_directory = directory;
+			m_key.clear();
+			if (directory.empty() == true)
+				return;
+
+			std::ostringstream key;
+			key << name << '\n' << header.magicValue << '\n' << header.revision << '\n' << header.typesHashValue << '\n' << header.tablesHashValue
+				<< '\n' << header.tags << '\n' << header.tableCount << '\n' << header.name << '\n' << header.indexOffset << '\n' << header.tablesOffset
+				<< '\n' << header.stringResourcesOffset << '\n' << length;
+			std::string text = key.str();
+
+			std::ostringstream out;
+			out << std::hex << std::setw(16) << std::setfill('0') << iniutil::hash(text.data(), text.length());
+			m_key = out.str();
+		}
+
+		std::string block_cache::block_path(long long pos) const
+		{
+			std::ostringstream path;
+			path << m_directory << '/' << m_key << '-' << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long)pos << ".block";
+			return path.str();
+		}
+
+		bool block_cache::load(long long pos, char* dest, size_t size) const
+		{
+			if (this->is_open() == false)
+				return false;
+
+			std::string path = this->block_path(pos);
+			std::ifstream stream(path.c_str(), std::ios::binary);
+			if (stream.is_open() == false)
+				return false;
+
+			unsigned long long checksum = 0;
+			stream.read(dest, size);
+			bool valid = (size_t)stream.gcount() == size;
+			if (valid == true)
+			{
+				stream.read((char*)&checksum, sizeof(checksum));
+				valid = stream.gcount() == sizeof(checksum) && stream.peek() == std::ifstream::traits_type::eof() && checksum == iniutil::hash(dest, size);
+			}
+			stream.close();
+
+			if (valid == false)
+				std::remove(path.c_str());
+			return valid;
+		}
+
+		void block_cache::store(long long pos, const char* data, size_t size) const
+		{
+			if (this->is_open() == false)
+				return;
+
+			// 여러 프로세스가 같은 블럭을 함께 쓸 수 있으므로 임시 파일 이름에 프로세스와 객체를 넣습니다.
+			std::string path = this->block_path(pos);
+			std::ostringstream temp;
+			temp << path << '.' << std::hex << process_id() << '.' << (unsigned long long)(size_t)this << ".tmp";
+			std::string tempPath = temp.str();
+
+			std::ofstream stream(tempPath.c_str(), std::ios::binary);
+			if (stream.is_open() == false)
+				return;
+
+			unsigned long long checksum = iniutil::hash(data, size);
+			stream.write(data, size);
+			stream.write((const char*)&checksum, sizeof(checksum));
+			stream.close();
+
+			if (stream.fail() == true)
+			{
+				std::remove(tempPath.c_str());
+				return;
+			}
+
+			if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+				std::remove(tempPath.c_str());
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#include "binary_type.h"
+#include <string>
+
+namespace CremaReader {
+	namespace internal
+	{
+		// 서버에서 받은 블럭을 캐시 디렉터리에 보관합니다.
+		// 키는 이름과 파일 헤더, 길이로만 정하므로 키를 정하려고 헤더 말고는 받지 않습니다.
+		// 블럭 파일 끝에는 내용의 해시를 붙여 두고 읽을 때 맞지 않으면 그 파일을 버립니다.
+		class block_cache
+		{
+		public:
+			block_cache();
+
+			void open(const std::string& directory, const std::string& name, const binary::file_header& header, long long length);
+			bool is_open() const { return m_key.empty() == false; }
+
+			bool load(long long pos, char* dest, size_t size) const;
+			void store(long long pos, const char* data, size_t size) const;
+
+		private:
+			std::string block_path(long long pos) const;
+
+		private:
+			std::string m_directory;
+			std::string m_key;
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
@@ -0,0 +1,473 @@
+﻿#include "column_scan.h"
+#include "internal_utils.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CREMA_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace CremaReader {
+	namespace internal
+	{
+		namespace
+		{
+			const size_t in_linear_limit = 8;
+
+			inline unsigned int count_trailing_zeros(unsigned long long value)
+			{
+#if defined(_MSC_VER) && defined(_M_X64)
+				unsigned long index;
+				_BitScanForward64(&index, value);
+				return index;
+#elif defined(__GNUC__)
+				return __builtin_ctzll(value);
+#else
+				unsigned int count = 0;
+				while ((value & 1) == 0)
+				{
+					value >>= 1;
+					count++;
+				}
+				return count;
+#endif
+			}
+
+			struct scan_equal
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v == a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_cmpeq_epi32(v, a); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmpeq_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmpeq_pd(v, a); }
+#endif
+			};
+
+			struct scan_not_equal
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v != a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_xor_si128(_mm_cmpeq_epi32(v, a), _mm_cmpeq_epi32(v, v)); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmpneq_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmpneq_pd(v, a); }
+#endif
+			};
+
+			struct scan_less
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v < a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_cmplt_epi32(v, a); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmplt_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmplt_pd(v, a); }
+#endif
+			};
+
+			struct scan_less_equal
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v <= a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_xor_si128(_mm_cmpgt_epi32(v, a), _mm_cmpeq_epi32(v, v)); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmple_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmple_pd(v, a); }
+#endif
+			};
+
+			struct scan_greater
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v > a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_cmpgt_epi32(v, a); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmpgt_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmpgt_pd(v, a); }
+#endif
+			};
+
+			struct scan_greater_equal
+			{
+				template<typename W>
+				static bool test(W v, W a, W) { return v >= a; }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i) { return _mm_xor_si128(_mm_cmplt_epi32(v, a), _mm_cmpeq_epi32(v, v)); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128) { return _mm_cmpge_ps(v, a); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d) { return _mm_cmpge_pd(v, a); }
+#endif
+			};
+
+			struct scan_between
+			{
+				template<typename W>
+				static bool test(W v, W a, W b) { return (v >= a) & (v <= b); }
+#ifdef CREMA_SCAN_SSE2
+				static __m128i test_epi32(__m128i v, __m128i a, __m128i b) { return _mm_xor_si128(_mm_or_si128(_mm_cmplt_epi32(v, a), _mm_cmpgt_epi32(v, b)), _mm_cmpeq_epi32(v, v)); }
+				static __m128 test_ps(__m128 v, __m128 a, __m128 b) { return _mm_and_ps(_mm_cmpge_ps(v, a), _mm_cmple_ps(v, b)); }
+				static __m128d test_pd(__m128d v, __m128d a, __m128d b) { return _mm_and_pd(_mm_cmpge_pd(v, a), _mm_cmple_pd(v, b)); }
+#endif
+			};
+
+			template<typename C, typename T, typename W>
+			void scan_kernel(const T* values, size_t size, W a, W b, unsigned long long* result)
+			{
+				for (size_t base = 0, word = 0; base < size; base += 64, word++)
+				{
+					size_t count = std::min<size_t>(64, size - base);
+					const T* block = values + base;
+					unsigned long long bits = 0;
+					for (size_t i = 0; i < count; i++)
+					{
+						bits |= (unsigned long long)C::test((W)block[i], a, b) << i;
+					}
+					result[word] = bits;
+				}
+			}
+
+#ifdef CREMA_SCAN_SSE2
+			template<typename C>
+			void scan_kernel(const int* values, size_t size, int a, int b, unsigned long long* result)
+			{
+				__m128i va = _mm_set1_epi32(a);
+				__m128i vb = _mm_set1_epi32(b);
+				for (size_t base = 0, word = 0; base < size; base += 64, word++)
+				{
+					size_t count = std::min<size_t>(64, size - base);
+					const int* block = values + base;
+					unsigned long long bits = 0;
+					size_t i = 0;
+					for (; i + 4 <= count; i += 4)
+					{
+						__m128i v = _mm_loadu_si128((const __m128i*)(block + i));
+						bits |= (unsigned long long)_mm_movemask_ps(_mm_castsi128_ps(C::test_epi32(v, va, vb))) << i;
+					}
+					for (; i < count; i++)
+					{
+						bits |= (unsigned long long)C::test(block[i], a, b) << i;
+					}
+					result[word] = bits;
+				}
+			}
+
+			template<typename C>
+			void scan_kernel(const float* values, size_t size, float a, float b, unsigned long long* result)
+			{
+				__m128 va = _mm_set1_ps(a);
+				__m128 vb = _mm_set1_ps(b);
+				for (size_t base = 0, word = 0; base < size; base += 64, word++)
+				{
+					size_t count = std::min<size_t>(64, size - base);
+					const float* block = values + base;
+					unsigned long long bits = 0;
+					size_t i = 0;
+					for (; i + 4 <= count; i += 4)
+					{
+						__m128 v = _mm_loadu_ps(block + i);
+						bits |= (unsigned long long)_mm_movemask_ps(C::test_ps(v, va, vb)) << i;
+					}
+					for (; i < count; i++)
+					{
+						bits |= (unsigned long long)C::test(block[i], a, b) << i;
+					}
+					result[word] = bits;
+				}
+			}
+
+			template<typename C>
+			void scan_kernel(const double* values, size_t size, double a, double b, unsigned long long* result)
+			{
+				__m128d va = _mm_set1_pd(a);
+				__m128d vb = _mm_set1_pd(b);
+				for (size_t base = 0, word = 0; base < size; base += 64, word++)
+				{
+					size_t count = std::min<size_t>(64, size - base);
+					const double* block = values + base;
+					unsigned long long bits = 0;
+					size_t i = 0;
+					for (; i + 2 <= count; i += 2)
+					{
+						__m128d v = _mm_loadu_pd(block + i);
+						bits |= (unsigned long long)_mm_movemask_pd(C::test_pd(v, va, vb)) << i;
+					}
+					for (; i < count; i++)
+					{
+						bits |= (unsigned long long)C::test(block[i], a, b) << i;
+					}
+					result[word] = bits;
+				}
+			}
+#endif
+
+			template<typename T, typename W>
+			void scan_op(const T* values, size_t size, inipredicate::op_type op, W a, W b, unsigned long long* result)
+			{
+				switch (op)
+				{
+				case inipredicate::op_equal:
+				case inipredicate::op_in:
+					scan_kernel<scan_equal>(values, size, a, b, result);
+					break;
+				case inipredicate::op_not_equal:
+					scan_kernel<scan_not_equal>(values, size, a, b, result);
+					break;
+				case inipredicate::op_less:
+					scan_kernel<scan_less>(values, size, a, b, result);
+					break;
+				case inipredicate::op_less_equal:
+					scan_kernel<scan_less_equal>(values, size, a, b, result);
+					break;
+				case inipredicate::op_greater:
+					scan_kernel<scan_greater>(values, size, a, b, result);
+					break;
+				case inipredicate::op_greater_equal:
+					scan_kernel<scan_greater_equal>(values, size, a, b, result);
+					break;
+				case inipredicate::op_between:
+					scan_kernel<scan_between>(values, size, a, b, result);
+					break;
+				default:
+					break;
+				}
+			}
+
+			template<typename W>
+			W to_literal(const inikey_value& value);
+
+			template<> long long to_literal<long long>(const inikey_value& value) { return value.to_integer(); }
+			template<> unsigned long long to_literal<unsigned long long>(const inikey_value& value) { return value.to_unsigned(); }
+			template<> int to_literal<int>(const inikey_value& value) { return (int)value.to_integer(); }
+			template<> float to_literal<float>(const inikey_value& value) { return (float)value.to_real(); }
+			template<> double to_literal<double>(const inikey_value& value) { return value.to_real(); }
+
+			template<typename T, typename W>
+			void scan_column(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& result)
+			{
+				const T* values = data.values<T>();
+				size_t size = data.size();
+				const std::vector<inikey_value>& literals = predicate.values();
+
+				if (predicate.op() != inipredicate::op_in)
+				{
+					W a = to_literal<W>(literals[0]);
+					W b = literals.size() > 1 ? to_literal<W>(literals[1]) : a;
+					scan_op(values, size, predicate.op(), a, b, &result.front());
+					return;
+				}
+
+				std::fill(result.begin(), result.end(), 0);
+				if (literals.size() <= in_linear_limit)
+				{
+					std::vector<unsigned long long> bits(result.size());
+					for (size_t i = 0; i < literals.size(); i++)
+					{
+						W a = to_literal<W>(literals[i]);
+						scan_op(values, size, inipredicate::op_equal, a, a, &bits.front());
+						for (size_t w = 0; w < result.size(); w++)
+						{
+							result[w] |= bits[w];
+						}
+					}
+					return;
+				}
+
+				std::vector<W> set(literals.size());
+				for (size_t i = 0; i < literals.size(); i++)
+				{
+					set[i] = to_literal<W>(literals[i]);
+				}
+				std::sort(set.begin(), set.end());
+				for (size_t i = 0; i < size; i++)
+				{
+					if (std::binary_search(set.begin(), set.end(), (W)values[i]) == true)
+						result[i >> 6] |= 1ULL << (i & 63);
+				}
+			}
+
+			void scan_string(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& result)
+			{
+				const std::string* const* values = data.strings();
+				size_t size = data.size();
+				const std::vector<inikey_value>& literals = predicate.values();
+				inipredicate::op_type op = predicate.op();
+
+				std::vector<std::string> set(literals.size());
+				for (size_t i = 0; i < literals.size(); i++)
+				{
+					set[i].assign(literals[i].text(), literals[i].length());
+				}
+				if (op == inipredicate::op_in)
+					std::sort(set.begin(), set.end());
+
+				std::fill(result.begin(), result.end(), 0);
+				for (size_t i = 0; i < size; i++)
+				{
+					const std::string& value = *values[i];
+					bool matched = false;
+					switch (op)
+					{
+					case inipredicate::op_equal: matched = value == set[0]; break;
+					case inipredicate::op_not_equal: matched = value != set[0]; break;
+					case inipredicate::op_less: matched = value < set[0]; break;
+					case inipredicate::op_less_equal: matched = value <= set[0]; break;
+					case inipredicate::op_greater: matched = value > set[0]; break;
+					case inipredicate::op_greater_equal: matched = value >= set[0]; break;
+					case inipredicate::op_between: matched = value >= set[0] && value <= set[1]; break;
+					case inipredicate::op_in: matched = std::binary_search(set.begin(), set.end(), value); break;
+					default: break;
+					}
+					if (matched == true)
+						result[i >> 6] |= 1ULL << (i & 63);
+				}
+			}
+
+			bool has_real(const inipredicate& predicate)
+			{
+				const std::vector<inikey_value>& literals = predicate.values();
+				for (size_t i = 0; i < literals.size(); i++)
+				{
+					if (literals[i].type() == inikey_value::value_type_real)
+						return true;
+				}
+				return false;
+			}
+
+			bool fits_int32(const inipredicate& predicate)
+			{
+				const std::vector<inikey_value>& literals = predicate.values();
+				for (size_t i = 0; i < literals.size(); i++)
+				{
+					long long value = literals[i].to_integer();
+					if (literals[i].type() == inikey_value::value_type_unsigned && literals[i].to_unsigned() > (unsigned long long)std::numeric_limits<int>::max())
+						return false;
+					if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+						return false;
+				}
+				return true;
+			}
+
+			template<typename T>
+			void scan_integral(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& result)
+			{
+				if (has_real(predicate) == true)
+					scan_column<T, double>(data, predicate, result);
+				else
+					scan_column<T, long long>(data, predicate, result);
+			}
+
+			template<>
+			void scan_integral<int>(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& result)
+			{
+				if (has_real(predicate) == true)
+					scan_column<int, double>(data, predicate, result);
+				else if (fits_int32(predicate) == true)
+					scan_column<int, int>(data, predicate, result);
+				else
+					scan_column<int, long long>(data, predicate, result);
+			}
+
+			template<>
+			void scan_integral<unsigned long long>(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& result)
+			{
+				if (has_real(predicate) == true)
+					scan_column<unsigned long long, double>(data, predicate, result);
+				else
+					scan_column<unsigned long long, unsigned long long>(data, predicate, result);
+			}
+		}
+
+		void column_scan::fill(std::vector<unsigned long long>& mask, size_t size)
+		{
+			mask.assign((size + 63) / 64, ~0ULL);
+			if ((size & 63) != 0)
+				mask.back() = (1ULL << (size & 63)) - 1;
+		}
+
+		void column_scan::apply(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& mask)
+		{
+			const unsigned long long* bitmap = data.null_bitmap();
+			inipredicate::op_type op = predicate.op();
+
+			if (op == inipredicate::op_is_null)
+			{
+				for (size_t w = 0; w < mask.size(); w++)
+				{
+					mask[w] &= ~bitmap[w];
+				}
+				return;
+			}
+			else if (op == inipredicate::op_is_not_null)
+			{
+				for (size_t w = 0; w < mask.size(); w++)
+				{
+					mask[w] &= bitmap[w];
+				}
+				return;
+			}
+
+			const std::type_info& typeinfo = data.column().datatype();
+			bool isString = typeinfo == typeid(std::string);
+			const std::vector<inikey_value>& literals = predicate.values();
+			for (size_t i = 0; i < literals.size(); i++)
+			{
+				if ((literals[i].type() == inikey_value::value_type_string) != isString)
+					throw std::invalid_argument("열의 타입과 맞지 않는 값입니다.");
+			}
+
+			std::vector<unsigned long long> result(mask.size());
+			if (result.empty() == true)
+				return;
+
+			if (isString == true)
+				scan_string(data, predicate, result);
+			else if (typeinfo == typeid(bool))
+				scan_integral<bool>(data, predicate, result);
+			else if (typeinfo == typeid(char))
+				scan_integral<char>(data, predicate, result);
+			else if (typeinfo == typeid(unsigned char))
+				scan_integral<unsigned char>(data, predicate, result);
+			else if (typeinfo == typeid(short))
+				scan_integral<short>(data, predicate, result);
+			else if (typeinfo == typeid(unsigned short))
+				scan_integral<unsigned short>(data, predicate, result);
+			else if (typeinfo == typeid(int))
+				scan_integral<int>(data, predicate, result);
+			else if (typeinfo == typeid(unsigned int))
+				scan_integral<unsigned int>(data, predicate, result);
+			else if (typeinfo == typeid(long long))
+				scan_integral<long long>(data, predicate, result);
+			else if (typeinfo == typeid(unsigned long long))
+				scan_integral<unsigned long long>(data, predicate, result);
+			else if (typeinfo == typeid(float))
+				scan_column<float, float>(data, predicate, result);
+			else if (typeinfo == typeid(double))
+				scan_column<double, double>(data, predicate, result);
+			else
+				throw std::invalid_argument(string_resource::invalid_type);
+
+			for (size_t w = 0; w < mask.size(); w++)
+			{
+				mask[w] &= result[w] & bitmap[w];
+			}
+		}
+
+		void column_scan::to_selection(const std::vector<unsigned long long>& mask, iniselection& selection)
+		{
+			selection.clear();
+			for (size_t w = 0; w < mask.size(); w++)
+			{
+				unsigned long long bits = mask[w];
+				while (bits != 0)
+				{
+					selection.push_back((w << 6) + count_trailing_zeros(bits));
+					bits &= bits - 1;
+				}
+			}
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
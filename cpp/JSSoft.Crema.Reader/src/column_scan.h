@@ -0,0 +1,16 @@
+﻿#pragma once
+#include "../include/crema/inidata.h"
+#include <vector>
+
+namespace CremaReader {
+	namespace internal
+	{
+		class column_scan
+		{
+		public:
+			static void fill(std::vector<unsigned long long>& mask, size_t size);
+			static void apply(const icolumn_data& data, const inipredicate& predicate, std::vector<unsigned long long>& mask);
+			static void to_selection(const std::vector<unsigned long long>& mask, iniselection& selection);
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
@@ -0,0 +1,102 @@
+﻿#include "file_istream.h"
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace CremaReader {
+	namespace internal
+	{
+#ifdef _MSC_VER
+		file_istream::file_istream(const std::string& filename)
+			: std::ifstream(filename, std::ios::binary), m_file(INVALID_HANDLE_VALUE)
+		{
+			m_file = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+		}
+
+		file_istream::~file_istream()
+		{
+			if (m_file != INVALID_HANDLE_VALUE)
+				::CloseHandle(m_file);
+		}
+
+		bool file_istream::can_read_at() const
+		{
+			return m_file != INVALID_HANDLE_VALUE;
+		}
+
+		// 비동기로 연 핸들에 위치를 지정해 읽고 끝날 때까지 기다립니다. 호출마다 이벤트를 따로 써서 동시에 불러도 섞이지 않습니다.
+		bool file_istream::read_at(long long offset, char* dest, size_t size) const
+		{
+			if (m_file == INVALID_HANDLE_VALUE)
+				return false;
+
+			HANDLE event = ::CreateEventA(nullptr, TRUE, FALSE, nullptr);
+			if (event == nullptr)
+				return false;
+
+			bool result = true;
+			while (size != 0 && result == true)
+			{
+				OVERLAPPED overlapped = {};
+				overlapped.Offset = (DWORD)(offset & 0xffffffff);
+				overlapped.OffsetHigh = (DWORD)(offset >> 32);
+				overlapped.hEvent = event;
+
+				DWORD length = size > 0x40000000 ? 0x40000000 : (DWORD)size;
+				DWORD read = 0;
+				if (::ReadFile(m_file, dest, length, nullptr, &overlapped) == FALSE && ::GetLastError() != ERROR_IO_PENDING)
+					result = false;
+				else if (::GetOverlappedResult(m_file, &overlapped, &read, TRUE) == FALSE || read == 0)
+					result = false;
+
+				offset += read;
+				dest += read;
+				size -= read;
+			}
+			::CloseHandle(event);
+			return result;
+		}
+#else
+		file_istream::file_istream(const std::string& filename)
+			: std::ifstream(filename.c_str(), std::ios::binary), m_file(-1)
+		{
+			m_file = ::open(filename.c_str(), O_RDONLY);
+		}
+
+		file_istream::~file_istream()
+		{
+			if (m_file != -1)
+				::close(m_file);
+		}
+
+		bool file_istream::can_read_at() const
+		{
+			return m_file != -1;
+		}
+
+		bool file_istream::read_at(long long offset, char* dest, size_t size) const
+		{
+			if (m_file == -1)
+				return false;
+
+			while (size != 0)
+			{
+				ssize_t read = ::pread(m_file, dest, size, (off_t)offset);
+				if (read < 0 && errno == EINTR)
+					continue;
+				if (read <= 0)
+					return false;
+
+				offset += read;
+				dest += read;
+				size -= (size_t)read;
+			}
+			return true;
+		}
+#endif
+	} /*namespace internal*/
+} /*namespace CremaReader*/
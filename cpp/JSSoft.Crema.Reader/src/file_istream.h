@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#include <fstream>
+#include <string>
+
+namespace CremaReader {
+	namespace internal
+	{
+		// 스트림 위치와 상관없이 읽을 수 있는 파일 스트림입니다.
+		// read_at 은 스트림과 별도로 연 핸들을 쓰므로 여러 스레드에서 잠금 없이 동시에 불러도 됩니다.
+		class file_istream : public std::ifstream
+		{
+		public:
+			file_istream(const std::string& filename);
+			virtual ~file_istream();
+
+			bool can_read_at() const;
+			bool read_at(long long offset, char* dest, size_t size) const;
+
+		private:
+#ifdef _MSC_VER
+			void* m_file;
+#else
+			int m_file;
+#endif
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
@@ -1,4 +1,5 @@
 ﻿#include "../include/crema/inidata.h"
+#include "column_scan.h"
 #include <time.h>
 
 namespace CremaReader
@@ -33,6 +34,78 @@ namespace CremaReader
 		return this->at(index);
 	}
 
+	const std::string* const* icolumn_data::strings() const
+	{
+		const inicolumn& column = this->column();
+		if (column.datatype() != typeid(std::string))
+		{
+			std::ostringstream stream;
+			stream << column.datatype().name() << " 에서 " << typeid(std::string).name() << " 으로 변환할 수 없습니다. ";
+
+			throw std::invalid_argument(stream.str());
+		}
+		return (const std::string* const*)this->data();
+	}
+
+	const icolumn_data& itable::column_data(const std::string& columnName) const
+	{
+		return this->column_data(this->columns().at(columnName));
+	}
+
+	const icolumn_data& itable::column_data(size_t index) const
+	{
+		return this->column_data(this->columns().at(index));
+	}
+
+	inipredicate::inipredicate(const inicolumn& column, op_type op)
+		: m_column(&column), m_op(op)
+	{
+		if (op != op_is_null && op != op_is_not_null)
+			throw std::invalid_argument("값이 필요한 조건입니다.");
+	}
+
+	inipredicate::inipredicate(const inicolumn& column, op_type op, const inikey_value& value)
+		: m_column(&column), m_op(op), m_values(1, value)
+	{
+		if (op > op_greater_equal && op != op_in)
+			throw std::invalid_argument("값 하나로 만들 수 없는 조건입니다.");
+	}
+
+	inipredicate::inipredicate(const inicolumn& column, op_type op, const inikey_value& low, const inikey_value& high)
+		: m_column(&column), m_op(op)
+	{
+		if (op != op_between && op != op_in)
+			throw std::invalid_argument("값 두개로 만들 수 없는 조건입니다.");
+		m_values.push_back(low);
+		m_values.push_back(high);
+	}
+
+	inipredicate::inipredicate(const inicolumn& column, op_type op, const inikey_value* values, size_t count)
+		: m_column(&column), m_op(op), m_values(values, values + count)
+	{
+		if (op != op_in)
+			throw std::invalid_argument("값 목록으로 만들 수 없는 조건입니다.");
+	}
+
+	iniselection itable::select(const inipredicate& predicate) const
+	{
+		return this->select(&predicate, 1);
+	}
+
+	iniselection itable::select(const inipredicate* predicates, size_t count) const
+	{
+		std::vector<unsigned long long> mask;
+		internal::column_scan::fill(mask, this->rows().size());
+		for (size_t i = 0; i < count; i++)
+		{
+			internal::column_scan::apply(this->column_data(predicates[i].column()), predicates[i], mask);
+		}
+
+		iniselection selection;
+		internal::column_scan::to_selection(mask, selection);
+		return selection;
+	}
+
 	bool irow::has_value(const std::string& columnName) const
 	{
 		return this->has_value_core(this->table().columns().at(columnName));
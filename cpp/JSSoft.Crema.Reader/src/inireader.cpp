@@ -2,10 +2,18 @@
 #include "../include/crema/iniutils.h"
 #include "binary_reader.h"
 #include "internal_utils.h"
+#include <atomic>
+#include <mutex>
 #include <iostream>
 #include <fstream>
 #include <time.h>
 #include "socket_istream.h"
+#include "socket_loader.h"
+#ifndef _IGNORE_BOOST
+#include <boost/bind.hpp>
+#endif
+#include "mapped_istream.h"
+#include "file_istream.h"
 
 
 namespace CremaReader
@@ -15,22 +23,28 @@ namespace CremaReader
 
 	const int s_magic_value = 0x04000000;
 
-	std::map<int, std::string> string_resource::m_strings;
 	std::string string_resource::empty_string;
-	int string_resource::m_ref = 0;
 	internal_util static_data;
+	size_t s_thread_count = 0;
+	std::atomic<iload_listener*> s_load_listener(nullptr);
+#ifndef _IGNORE_BOOST
+	std::string s_cache_directory;
+	std::mutex s_cache_directory_lock;
+#endif
 
 	CremaReader::CremaReader()
 		: m_stream(nullptr)
 	{
-		string_resource::add_ref();
+		std::lock_guard<std::mutex> lock(static_data.m_lock);
 		static_data.m_readers.push_back(this);
 	}
 
 	CremaReader::~CremaReader()
 	{
-		static_data.m_readers.remove(this);
-		string_resource::remove_ref();
+		{
+			std::lock_guard<std::mutex> lock(static_data.m_lock);
+			static_data.m_readers.remove(this);
+		}
 		if (m_stream != nullptr)
 		{
 			delete m_stream;
@@ -48,6 +62,37 @@ namespace CremaReader
 	}
 
 	CremaReader& CremaReader::read(const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag)
+	{
+		return read(address, port, connection_name(database, datalocation), flag);
+	}
+
+	void CremaReader::read_async(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag, const read_handler& handler)
+	{
+		boost::shared_ptr<socket_loader> loader(new socket_loader(io_service, address, port + 1, connection_name(database, datalocation)));
+		loader->start(boost::bind(&CremaReader::read_completed, loader, flag, handler, _1));
+	}
+
+	static void set_promise(boost::shared_ptr<std::promise<CremaReader*> > promise, CremaReader* reader, std::exception_ptr error)
+	{
+		if (error)
+			promise->set_exception(error);
+		else
+			promise->set_value(reader);
+	}
+
+	std::future<CremaReader*> CremaReader::read_async(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& database, DataLocation datalocation, ReadFlag flag)
+	{
+		boost::shared_ptr<std::promise<CremaReader*> > promise(new std::promise<CremaReader*>());
+		read_async(io_service, address, port, database, datalocation, flag, boost::bind(&set_promise, promise, _1, _2));
+		return promise->get_future();
+	}
+
+	size_t CremaReader::update(const std::string& address, int port, const std::string& database, DataLocation datalocation)
+	{
+		return this->update_core(address, port + 1, connection_name(database, datalocation));
+	}
+
+	std::string CremaReader::connection_name(const std::string& database, DataLocation datalocation)
 	{
 		std::string dl;
 		switch (datalocation)
@@ -66,7 +111,72 @@ namespace CremaReader
 		}
 		std::ostringstream ss;
 		ss << "type=bin;data=" << dl << ";database=" << database << ";";
-		return read(address, port, ss.str(), flag);
+		return ss.str();
+	}
+
+	void CremaReader::read_completed(boost::shared_ptr<socket_loader> loader, ReadFlag flag, read_handler handler, const boost::system::error_code& error)
+	{
+		if (error)
+		{
+			handler(nullptr, std::make_exception_ptr(boost::system::system_error(error)));
+			return;
+		}
+
+		// 받은 이미지는 io_service 에 올린 작업에서 읽고 그 자리에서 handler 를 부릅니다.
+		// work 가 그때까지 io_service::run 이 끝나지 않게 붙잡습니다.
+		boost::asio::io_service& io_service = loader->io_service();
+		boost::shared_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(io_service));
+		io_service.post([loader, flag, handler, work]()
+		{
+			mapped_istream* stream = new mapped_istream(loader->image());
+			CremaReader* reader = nullptr;
+			std::exception_ptr exception;
+			try
+			{
+				reader = &CremaReader::read(*stream, flag);
+				reader->m_stream = stream;
+			}
+			catch (...)
+			{
+				delete stream;
+				exception = std::current_exception();
+			}
+			handler(reader, exception);
+		});
+	}
+#endif
+
+	void CremaReader::set_thread_count(size_t count)
+	{
+		s_thread_count = count;
+	}
+
+	size_t CremaReader::thread_count()
+	{
+		return s_thread_count;
+	}
+
+	void CremaReader::set_load_listener(iload_listener* listener)
+	{
+		s_load_listener = listener;
+	}
+
+	iload_listener* CremaReader::load_listener()
+	{
+		return s_load_listener;
+	}
+
+#ifndef _IGNORE_BOOST
+	void CremaReader::set_cache_directory(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(s_cache_directory_lock);
+		s_cache_directory = path;
+	}
+
+	std::string CremaReader::cache_directory()
+	{
+		std::lock_guard<std::mutex> lock(s_cache_directory_lock);
+		return s_cache_directory;
 	}
 #endif
 
@@ -75,6 +185,9 @@ namespace CremaReader
 		std::ifstream* fstream = dynamic_cast<std::ifstream*>(&stream);
 		if (fstream != nullptr && fstream->is_open() == false)
 			throw std::invalid_argument("파일이 열리지 않았습니다.");
+		mapped_istream* mstream = dynamic_cast<mapped_istream*>(&stream);
+		if (mstream != nullptr && mstream->is_open() == false)
+			throw std::invalid_argument("파일이 열리지 않았습니다.");
 
 		unsigned int magicValue;
 		stream.read((char*)&magicValue, sizeof(int));
@@ -96,13 +209,34 @@ namespace CremaReader
 
 	CremaReader& CremaReader::read(const std::string& filename, ReadFlag flag)
 	{
-#ifdef _MSC_VER
-		std::ifstream* stream = new std::ifstream(filename, std::ios::binary);
-#else
-		std::ifstream* stream = new std::ifstream(filename.c_str(), std::ios::binary);
-#endif
-		CremaReader& reader = CremaReader::read(*stream, flag);
-		reader.m_stream = stream;
-		return reader;
+		if ((flag & ReadFlag_memory_mapped) != 0)
+		{
+			mapped_istream* stream = new mapped_istream(filename);
+			try
+			{
+				CremaReader& reader = CremaReader::read(*stream, flag);
+				reader.m_stream = stream;
+				return reader;
+			}
+			catch (...)
+			{
+				delete stream;
+				throw;
+			}
+		}
+
+		// 테이블은 file_istream::read_at 으로 위치를 지정해 읽으므로 병렬, 지연 로딩이 스트림 잠금을 기다리지 않습니다.
+		file_istream* stream = new file_istream(filename);
+		try
+		{
+			CremaReader& reader = CremaReader::read(*stream, flag);
+			reader.m_stream = stream;
+			return reader;
+		}
+		catch (...)
+		{
+			delete stream;
+			throw;
+		}
 	}
 } /*namespace CremaReader*/
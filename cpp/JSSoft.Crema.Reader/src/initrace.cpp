@@ -0,0 +1,263 @@
+﻿#include "../include/crema/initrace.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+
+namespace CremaReader
+{
+	namespace
+	{
+		void write_json_string(std::ostream& stream, const std::string& text)
+		{
+			stream << '"';
+			for (size_t i = 0; i < text.length(); i++)
+			{
+				unsigned char ch = (unsigned char)text[i];
+				if (ch == '"' || ch == '\\')
+					stream << '\\' << (char)ch;
+				else if (ch < 0x20)
+					stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)ch << std::dec << std::setfill(' ');
+				else
+					stream << (char)ch;
+			}
+			stream << '"';
+		}
+
+		// trace event 는 마이크로초 단위입니다.
+		void write_time(std::ostream& stream, long long nanoseconds)
+		{
+			stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+		}
+
+		class trace_writer
+		{
+		public:
+			trace_writer(std::ostream& stream, long long origin)
+				: m_stream(stream), m_origin(origin), m_firstEvent(true), m_firstArg(true)
+			{
+
+			}
+
+			size_t tid(size_t thread)
+			{
+				std::map<size_t, size_t>::iterator itor = m_threads.find(thread);
+				if (itor != m_threads.end())
+					return itor->second;
+				size_t id = m_threads.size() + 1;
+				m_threads.insert(std::make_pair(thread, id));
+				return id;
+			}
+
+			// 이름과 인자를 가진 "X"(complete) 이벤트를 시작합니다. 인자는 arg 로 이어 쓰고 end 로 닫습니다.
+			void begin(const std::string& name, const char* category, size_t thread, long long start, long long duration)
+			{
+				m_stream << (m_firstEvent == true ? "\n" : ",\n") << "{\"name\":";
+				m_firstEvent = false;
+				write_json_string(m_stream, name);
+				m_stream << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << this->tid(thread) << ",\"ts\":";
+				write_time(m_stream, start - m_origin);
+				m_stream << ",\"dur\":";
+				write_time(m_stream, duration);
+				m_stream << ",\"args\":{";
+				m_firstArg = true;
+			}
+
+			template<typename T>
+			void arg(const char* name, const T& value)
+			{
+				m_stream << (m_firstArg == true ? "" : ",") << '"' << name << "\":" << value;
+				m_firstArg = false;
+			}
+
+			void end()
+			{
+				m_stream << "}}";
+			}
+
+			void phase(const char* name, const char* category, size_t thread, long long& start, long long duration)
+			{
+				if (duration > 0)
+				{
+					this->begin(name, category, thread, start, duration);
+					this->end();
+				}
+				start += duration;
+			}
+
+		private:
+			std::ostream& m_stream;
+			long long m_origin;
+			bool m_firstEvent;
+			bool m_firstArg;
+			std::map<size_t, size_t> m_threads;
+		};
+	}
+
+	initable_stats::initable_stats()
+		: index(0), thread(0), start(0), wall_time(0), read_time(0), decompress_time(0), strings_time(0), columns_time(0), rows_time(0), index_time(0),
+		bytes_read(0), raw_bytes(0), rows(0), columns(0), strings(0), allocations(-1)
+	{
+
+	}
+
+	inidataset_stats::inidataset_stats()
+		: thread(0), start(0), wall_time(0), header_time(0), string_resources_time(0), tables_time(0), bytes_read(0), table_count(0), strings(0)
+	{
+
+	}
+
+	const initable_stats* iniload_stats::find(const std::string& tableName) const
+	{
+		for (size_t i = tables.size(); i > 0; i--)
+		{
+			if (tables[i - 1].name == tableName)
+				return &tables[i - 1];
+		}
+		return nullptr;
+	}
+
+	std::vector<const initable_stats*> iniload_stats::slowest(size_t count) const
+	{
+		std::vector<const initable_stats*> items;
+		items.reserve(tables.size());
+		for (size_t i = 0; i < tables.size(); i++)
+		{
+			items.push_back(&tables[i]);
+		}
+
+		count = std::min(count, items.size());
+		std::partial_sort(items.begin(), items.begin() + count, items.end(), [](const initable_stats* x, const initable_stats* y)
+		{
+			return x->wall_time > y->wall_time;
+		});
+		items.resize(count);
+		return items;
+	}
+
+	long long iniload_stats::total_wall_time() const
+	{
+		long long total = 0;
+		for (size_t i = 0; i < datasets.size(); i++)
+		{
+			total += datasets[i].wall_time;
+		}
+		return total;
+	}
+
+	size_t iniload_stats::total_bytes_read() const
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < datasets.size(); i++)
+		{
+			total += datasets[i].bytes_read;
+		}
+		for (size_t i = 0; i < tables.size(); i++)
+		{
+			total += tables[i].bytes_read;
+		}
+		return total;
+	}
+
+	iniload_trace::iniload_trace()
+	{
+
+	}
+
+	iniload_trace::~iniload_trace()
+	{
+
+	}
+
+	void iniload_trace::dataset_loaded(const inidataset_stats& stats)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stats.datasets.push_back(stats);
+	}
+
+	void iniload_trace::table_loaded(const initable_stats& stats)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stats.tables.push_back(stats);
+	}
+
+	iniload_stats iniload_trace::stats() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		return m_stats;
+	}
+
+	void iniload_trace::clear()
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_stats.datasets.clear();
+		m_stats.tables.clear();
+	}
+
+	void iniload_trace::write_chrome_trace(const std::string& filename) const
+	{
+		std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+		if (stream.is_open() == false)
+			throw std::invalid_argument("파일을 만들 수 없습니다: " + filename);
+		this->write_chrome_trace(stream);
+	}
+
+	void iniload_trace::write_chrome_trace(std::ostream& stream) const
+	{
+		iniload_stats stats = this->stats();
+
+		std::vector<long long> starts;
+		for (size_t i = 0; i < stats.datasets.size(); i++)
+		{
+			starts.push_back(stats.datasets[i].start);
+		}
+		for (size_t i = 0; i < stats.tables.size(); i++)
+		{
+			starts.push_back(stats.tables[i].start);
+		}
+		long long origin = starts.empty() == true ? 0 : *std::min_element(starts.begin(), starts.end());
+
+		trace_writer writer(stream, origin);
+		stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+		for (size_t i = 0; i < stats.datasets.size(); i++)
+		{
+			const inidataset_stats& item = stats.datasets[i];
+			writer.begin(item.name.empty() == true ? "read" : item.name, "dataset", item.thread, item.start, item.wall_time);
+			writer.arg("bytes_read", item.bytes_read);
+			writer.arg("tables", item.table_count);
+			writer.arg("strings", item.strings);
+			writer.end();
+
+			long long start = item.start;
+			writer.phase("header", "dataset", item.thread, start, item.header_time);
+			writer.phase("string resources", "dataset", item.thread, start, item.string_resources_time);
+		}
+
+		for (size_t i = 0; i < stats.tables.size(); i++)
+		{
+			const initable_stats& item = stats.tables[i];
+			writer.begin(item.name, "table", item.thread, item.start, item.wall_time);
+			writer.arg("index", item.index);
+			writer.arg("bytes_read", item.bytes_read);
+			writer.arg("raw_bytes", item.raw_bytes);
+			writer.arg("rows", item.rows);
+			writer.arg("columns", item.columns);
+			writer.arg("strings", item.strings);
+			if (item.allocations >= 0)
+				writer.arg("allocations", item.allocations);
+			writer.end();
+
+			long long start = item.start;
+			writer.phase("read", "table", item.thread, start, item.read_time);
+			writer.phase("decompress", "table", item.thread, start, item.decompress_time);
+			writer.phase("strings", "table", item.thread, start, item.strings_time);
+			writer.phase("columns", "table", item.thread, start, item.columns_time);
+			writer.phase("rows", "table", item.thread, start, item.rows_time);
+			writer.phase("index", "table", item.thread, start, item.index_time);
+		}
+
+		stream << "\n]}\n";
+	}
+} /*namespace CremaReader*/
@@ -10,9 +10,13 @@
 #include <algorithm>
 #include <iterator>
 #include <stdlib.h>
-#include <stdarg.h>
 #include <locale>
 #include <codecvt>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CREMA_HASH_SSE2
+#endif
 
 #ifndef _IGNORE_BOOST
 #include <boost/locale.hpp>
@@ -284,6 +288,28 @@ namespace CremaReader
 		return typeid(int);
 	}
 
+	int iniutil::get_type_size(const std::type_info& typeinfo)
+	{
+		if (typeinfo == typeid(bool))
+			return sizeof(bool);
+		else if (typeinfo == typeid(char) || typeinfo == typeid(unsigned char))
+			return sizeof(char);
+		else if (typeinfo == typeid(short) || typeinfo == typeid(unsigned short))
+			return sizeof(short);
+		else if (typeinfo == typeid(int) || typeinfo == typeid(unsigned int))
+			return sizeof(int);
+		else if (typeinfo == typeid(long long) || typeinfo == typeid(unsigned long long))
+			return sizeof(long long);
+		else if (typeinfo == typeid(float))
+			return sizeof(float);
+		else if (typeinfo == typeid(double))
+			return sizeof(double);
+		else if (typeinfo == typeid(std::string))
+			return sizeof(int);
+
+		throw std::invalid_argument(string_resource::invalid_type);
+	}
+
 	std::wstring iniutil::string_to_wstring(const std::string& text)
 	{
 		if (text.length() == 0)
@@ -322,170 +348,347 @@ namespace CremaReader
 	//	return hash;
 	//}
 
-	int iniutil::get_hash_code(const std::string& text)
+	namespace
 	{
-		std::wstring wtext = string_to_wstring(text);
-		const wchar_t* chPtr = wtext.c_str();
-
-		int num = 0x15051505;
-		int num2 = num;
-		int* numPtr = (int*)chPtr;
-		for (int i = (int)wtext.length(); i > 0; i -= 4)
+		// .NET 의 String.GetHashCode 와 같은 값을 UTF-16 코드 단위를 하나씩 받아 계산합니다.
+		// 코드 단위 네 개마다 두 상태에 하나씩 섞고, 마지막에 남은 단위는 끝의 null 문자와 함께 섞습니다.
+		class utf16_hash
 		{
-			num = (((num << 5) + num) + (num >> 0x1b)) ^ numPtr[0];
-			if (i <= 2)
-				break;
-			num2 = (((num2 << 5) + num2) + (num2 >> 0x1b)) ^ numPtr[1];
-			numPtr += 2;
-		}
-		return num + (num2 * 0x5d588b65);
-	}
+		public:
+			utf16_hash()
+				: m_num(0x15051505), m_num2(0x15051505), m_count(0)
+			{
 
-	long iniutil::generate_hash_core(size_t count, size_t keysize ...)
-	{
-		va_list vl;
+			}
 
-		va_start(vl, keysize);
-		size_t offset = 0;
-		std::vector<char> fields(keysize);
-		const std::collate<char>& coll = std::use_facet< std::collate<char> >(std::locale());
+			void push(unsigned int unit)
+			{
+				m_units[m_count++] = unit;
+				if (m_count == 4)
+				{
+					this->push_words(m_units[0] | (m_units[1] << 16), m_units[2] | (m_units[3] << 16));
+					m_count = 0;
+				}
+			}
 
-		for (size_t i = 0; i < count; i++)
-		{
-			const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-#ifdef _DEBUG
-			const char* name = typeinfo.name();
-#endif
+			// 코드 단위 네 개를 두 단어로 묶어 한번에 섞습니다. 남은 단위가 없을 때만 호출합니다.
+			void push_words(unsigned int word1, unsigned int word2)
+			{
+				m_num = mix(m_num, word1);
+				m_num2 = mix(m_num2, word2);
+			}
 
-			if (typeinfo == typeid(bool))
+			bool aligned() const
 			{
-				internal_util::set_field_value(&fields.front(), offset, !!va_arg(vl, int));
+				return m_count == 0;
 			}
-			else if (typeinfo == typeid(char))
+
+			int finish() const
+			{
+				unsigned int num = m_num;
+				unsigned int num2 = m_num2;
+				if (m_count != 0)
+					num = mix(num, m_units[0] | (m_count > 1 ? m_units[1] << 16 : 0));
+				if (m_count == 3)
+					num2 = mix(num2, m_units[2]);
+				return (int)(num + num2 * 0x5d588b65U);
+			}
+
+		private:
+			static unsigned int mix(unsigned int num, unsigned int word)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (char)va_arg(vl, int));
+				return ((num << 5) + num + (unsigned int)((int)num >> 27)) ^ word;
 			}
-			else if (typeinfo == typeid(unsigned char))
+
+		private:
+			unsigned int m_num;
+			unsigned int m_num2;
+			unsigned int m_units[4];
+			size_t m_count;
+		};
+
+		// 16 바이트가 모두 ASCII 이면 UTF-16 코드 단위로 넓혀 섞고 true 를 반환합니다.
+		bool push_ascii16(utf16_hash& hash, const unsigned char* text)
+		{
+			unsigned int words[8];
+#ifdef CREMA_HASH_SSE2
+			const __m128i bytes = _mm_loadu_si128((const __m128i*)text);
+			if (_mm_movemask_epi8(bytes) != 0)
+				return false;
+			const __m128i zero = _mm_setzero_si128();
+			_mm_storeu_si128((__m128i*)words, _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128((__m128i*)(words + 4), _mm_unpackhi_epi8(bytes, zero));
+#else
+			unsigned long long blocks[2];
+			memcpy(blocks, text, sizeof(blocks));
+			if (((blocks[0] | blocks[1]) & 0x8080808080808080ULL) != 0)
+				return false;
+			for (size_t i = 0; i < 8; i++)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (unsigned char)va_arg(vl, int));
+				words[i] = text[i * 2] | ((unsigned int)text[i * 2 + 1] << 16);
 			}
-			else if (typeinfo == typeid(short))
+#endif
+			for (size_t i = 0; i < 8; i += 2)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (short)va_arg(vl, int));
+				hash.push_words(words[i], words[i + 1]);
 			}
-			else if (typeinfo == typeid(unsigned short))
+			return true;
+		}
+
+		// UTF-8 문자 하나를 UTF-16 코드 단위로 바꾸어 섞고 읽은 바이트 수를 반환합니다.
+		// 잘못된 바이트는 U+FFFD 로 바꾸어 한 바이트씩 넘깁니다.
+		size_t push_utf8(utf16_hash& hash, const unsigned char* text, size_t length)
+		{
+			const unsigned int lead = text[0];
+			unsigned int code;
+			size_t size;
+			if (lead < 0x80)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (unsigned short)va_arg(vl, int));
+				hash.push(lead);
+				return 1;
 			}
-			else if (typeinfo == typeid(int))
+			else if ((lead & 0xe0) == 0xc0)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
+				code = lead & 0x1f;
+				size = 2;
 			}
-			else if (typeinfo == typeid(unsigned int))
+			else if ((lead & 0xf0) == 0xe0)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (unsigned int)va_arg(vl, int));
+				code = lead & 0x0f;
+				size = 3;
 			}
-			else if (typeinfo == typeid(float))
+			else if ((lead & 0xf8) == 0xf0)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (float)va_arg(vl, double));
+				code = lead & 0x07;
+				size = 4;
 			}
-			else if (typeinfo == typeid(double))
+			else
 			{
-				internal_util::set_field_value(&fields.front(), offset, (double)va_arg(vl, double));
+				hash.push(0xfffd);
+				return 1;
 			}
-			else if (typeinfo == typeid(long long))
+
+			if (size > length)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (long long)va_arg(vl, long long));
+				hash.push(0xfffd);
+				return 1;
 			}
-			else if (typeinfo == typeid(unsigned long long))
+
+			for (size_t i = 1; i < size; i++)
 			{
-				internal_util::set_field_value(&fields.front(), offset, (unsigned long long)va_arg(vl, long long));
+				if ((text[i] & 0xc0) != 0x80)
+				{
+					hash.push(0xfffd);
+					return 1;
+				}
+				code = (code << 6) | (text[i] & 0x3f);
 			}
-			else if (typeinfo == typeid(char*) || typeinfo == typeid(const char*))
+
+			if (code > 0x10ffff)
 			{
-				int stringID = iniutil::get_hash_code(va_arg(vl, const char*));
-				internal_util::set_field_value(&fields.front(), offset, stringID);
+				hash.push(0xfffd);
 			}
-			else if (typeinfo == typeid(std::string))
+			else if (code >= 0x10000)
 			{
-				std::string text = (std::string)va_arg(vl, std::string);
-				int stringID = iniutil::get_hash_code(text);
-				internal_util::set_field_value(&fields.front(), offset, stringID);
+				code -= 0x10000;
+				hash.push(0xd800 | (code >> 10));
+				hash.push(0xdc00 | (code & 0x3ff));
 			}
 			else
 			{
-				internal_util::set_field_value(&fields.front(), offset, (int)va_arg(vl, int));
+				hash.push(code);
 			}
+			return size;
 		}
-		va_end(vl);
 
-		long hash = coll.hash(&fields.front(), &fields.front() + fields.size());
+		int hash_utf8(const char* text, size_t length)
+		{
+			const unsigned char* ptr = (const unsigned char*)text;
+			const unsigned char* end = ptr + length;
+			utf16_hash hash;
+			while (ptr != end)
+			{
+				if (hash.aligned() == true && end - ptr >= 16 && push_ascii16(hash, ptr) == true)
+				{
+					ptr += 16;
+					continue;
+				}
+				ptr += push_utf8(hash, ptr, (size_t)(end - ptr));
+			}
+			return hash.finish();
+		}
+	}
 
-		return hash;
+	int iniutil::get_hash_code(const std::string& text)
+	{
+		return get_hash_code(text.c_str(), text.length());
 	}
 
-	size_t iniutil::keys_size(size_t count, ...)
+	int iniutil::get_hash_code(const char* text)
 	{
-		va_list vl;
-		va_start(vl, count);
-		size_t size = 0;
+		return get_hash_code(text, strlen(text));
+	}
 
-		for (size_t i = 0; i < count; i++)
+	int iniutil::get_hash_code(const char* text, size_t length)
+	{
+#ifndef _IGNORE_BOOST
+		// boost 를 쓰면 문자열이 euc-kr 로 보관되므로 ASCII 가 아닌 문자가 있을 때만 UTF-8 로 바꾸어 계산합니다.
+		for (size_t i = 0; i < length; i++)
 		{
-			const std::type_info& typeinfo = *va_arg(vl, const std::type_info*);
-			if (typeinfo == typeid(bool))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(char))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(unsigned char))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(short))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(unsigned short))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(int))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(unsigned int))
-			{
-				size += sizeof(int);
-			}
-			else if (typeinfo == typeid(float))
-			{
-				size += sizeof(float);
-			}
-			else if (typeinfo == typeid(double))
+			if ((unsigned char)text[i] >= 0x80)
 			{
-				size += sizeof(double);
+				const std::string utf8 = boost::locale::conv::to_utf<char>(text, text + length, "euc-kr");
+				return hash_utf8(utf8.c_str(), utf8.length());
 			}
-			else if (typeinfo == typeid(long long))
+		}
+#endif
+		return hash_utf8(text, length);
+	}
+
+	namespace
+	{
+		const unsigned long long hash_prime1 = 0x9e3779b185ebca87ULL;
+		const unsigned long long hash_prime2 = 0xc2b2ae3d27d4eb4fULL;
+		const unsigned long long hash_prime3 = 0x165667b19e3779f9ULL;
+		const unsigned long long hash_prime4 = 0x85ebca77c2b2ae63ULL;
+		const unsigned long long hash_prime5 = 0x27d4eb2f165667c5ULL;
+
+		inline unsigned long long hash_rotl(unsigned long long value, int count)
+		{
+			return (value << count) | (value >> (64 - count));
+		}
+
+		inline unsigned long long hash_read64(const unsigned char* ptr)
+		{
+			return (unsigned long long)ptr[0] | ((unsigned long long)ptr[1] << 8) | ((unsigned long long)ptr[2] << 16) | ((unsigned long long)ptr[3] << 24) |
+				((unsigned long long)ptr[4] << 32) | ((unsigned long long)ptr[5] << 40) | ((unsigned long long)ptr[6] << 48) | ((unsigned long long)ptr[7] << 56);
+		}
+
+		inline unsigned long long hash_read32(const unsigned char* ptr)
+		{
+			return (unsigned long long)ptr[0] | ((unsigned long long)ptr[1] << 8) | ((unsigned long long)ptr[2] << 16) | ((unsigned long long)ptr[3] << 24);
+		}
+
+		inline unsigned long long hash_round(unsigned long long acc, unsigned long long input)
+		{
+			acc += input * hash_prime2;
+			acc = hash_rotl(acc, 31);
+			return acc * hash_prime1;
+		}
+
+		inline unsigned long long hash_merge(unsigned long long acc, unsigned long long value)
+		{
+			acc ^= hash_round(0, value);
+			return acc * hash_prime1 + hash_prime4;
+		}
+	}
+
+	unsigned long long iniutil::hash(const void* data, size_t length)
+	{
+		return iniutil::hash(data, length, default_hash_seed);
+	}
+
+	unsigned long long iniutil::hash(const void* data, size_t length, unsigned long long seed)
+	{
+		const unsigned char* ptr = (const unsigned char*)data;
+		const unsigned char* end = ptr + length;
+		unsigned long long value;
+
+		if (length >= 32)
+		{
+			unsigned long long v1 = seed + hash_prime1 + hash_prime2;
+			unsigned long long v2 = seed + hash_prime2;
+			unsigned long long v3 = seed;
+			unsigned long long v4 = seed - hash_prime1;
+
+			do
 			{
-				size += sizeof(long long);
-			}
-			else if (typeinfo == typeid(unsigned long long))
+				v1 = hash_round(v1, hash_read64(ptr));
+				v2 = hash_round(v2, hash_read64(ptr + 8));
+				v3 = hash_round(v3, hash_read64(ptr + 16));
+				v4 = hash_round(v4, hash_read64(ptr + 24));
+				ptr += 32;
+			} while (ptr + 32 <= end);
+
+			value = hash_rotl(v1, 1) + hash_rotl(v2, 7) + hash_rotl(v3, 12) + hash_rotl(v4, 18);
+			value = hash_merge(value, v1);
+			value = hash_merge(value, v2);
+			value = hash_merge(value, v3);
+			value = hash_merge(value, v4);
+		}
+		else
+		{
+			value = seed + hash_prime5;
+		}
+
+		value += (unsigned long long)length;
+
+		while (ptr + 8 <= end)
+		{
+			value ^= hash_round(0, hash_read64(ptr));
+			value = hash_rotl(value, 27) * hash_prime1 + hash_prime4;
+			ptr += 8;
+		}
+
+		if (ptr + 4 <= end)
+		{
+			value ^= hash_read32(ptr) * hash_prime1;
+			value = hash_rotl(value, 23) * hash_prime2 + hash_prime3;
+			ptr += 4;
+		}
+
+		while (ptr < end)
+		{
+			value ^= (*ptr) * hash_prime5;
+			value = hash_rotl(value, 11) * hash_prime1;
+			ptr++;
+		}
+
+		value ^= value >> 33;
+		value *= hash_prime2;
+		value ^= value >> 29;
+		value *= hash_prime3;
+		value ^= value >> 32;
+		return value;
+	}
+
+	unsigned long long iniutil::generate_hash_core(const inikey_value* keys, size_t count)
+	{
+		long long buffer[8] = { 0 };
+		std::vector<long long> heapBuffer;
+		long long* fields = buffer;
+		if (count > 8)
+		{
+			heapBuffer.resize(count);
+			fields = &heapBuffer.front();
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const inikey_value& key = keys[i];
+			long long value = 0;
+
+			switch (key.type())
 			{
-				size += sizeof(long long);
-			}
-			else if (typeinfo == typeid(std::string))
+			case inikey_value::value_type_integer:
+				value = key.to_integer();
+				break;
+			case inikey_value::value_type_unsigned:
+				value = (long long)key.to_unsigned();
+				break;
+			case inikey_value::value_type_real:
 			{
-				size += sizeof(int);
+				double real = key.to_real();
+				memcpy(&value, &real, sizeof(double));
+				break;
 			}
-			else
-			{
-				size += sizeof(int);
+			case inikey_value::value_type_string:
+				value = iniutil::get_hash_code(key.text(), key.length());
+				break;
 			}
+			fields[i] = value;
 		}
-		return size;
+
+		return iniutil::hash(fields, sizeof(long long) * count);
 	}
 } /*namespace CremaReader*/
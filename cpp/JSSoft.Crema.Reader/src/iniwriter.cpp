@@ -0,0 +1,21 @@
+﻿#include "../include/crema/iniwriter.h"
+#include "binary_writer.h"
+#include <cstring>
+
+namespace CremaReader
+{
+	using namespace internal::binary;
+
+	void iwriter_row::set_value(size_t index, const char* value)
+	{
+		if (value == nullptr)
+			this->set_null(index);
+		else
+			this->set_string(index, value, strlen(value));
+	}
+
+	CremaWriter& CremaWriter::create(const std::string& name)
+	{
+		return *new binary_writer(name);
+	}
+} /*namespace CremaReader*/
@@ -5,15 +5,13 @@
 #include "../include/crema/iniutils.h"
 #include "../include/crema/inireader.h"
 #include <vector>
-#include <stdarg.h>
+#include <algorithm>
 
 namespace CremaReader {
 	namespace internal
 	{
 		std::string string_resource::invalid_type("잘못된 타입입니다.");
 
-		std::string empty_string = "";
-
 		internal_util::internal_util()
 		{
 
@@ -22,7 +20,10 @@ namespace CremaReader {
 		internal_util::~internal_util()
 		{
 			std::list<CremaReader*> readers;
-			readers.assign(m_readers.begin(), m_readers.end());
+			{
+				std::lock_guard<std::mutex> lock(m_lock);
+				readers.assign(m_readers.begin(), m_readers.end());
+			}
 
 			for (std::list<CremaReader*>::iterator itor = readers.begin(); itor != readers.end(); itor++)
 			{
@@ -30,57 +31,85 @@ namespace CremaReader {
 			}
 		}
 
-		void string_resource::read(std::istream& stream)
+		void string_pool::read(std::istream& stream)
 		{
 			int stringCount;
 			stream.read((char*)&stringCount, sizeof(int));
+			m_entries.reserve(stringCount);
+			m_values.reserve(stringCount);
+
+			std::vector<char> buffer;
 			for (int i = 0; i < stringCount; i++)
 			{
 				int length, id;
 				stream.read((char*)&id, sizeof(int));
 				stream.read((char*)&length, sizeof(int));
 
-				if (m_strings.find(id) == m_strings.end())
-				{
-					std::string text;
-					if (length != 0)
-					{
-						std::vector<char> buffer(length + 1, 0);
-						stream.read(&buffer.front(), length);
-						text = iniutil::utf8_to_string(&buffer.front());
-					}
-
-					m_strings[id] = text;
-				}
-				else
-				{
-#ifdef _DEBUG
-					std::streamoff off = stream.tellg();
-#endif
-					stream.seekg(length, std::ios::cur);
-				}
+				buffer.resize(length + 1);
+				if (length != 0)
+					stream.read(&buffer.front(), length);
+				this->add(id, &buffer.front(), length);
 			}
+			this->build_index();
 		}
 
-		const std::string& string_resource::get(int id)
+		void string_pool::read(const char* data)
+		{
+			int stringCount = *(const int*)data;
+			data += sizeof(int);
+			m_entries.reserve(stringCount);
+			m_values.reserve(stringCount);
+
+			for (int i = 0; i < stringCount; i++)
+			{
+				int id = *(const int*)data;
+				int length = *(const int*)(data + sizeof(int));
+				data += sizeof(int) * 2;
+
+				this->add(id, data, length);
+				data += length;
+			}
+			this->build_index();
+		}
+
+		const std::string& string_pool::get(int id) const
 		{
 			if (id == 0)
-				return empty_string;
-			std::map<int, std::string>::const_iterator itor = m_strings.find(id);
-			return itor->second;
+				return string_resource::empty_string;
+
+			entry key = { id, 0 };
+			std::vector<entry>::const_iterator itor = std::lower_bound(m_entries.begin(), m_entries.end(), key);
+			if (itor == m_entries.end() || itor->id != id)
+				return string_resource::empty_string;
+			return m_values[itor->index];
 		}
 
-		void string_resource::add_ref()
+		size_t string_pool::size() const
 		{
-			m_ref++;
+			return m_values.size();
 		}
 
-		void string_resource::remove_ref()
+		void string_pool::add(int id, const char* text, size_t length)
 		{
-			m_ref--;
+			entry item = { id, (unsigned int)m_values.size() };
+			m_entries.push_back(item);
+
+			if (length == 0)
+			{
+				m_values.push_back(std::string());
+			}
+			else
+			{
+				std::string buffer(text, length);
+				m_values.push_back(iniutil::utf8_to_string(buffer.c_str()));
+			}
+		}
 
-			if (m_ref == 0)
-				m_strings.clear();
+		void string_pool::build_index()
+		{
+			std::stable_sort(m_entries.begin(), m_entries.end());
+			std::vector<entry>::iterator last = std::unique(m_entries.begin(), m_entries.end(), [](const entry& x, const entry& y) { return x.id == y.id; });
+			m_entries.erase(last, m_entries.end());
 		}
 	} /*namespace internal*/
 } /*namespace CremaReader*/
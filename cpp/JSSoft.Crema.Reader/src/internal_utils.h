@@ -2,6 +2,9 @@
 #include <istream>
 #include <map>
 #include <list>
+#include <mutex>
+#include <vector>
+#include <string>
 
 namespace CremaReader
 {
@@ -17,34 +20,40 @@ namespace CremaReader {
 			internal_util();
 			~internal_util();
 
-			template<typename _type>
-			static void set_field_value(const char* buffer, size_t& offset, _type value)
-			{
-				_type* value_ptr = (_type*)(buffer + offset);
-				*value_ptr = value;
-				offset += sizeof(_type);
-			}
-
 			std::list<CremaReader*> m_readers;
-
-
+			std::mutex m_lock;
 		};
 
 		class string_resource
 		{
-		public:
-			static void read(std::istream& stream);
-			static const std::string& get(int id);
-
-			static void add_ref();
-			static void remove_ref();
-
 		public:
 			static std::string empty_string;
 			static std::string invalid_type;
+		};
+
+		class string_pool
+		{
+		public:
+			void read(std::istream& stream);
+			void read(const char* data);
+			const std::string& get(int id) const;
+			size_t size() const;
+
+		private:
+			void add(int id, const char* text, size_t length);
+			void build_index();
+
 		private:
-			static std::map<int, std::string> m_strings;
-			static int m_ref;
+			struct entry
+			{
+				int id;
+				unsigned int index;
+
+				bool operator < (const entry& other) const { return id < other.id; }
+			};
+
+			std::vector<entry> m_entries;
+			std::vector<std::string> m_values;
 		};
 	} /*namespace internal*/
 } /*namespace CremaReader*/
@@ -0,0 +1,190 @@
+﻿#include "lz4_block.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace CremaReader {
+	namespace internal
+	{
+		namespace
+		{
+			const size_t min_match = 4;
+			const size_t last_literals = 5;
+			const size_t match_limit = 12;
+			const size_t max_distance = 65535;
+			const int hash_log = 16;
+
+			inline unsigned int read32(const char* p)
+			{
+				unsigned int value;
+				memcpy(&value, p, sizeof(value));
+				return value;
+			}
+
+			inline size_t hash_position(const char* p)
+			{
+				return (size_t)((read32(p) * 2654435761U) >> (32 - hash_log));
+			}
+
+			inline char* write_length(char* dest, size_t length)
+			{
+				for (; length >= 255; length -= 255)
+				{
+					*dest++ = (char)255;
+				}
+				*dest++ = (char)length;
+				return dest;
+			}
+
+			inline void corrupt()
+			{
+				throw std::runtime_error("압축된 데이터가 손상되었습니다.");
+			}
+		}
+
+		size_t lz4_block::compress_bound(size_t size)
+		{
+			return size + size / 255 + 16;
+		}
+
+		size_t lz4_block::compress(const char* source, size_t size, char* dest)
+		{
+			std::vector<unsigned int> table((size_t)1 << hash_log, 0);
+			const char* anchor = source;
+			const char* ip = source;
+			const char* end = source + size;
+			char* op = dest;
+
+			if (size > match_limit)
+			{
+				const char* limit = end - match_limit;
+				ip++;
+				while (ip < limit)
+				{
+					size_t hash = hash_position(ip);
+					const char* ref = source + table[hash];
+					table[hash] = (unsigned int)(ip - source);
+
+					if (ref >= ip || (size_t)(ip - ref) > max_distance || read32(ref) != read32(ip))
+					{
+						ip++;
+						continue;
+					}
+
+					while (ip > anchor && ref > source && ip[-1] == ref[-1])
+					{
+						ip--;
+						ref--;
+					}
+
+					const char* matchEnd = ip + min_match;
+					const char* refEnd = ref + min_match;
+					const char* matchLimit = end - last_literals;
+					while (matchEnd < matchLimit && *matchEnd == *refEnd)
+					{
+						matchEnd++;
+						refEnd++;
+					}
+
+					size_t literalLength = ip - anchor;
+					size_t matchLength = matchEnd - ip - min_match;
+					char* token = op++;
+					*token = (char)((literalLength >= 15 ? 15 : literalLength) << 4);
+					if (literalLength >= 15)
+						op = write_length(op, literalLength - 15);
+					memcpy(op, anchor, literalLength);
+					op += literalLength;
+
+					unsigned short offset = (unsigned short)(ip - ref);
+					*op++ = (char)(offset & 0xff);
+					*op++ = (char)(offset >> 8);
+
+					*token |= (char)(matchLength >= 15 ? 15 : matchLength);
+					if (matchLength >= 15)
+						op = write_length(op, matchLength - 15);
+
+					ip = matchEnd;
+					anchor = ip;
+				}
+			}
+
+			size_t literalLength = end - anchor;
+			*op++ = (char)((literalLength >= 15 ? 15 : literalLength) << 4);
+			if (literalLength >= 15)
+				op = write_length(op, literalLength - 15);
+			if (literalLength != 0)
+				memcpy(op, anchor, literalLength);
+			op += literalLength;
+
+			return op - dest;
+		}
+
+		void lz4_block::decompress(const char* source, size_t size, char* dest, size_t destSize)
+		{
+			const unsigned char* ip = (const unsigned char*)source;
+			const unsigned char* end = ip + size;
+			char* op = dest;
+			char* opEnd = dest + destSize;
+
+			while (ip < end)
+			{
+				unsigned int token = *ip++;
+
+				size_t literalLength = token >> 4;
+				if (literalLength == 15)
+				{
+					unsigned int byte;
+					do
+					{
+						if (ip >= end)
+							corrupt();
+						byte = *ip++;
+						literalLength += byte;
+					} while (byte == 255);
+				}
+
+				if ((size_t)(end - ip) < literalLength || (size_t)(opEnd - op) < literalLength)
+					corrupt();
+				if (literalLength != 0)
+					memcpy(op, ip, literalLength);
+				op += literalLength;
+				ip += literalLength;
+
+				if (ip == end)
+					break;
+
+				if (end - ip < 2)
+					corrupt();
+				size_t offset = ip[0] | (ip[1] << 8);
+				ip += 2;
+				if (offset == 0 || offset > (size_t)(op - dest))
+					corrupt();
+
+				size_t matchLength = token & 15;
+				if (matchLength == 15)
+				{
+					unsigned int byte;
+					do
+					{
+						if (ip >= end)
+							corrupt();
+						byte = *ip++;
+						matchLength += byte;
+					} while (byte == 255);
+				}
+				matchLength += min_match;
+
+				if ((size_t)(opEnd - op) < matchLength)
+					corrupt();
+				const char* match = op - offset;
+				for (size_t i = 0; i < matchLength; i++)
+				{
+					op[i] = match[i];
+				}
+				op += matchLength;
+			}
+
+			if (op != opEnd)
+				corrupt();
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
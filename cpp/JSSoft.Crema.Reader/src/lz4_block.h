@@ -0,0 +1,16 @@
+﻿#pragma once
+#include <vector>
+#include <cstddef>
+
+namespace CremaReader {
+	namespace internal
+	{
+		class lz4_block
+		{
+		public:
+			static size_t compress_bound(size_t size);
+			static size_t compress(const char* source, size_t size, char* dest);
+			static void decompress(const char* source, size_t size, char* dest, size_t destSize);
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
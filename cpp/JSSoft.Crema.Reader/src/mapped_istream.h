@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#include "mappedbuf.h"
+
+namespace CremaReader {
+	namespace internal
+	{
+		class mapped_istream : public std::istream
+		{
+		public:
+			mapped_istream(const std::string& filename)
+				: std::istream(nullptr), m_buf(filename)
+			{
+				this->rdbuf(&m_buf);
+			}
+
+			mapped_istream(std::vector<char>& image)
+				: std::istream(nullptr), m_buf(image)
+			{
+				this->rdbuf(&m_buf);
+			}
+
+			bool is_open() const { return m_buf.is_open(); }
+			const char* data() const { return m_buf.data(); }
+			size_t size() const { return m_buf.size(); }
+
+		private:
+			mappedbuf m_buf;
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
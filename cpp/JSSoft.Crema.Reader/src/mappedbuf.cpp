@@ -0,0 +1,170 @@
+﻿#include "mappedbuf.h"
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace CremaReader {
+	namespace internal
+	{
+#ifdef _MSC_VER
+		mappedbuf::mappedbuf(const std::string& filename)
+			: m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+		{
+			m_file = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+				return;
+
+			LARGE_INTEGER size;
+			if (::GetFileSizeEx(m_file, &size) == FALSE || size.QuadPart == 0)
+			{
+				this->close();
+				return;
+			}
+
+			m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping == nullptr)
+			{
+				this->close();
+				return;
+			}
+
+			m_data = (char*)::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+			if (m_data == nullptr)
+			{
+				this->close();
+				return;
+			}
+
+			m_size = (size_t)size.QuadPart;
+			setg(m_data, m_data, m_data + m_size);
+		}
+
+		void mappedbuf::close()
+		{
+			if (m_data != nullptr && m_image.empty() == true)
+				::UnmapViewOfFile(m_data);
+			if (m_mapping != nullptr)
+				::CloseHandle(m_mapping);
+			if (m_file != INVALID_HANDLE_VALUE)
+				::CloseHandle(m_file);
+
+			m_data = nullptr;
+			m_size = 0;
+			m_image.clear();
+			m_mapping = nullptr;
+			m_file = INVALID_HANDLE_VALUE;
+			setg(nullptr, nullptr, nullptr);
+		}
+#else
+		mappedbuf::mappedbuf(const std::string& filename)
+			: m_data(nullptr), m_size(0), m_file(-1)
+		{
+			m_file = ::open(filename.c_str(), O_RDONLY);
+			if (m_file == -1)
+				return;
+
+			struct stat st;
+			if (::fstat(m_file, &st) != 0 || st.st_size == 0)
+			{
+				this->close();
+				return;
+			}
+
+			void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, m_file, 0);
+			if (data == MAP_FAILED)
+			{
+				this->close();
+				return;
+			}
+
+			m_data = (char*)data;
+			m_size = (size_t)st.st_size;
+			setg(m_data, m_data, m_data + m_size);
+		}
+
+		void mappedbuf::close()
+		{
+			if (m_data != nullptr && m_image.empty() == true)
+				::munmap(m_data, m_size);
+			if (m_file != -1)
+				::close(m_file);
+
+			m_data = nullptr;
+			m_size = 0;
+			m_image.clear();
+			m_file = -1;
+			setg(nullptr, nullptr, nullptr);
+		}
+#endif
+
+#ifdef _MSC_VER
+		mappedbuf::mappedbuf(std::vector<char>& image)
+			: m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#else
+		mappedbuf::mappedbuf(std::vector<char>& image)
+			: m_data(nullptr), m_size(0), m_file(-1)
+#endif
+		{
+			if (image.empty() == true)
+				return;
+
+			m_image.swap(image);
+			m_data = &m_image.front();
+			m_size = m_image.size();
+			setg(m_data, m_data, m_data + m_size);
+		}
+
+		mappedbuf::~mappedbuf()
+		{
+			this->close();
+		}
+
+		bool mappedbuf::is_open() const
+		{
+			return m_data != nullptr;
+		}
+
+		const char* mappedbuf::data() const
+		{
+			return m_data;
+		}
+
+		size_t mappedbuf::size() const
+		{
+			return m_size;
+		}
+
+		mappedbuf::pos_type mappedbuf::seekoff(off_type o, std::ios_base::seekdir dir, std::ios_base::openmode)
+		{
+			off_type pos;
+			switch (dir)
+			{
+			case std::ios_base::beg:
+				pos = o;
+				break;
+			case std::ios_base::end:
+				pos = (off_type)m_size + o;
+				break;
+			default:
+				pos = (off_type)(gptr() - eback()) + o;
+				break;
+			}
+
+			if (pos < 0 || pos > (off_type)m_size)
+				return pos_type(off_type(-1));
+
+			setg(m_data, m_data + pos, m_data + m_size);
+			return pos_type(pos);
+		}
+
+		mappedbuf::pos_type mappedbuf::seekpos(pos_type p, std::ios_base::openmode mode)
+		{
+			return seekoff(off_type(p), std::ios_base::beg, mode);
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
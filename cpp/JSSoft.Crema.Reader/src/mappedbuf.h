@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace CremaReader {
+	namespace internal
+	{
+		class mappedbuf : public std::streambuf
+		{
+		public:
+			mappedbuf(const std::string& filename);
+			mappedbuf(std::vector<char>& image);
+			virtual ~mappedbuf();
+
+			bool is_open() const;
+			const char* data() const;
+			size_t size() const;
+
+		protected:
+			pos_type seekoff(off_type o, std::ios_base::seekdir dir, std::ios_base::openmode = std::ios_base::in | std::ios_base::out);
+			pos_type seekpos(pos_type p, std::ios_base::openmode = std::ios_base::in | std::ios_base::out);
+
+		private:
+			void close();
+
+		private:
+			char* m_data;
+			size_t m_size;
+			std::vector<char> m_image;
+#ifdef _MSC_VER
+			void* m_file;
+			void* m_mapping;
+#else
+			int m_file;
+#endif
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
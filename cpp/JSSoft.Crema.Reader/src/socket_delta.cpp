@@ -0,0 +1,71 @@
+﻿#include "socket_delta.h"
+
+#ifndef _IGNORE_BOOST
+
+namespace CremaReader {
+	namespace internal
+	{
+		socket_delta::socket_delta(const std::string& address, int port, const std::string& name)
+			: m_socket(m_io_service), m_name(name)
+		{
+			socketbuf::connect(m_io_service, m_socket, address, port);
+		}
+
+		socket_delta::~socket_delta()
+		{
+
+		}
+
+		bool socket_delta::compare(const std::string& tablesHashValue, const std::vector<table_hash>& tables)
+		{
+			std::vector<char> packet;
+			socketbuf::append_value(packet, socketbuf::header_type_compare);
+			socketbuf::append_string(packet, m_name);
+			socketbuf::append_string(packet, tablesHashValue);
+			socketbuf::append_value(packet, (int)tables.size());
+			for (size_t i = 0; i < tables.size(); i++)
+			{
+				socketbuf::append_string(packet, tables[i].name);
+				socketbuf::append_string(packet, tables[i].hash);
+			}
+			boost::asio::write(m_socket, boost::asio::buffer(packet));
+
+			int count = this->read_value<int>();
+			if (count < 0)
+				return false;
+
+			this->read_string(m_revision);
+			this->read_string(m_tablesHashValue);
+
+			m_tables.resize(count);
+			for (int i = 0; i < count; i++)
+			{
+				table_image& image = m_tables[i];
+				this->read_string(image.name);
+				image.data.assign((size_t)this->read_value<long long>(), 0);
+				if (image.data.empty() == false)
+					boost::asio::read(m_socket, boost::asio::buffer(image.data));
+			}
+			return true;
+		}
+
+		void socket_delta::read_string(std::string& text)
+		{
+			size_t length = 0;
+			size_t shift = 0;
+			unsigned char byte;
+			do
+			{
+				byte = this->read_value<unsigned char>();
+				length |= (size_t)(byte & 0x7f) << shift;
+				shift += 7;
+			} while ((byte & 0x80) != 0);
+
+			text.assign(length, 0);
+			if (length != 0)
+				boost::asio::read(m_socket, boost::asio::buffer(&text[0], length));
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
+
+#endif
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#ifndef _IGNORE_BOOST
+#include "socketbuf.h"
+
+namespace CremaReader {
+	namespace internal
+	{
+		class socket_delta
+		{
+		public:
+			struct table_hash
+			{
+				std::string name;
+				std::string hash;
+			};
+
+			struct table_image
+			{
+				std::string name;
+				std::vector<char> data;
+			};
+
+			socket_delta(const std::string& address, int port, const std::string& name);
+			~socket_delta();
+
+			bool compare(const std::string& tablesHashValue, const std::vector<table_hash>& tables);
+
+			const std::string& revision() const { return m_revision; }
+			const std::string& tables_hash_value() const { return m_tablesHashValue; }
+			std::vector<table_image>& tables() { return m_tables; }
+
+		private:
+			void read_string(std::string& text);
+
+			template<typename T>
+			T read_value()
+			{
+				T value;
+				boost::asio::read(m_socket, boost::asio::buffer(&value, sizeof(T)));
+				return value;
+			}
+
+		private:
+			boost::asio::io_service m_io_service;
+			boost::asio::ip::tcp::socket m_socket;
+			std::string m_name;
+			std::string m_revision;
+			std::string m_tablesHashValue;
+			std::vector<table_image> m_tables;
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
+
+#endif
@@ -11,9 +11,9 @@ namespace CremaReader {
 		{
 		public:
 			socket_istream(const std::string& address = "127.0.0.1", int port = 4004, const std::string& name = "master")
-				: m_buf(address, port, name), std::istream(&m_buf)
+				: std::istream(nullptr), m_buf(address, port, name)
 			{
-
+				this->rdbuf(&m_buf);
 			}
 
 		private:
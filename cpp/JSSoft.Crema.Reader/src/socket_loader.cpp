@@ -0,0 +1,220 @@
+﻿#include "socket_loader.h"
+#include "../include/crema/inireader.h"
+#include <boost/bind.hpp>
+#include <sstream>
+
+#ifndef _IGNORE_BOOST
+
+namespace CremaReader {
+	namespace internal
+	{
+		using namespace boost::asio::ip;
+
+		socket_loader::socket_loader(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& name)
+			: m_io_service(io_service), m_resolver(io_service), m_socket(io_service), m_address(address), m_port(port), m_name(name), m_cacheDirectory(CremaReader::cache_directory()),
+			m_len(0), m_blockCount(0), m_checkIndex(0), m_requestIndex(0), m_receiveIndex(0), m_writing(false)
+		{
+
+		}
+
+		socket_loader::~socket_loader()
+		{
+
+		}
+
+		void socket_loader::start(const completion_handler& handler)
+		{
+			m_handler = handler;
+
+			std::ostringstream out;
+			out << m_port;
+
+			tcp::resolver::query query(m_address, out.str());
+			m_resolver.async_resolve(query, boost::bind(&socket_loader::on_resolve, shared_from_this(),
+				boost::asio::placeholders::error, boost::asio::placeholders::iterator));
+		}
+
+		void socket_loader::on_resolve(const boost::system::error_code& error, tcp::resolver::iterator endpoint_iterator)
+		{
+			if (error)
+				return this->complete(error);
+
+			boost::asio::async_connect(m_socket, endpoint_iterator, boost::bind(&socket_loader::on_connect, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::on_connect(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			m_packet.clear();
+			socketbuf::append_value(m_packet, socketbuf::header_type_size);
+			socketbuf::append_string(m_packet, m_name);
+
+			boost::asio::async_write(m_socket, boost::asio::buffer(m_packet), boost::bind(&socket_loader::on_size_request, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::on_size_request(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			boost::asio::async_read(m_socket, boost::asio::buffer(&m_len, sizeof(m_len)), boost::bind(&socket_loader::on_size, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::on_size(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			m_image.assign((size_t)m_len, 0);
+			m_blockCount = ((size_t)m_len + socketbuf::buffer_size - 1) / socketbuf::buffer_size;
+			if (m_blockCount == 0)
+				return this->complete(error);
+
+			if (m_cacheDirectory.empty() == true || (size_t)m_len < sizeof(m_header))
+			{
+				for (size_t i = 0; i < m_blockCount; i++)
+					m_missing.push_back(i);
+				return this->start_blocks();
+			}
+
+			// 캐시 키를 정하려고 파일 헤더만 먼저 받습니다.
+			socketbuf::buffer_info bufferinfo;
+			bufferinfo.pos = 0;
+			bufferinfo.size = sizeof(m_header);
+
+			m_packet.clear();
+			socketbuf::append_value(m_packet, socketbuf::header_type_buffer);
+			socketbuf::append_value(m_packet, bufferinfo);
+
+			boost::asio::async_write(m_socket, boost::asio::buffer(m_packet), boost::bind(&socket_loader::on_header_request, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::on_header_request(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			boost::asio::async_read(m_socket, boost::asio::buffer(&m_header, sizeof(m_header)), boost::bind(&socket_loader::on_header, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::on_header(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			m_cache.open(m_cacheDirectory, m_name, m_header, (long long)m_len);
+			this->check_cache();
+		}
+
+		// 캐시 파일은 한번에 한 블럭씩 읽고 다음 블럭은 다시 post 해서 io_service 를 오래 붙잡지 않습니다.
+		void socket_loader::check_cache()
+		{
+			if (m_checkIndex == m_blockCount)
+				return this->start_blocks();
+
+			size_t index = m_checkIndex++;
+			char* dest = &m_image.front() + index * socketbuf::buffer_size;
+			if (m_cache.load((long long)(index * socketbuf::buffer_size), dest, this->block_size(index)) == false)
+				m_missing.push_back(index);
+
+			m_io_service.post(boost::bind(&socket_loader::check_cache, shared_from_this()));
+		}
+
+		void socket_loader::start_blocks()
+		{
+			if (m_missing.empty() == true)
+				return this->complete(boost::system::error_code());
+
+			this->send_requests();
+			this->receive_block();
+		}
+
+		void socket_loader::on_request(const boost::system::error_code& error)
+		{
+			m_writing = false;
+			if (error)
+				return this->complete(error);
+
+			this->send_requests();
+		}
+
+		void socket_loader::on_block(const boost::system::error_code& error)
+		{
+			if (error)
+				return this->complete(error);
+
+			size_t index = m_missing[m_receiveIndex];
+			m_cache.store((long long)(index * socketbuf::buffer_size), &m_image.front() + index * socketbuf::buffer_size, this->block_size(index));
+
+			m_receiveIndex++;
+			if (m_receiveIndex == m_missing.size())
+				return this->complete(error);
+
+			this->send_requests();
+			this->receive_block();
+		}
+
+		size_t socket_loader::block_size(size_t index) const
+		{
+			size_t bfs = socketbuf::buffer_size;
+			if ((index + 1) * socketbuf::buffer_size > (size_t)m_len)
+				bfs = (size_t)m_len % socketbuf::buffer_size;
+			return bfs;
+		}
+
+		void socket_loader::send_requests()
+		{
+			if (m_writing == true)
+				return;
+
+			m_packet.clear();
+			for (; m_requestIndex < m_missing.size() && m_requestIndex < m_receiveIndex + socketbuf::pipeline_depth; m_requestIndex++)
+			{
+				size_t index = m_missing[m_requestIndex];
+				socketbuf::buffer_info bufferinfo;
+				bufferinfo.pos = index * socketbuf::buffer_size;
+				bufferinfo.size = this->block_size(index);
+
+				socketbuf::append_value(m_packet, socketbuf::header_type_buffer);
+				socketbuf::append_value(m_packet, bufferinfo);
+			}
+
+			if (m_packet.empty() == true)
+				return;
+
+			m_writing = true;
+			boost::asio::async_write(m_socket, boost::asio::buffer(m_packet), boost::bind(&socket_loader::on_request, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::receive_block()
+		{
+			size_t index = m_missing[m_receiveIndex];
+			char* dest = &m_image.front() + index * socketbuf::buffer_size;
+			boost::asio::async_read(m_socket, boost::asio::buffer(dest, this->block_size(index)), boost::bind(&socket_loader::on_block, shared_from_this(),
+				boost::asio::placeholders::error));
+		}
+
+		void socket_loader::complete(const boost::system::error_code& error)
+		{
+			if (m_handler.empty() == true)
+				return;
+
+			boost::system::error_code ignored;
+			m_socket.close(ignored);
+
+			completion_handler handler;
+			handler.swap(m_handler);
+			handler(error);
+		}
+	} /*namespace internal*/
+} /*namespace CremaReader*/
+
+#endif
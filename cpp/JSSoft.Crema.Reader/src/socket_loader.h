@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "../include/crema/inidefine.h"
+#ifndef _IGNORE_BOOST
+#include "socketbuf.h"
+#include "block_cache.h"
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/function.hpp>
+
+namespace CremaReader {
+	namespace internal
+	{
+		class socket_loader : public boost::enable_shared_from_this<socket_loader>
+		{
+		public:
+			typedef boost::function<void (const boost::system::error_code&)> completion_handler;
+
+			socket_loader(boost::asio::io_service& io_service, const std::string& address, int port, const std::string& name);
+			~socket_loader();
+
+			void start(const completion_handler& handler);
+			std::vector<char>& image() { return m_image; }
+			boost::asio::io_service& io_service() { return m_io_service; }
+
+		private:
+			void on_resolve(const boost::system::error_code& error, boost::asio::ip::tcp::resolver::iterator endpoint_iterator);
+			void on_connect(const boost::system::error_code& error);
+			void on_size_request(const boost::system::error_code& error);
+			void on_size(const boost::system::error_code& error);
+			void on_header_request(const boost::system::error_code& error);
+			void on_header(const boost::system::error_code& error);
+			void check_cache();
+			void start_blocks();
+			void on_request(const boost::system::error_code& error);
+			void on_block(const boost::system::error_code& error);
+
+			size_t block_size(size_t index) const;
+			void send_requests();
+			void receive_block();
+			void complete(const boost::system::error_code& error);
+
+		private:
+			boost::asio::io_service& m_io_service;
+			boost::asio::ip::tcp::resolver m_resolver;
+			boost::asio::ip::tcp::socket m_socket;
+			std::string m_address;
+			int m_port;
+			std::string m_name;
+			std::string m_cacheDirectory;
+			completion_handler m_handler;
+
+			std::streamoff m_len;
+			std::vector<char> m_image;
+			std::vector<char> m_packet;
+			binary::file_header m_header;
+			block_cache m_cache;
+			size_t m_blockCount;
+			size_t m_checkIndex;
+			// 캐시에 없어서 서버에서 받아야 하는 블럭들입니다. m_requestIndex 와 m_receiveIndex 는 이 목록의 위치입니다.
+			std::vector<size_t> m_missing;
+			size_t m_requestIndex;
+			size_t m_receiveIndex;
+			bool m_writing;
+		};
+	} /*namespace internal*/
+} /*namespace CremaReader*/
+
+#endif
@@ -1,5 +1,9 @@
 ﻿#include "socketbuf.h"
+#include "binary_type.h"
+#include "../include/crema/inireader.h"
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 
 #ifndef _IGNORE_BOOST
 
@@ -9,38 +13,55 @@ namespace CremaReader {
 		using namespace boost::asio::ip;
 
 		socketbuf::socketbuf(const std::string& address, int port, const std::string& name)
-			: m_putBack(8), m_name(name)
+			: m_base(0), m_len(0), m_putBack(8), m_name(name), m_cacheDirectory(CremaReader::cache_directory()), m_lastIndex((size_t)-1)
+		{
+			// 수신 버퍼는 연결하기 전에 정해야 TCP 윈도 크기에 반영됩니다.
+			m_socket = new tcp::socket(m_io_service);
+			socketbuf::connect(m_io_service, *m_socket, address, port, (int)(buffer_size * pipeline_depth));
+
+			boost::system::error_code error;
+			header_type header = header_type_size;
+			this->write_value(header);
+			this->write_string(m_name);
+
+			m_socket->read_some(boost::asio::buffer(&m_len, sizeof(off_type)), error);
+
+			size_t count = (size_t)ceilf((float)m_len / buffer_size);
+			m_buffers.assign(count, NULL);
+			m_requested.assign(count, false);
+
+			if (m_cacheDirectory.empty() == false)
+				this->open_cache();
+		}
+
+		void socketbuf::connect(boost::asio::io_service& io_service, tcp::socket& socket, const std::string& address, int port, int receiveBufferSize)
 		{
 			std::string port_string;
 			std::stringstream out;
 			out << port;
 			port_string = out.str();
 
-			tcp::resolver resolver(m_io_service);
+			tcp::resolver resolver(io_service);
 			tcp::resolver::query query(address, port_string);
 			tcp::resolver::iterator endpoint_iterator = resolver.resolve(query);
 			tcp::resolver::iterator end;
 
-			m_socket = new tcp::socket(m_io_service);
 			boost::system::error_code error = boost::asio::error::host_not_found;
 
 			while (error && endpoint_iterator != end)
 			{
-				m_socket->close();
-				m_socket->connect(*endpoint_iterator++, error);
+				tcp::endpoint endpoint = *endpoint_iterator++;
+				socket.close();
+				socket.open(endpoint.protocol(), error);
+				if (error)
+					continue;
+				if (receiveBufferSize > 0)
+					socket.set_option(boost::asio::socket_base::receive_buffer_size(receiveBufferSize), error);
+				socket.connect(endpoint, error);
 			}
 
 			if (error)
 				throw boost::system::system_error(error);
-
-			header_type header = header_type_size;
-			this->write_value(header);
-			this->write_string(m_name);
-
-			m_socket->read_some(boost::asio::buffer(&m_len, sizeof(off_type)), error);
-
-			size_t count = (size_t)ceilf((float)m_len / buffer_size);
-			m_buffers.assign(count, NULL);
 		}
 
 		socketbuf::~socketbuf()
@@ -54,115 +75,184 @@ namespace CremaReader {
 			delete m_socket;
 		}
 
+		// 바로 앞 블럭에 이어서 읽을 때만 뒤 블럭들을 미리 요청합니다.
+		// 지연 읽기처럼 위치를 옮겨 가며 읽을 때 미리 받은 블럭은 대부분 쓰이지 않고 필요한 블럭만 늦춥니다.
 		char* socketbuf::read_buffer(off_type pos)
 		{
 			size_t index = (size_t)(pos / buffer_size);
+			bool sequential = m_lastIndex != (size_t)-1 && index == m_lastIndex + 1;
+			m_lastIndex = index;
 
-			char* buffer = m_buffers[index];
-			if (buffer == NULL)
+			if (m_buffers[index] == NULL && m_requested[index] == false)
+				this->load_cached(index);
+
+			while (m_buffers[index] == NULL)
 			{
-				size_t bfs = buffer_size;
-				if ((index + 1) * buffer_size > (size_t)m_len)
-					bfs = m_len % buffer_size;
-				buffer = new char[bfs];
-				soket_read(buffer, index * buffer_size, bfs);
-				m_buffers[index] = buffer;
+				if (m_requested[index] == true || m_pending.size() >= pipeline_depth)
+					this->receive_block();
+				else
+					this->request_blocks(index, sequential == true ? pipeline_depth : 1);
 			}
-			return buffer;
+
+			if (sequential == true)
+				this->request_blocks(index + 1, pipeline_depth);
+			return m_buffers[index];
 		}
 
-		size_t socketbuf::soket_read(char* dest, off_type pos, size_t size)
+		size_t socketbuf::block_size(size_t index) const
 		{
-			boost::system::error_code error;
-			header_type header = header_type_buffer;
+			size_t bfs = buffer_size;
+			if ((index + 1) * buffer_size > (size_t)m_len)
+				bfs = m_len % buffer_size;
+			return bfs;
+		}
 
-			buffer_info bufferinfo;
-			bufferinfo.pos = pos;
-			bufferinfo.size = size;
+		void socketbuf::request_blocks(size_t index, size_t count)
+		{
+			std::vector<char> packet;
+			size_t last = std::min(m_buffers.size(), index + count);
 
-			this->write_value(header);
-			this->write_value(bufferinfo);
+			for (size_t i = index; i < last && m_pending.size() < pipeline_depth; i++)
+			{
+				if (m_buffers[i] != NULL || m_requested[i] == true || this->load_cached(i) == true)
+					continue;
+
+				header_type header = header_type_buffer;
+				buffer_info bufferinfo;
+				bufferinfo.pos = i * buffer_size;
+				bufferinfo.size = this->block_size(i);
+
+				append_value(packet, header);
+				append_value(packet, bufferinfo);
+				m_requested[i] = true;
+				m_pending.push_back(i);
+			}
 
-			//size_t len = m_socket->read_some(boost::asio::buffer(dest, size), error);
-			//return len;
-			size_t read = 0;
+			if (packet.empty() == true)
+				return;
 
-			for (;;)
+			boost::system::error_code error;
+			boost::asio::write(*m_socket, boost::asio::buffer(packet), error);
+			if (error)
+				throw boost::system::system_error(error);
+		}
+
+		void socketbuf::receive_block()
+		{
+			size_t index = m_pending.front();
+			size_t size = this->block_size(index);
+			char* buffer = new char[size];
+
+			boost::system::error_code error;
+			boost::asio::read(*m_socket, boost::asio::buffer(buffer, size), error);
+			if (error)
 			{
-				boost::system::error_code error;
+				delete[] buffer;
+				throw boost::system::system_error(error);
+			}
 
-				size_t len = m_socket->read_some(boost::asio::buffer(m_buffer), error);
+			m_pending.pop_front();
+			m_buffers[index] = buffer;
+			m_cache.store((long long)(index * buffer_size), buffer, size);
+		}
 
-				if (error == boost::asio::error::eof)
-					break; // Connection closed cleanly by peer.
-				else if (error)
-					throw boost::system::system_error(error);
+		void socketbuf::read_range(off_type pos, size_t size, char* dest)
+		{
+			buffer_info bufferinfo;
+			bufferinfo.pos = pos;
+			bufferinfo.size = size;
 
-				std::memcpy(dest + read, m_buffer.data(), len);
-				read += len;
+			std::vector<char> packet;
+			append_value(packet, header_type_buffer);
+			append_value(packet, bufferinfo);
+			boost::asio::write(*m_socket, boost::asio::buffer(packet));
+			boost::asio::read(*m_socket, boost::asio::buffer(dest, size));
+		}
 
-				if (read == size)
-					break;
-			}
+		void socketbuf::open_cache()
+		{
+			binary::file_header header;
+			if ((size_t)m_len < sizeof(header))
+				return;
 
-			return read;
+			this->read_range(0, sizeof(header), (char*)&header);
+			m_cache.open(m_cacheDirectory, m_name, header, m_len);
 		}
 
-		std::streamsize socketbuf::xsgetn(char * _Ptr, std::streamsize _Count)
+		bool socketbuf::load_cached(size_t index)
 		{
-			m_count = _Count;
-			std::streamsize size = std::streambuf::xsgetn(_Ptr, _Count);
-			m_p += size;
-			return size;
+			if (m_cache.is_open() == false)
+				return false;
+
+			size_t size = this->block_size(index);
+			char* buffer = new char[size];
+			if (m_cache.load((long long)(index * buffer_size), buffer, size) == false)
+			{
+				delete[] buffer;
+				return false;
+			}
+
+			m_buffers[index] = buffer;
+			return true;
 		}
 
+		// 읽기 영역을 다 읽으면 바로 다음 블럭으로 넘어갑니다.
 		std::streambuf::int_type socketbuf::underflow()
 		{
 			if (gptr() < egptr())
 				return traits_type::to_int_type(*gptr());
 
-			char* end = egptr();
-			char* next = gptr();
-
-			pos_type si = m_p;
-			if (next == end)
-				si = (m_p + m_count) / buffer_size * buffer_size;
+			off_type pos = m_base + (egptr() - eback());
+			if (pos >= m_len)
+				return traits_type::eof();
 
-			set_buffer(si);
+			set_buffer(pos);
 
 			return traits_type::to_int_type(*gptr());
 		}
 
 		void socketbuf::set_buffer(off_type pos)
 		{
+			size_t index = (size_t)(pos / buffer_size);
+			if (pos >= m_len)
+			{
+				m_base = pos;
+				setg(nullptr, nullptr, nullptr);
+				return;
+			}
+
 			char* buffer = read_buffer(pos);
 			size_t offset = pos % buffer_size;
-			size_t index = (size_t)(pos / buffer_size);
-			size_t bfs = buffer_size;
-			if ((index + 1) * buffer_size > (size_t)m_len)
-				bfs = m_len % buffer_size;
+			size_t bfs = this->block_size(index);
 
+			m_base = (off_type)(index * buffer_size);
 			setg(buffer, buffer + offset, buffer + bfs);
 		}
 
 		socketbuf::pos_type socketbuf::seekoff(off_type o, std::ios_base::seekdir dir, std::ios_base::openmode)
 		{
+			off_type pos;
 			switch (dir)
 			{
 			case std::ios_base::beg:
-				m_p = o;
+				pos = o;
 				break;
 			case std::ios_base::end:
-				m_p = m_len - o;
+				pos = m_len + o;
 				break;
 			default:
-				m_p = m_p + o;
+				pos = m_base + (gptr() - eback()) + o;
 				break;
 			}
 
-			set_buffer(m_p);
+			if (pos < 0 || pos > m_len)
+				return pos_type(off_type(-1));
+			if (dir == std::ios_base::cur && o == 0)
+				return pos_type(pos);
 
-			return pos_type(m_p);
+			set_buffer(pos);
+
+			return pos_type(pos);
 		}
 
 		socketbuf::pos_type socketbuf::seekpos(pos_type p, std::ios_base::openmode mode)
@@ -170,21 +260,25 @@ namespace CremaReader {
 			return seekoff(p, std::ios_base::beg, mode);
 		}
 
-		void socketbuf::write_string(const std::string& /*text*/)
+		void socketbuf::write_string(const std::string& text)
 		{
+			std::vector<char> packet;
+			append_string(packet, text);
+
 			boost::system::error_code error;
-			size_t len = m_name.length();
-			unsigned char byte;
+			boost::asio::write(*m_socket, boost::asio::buffer(packet), error);
+		}
+
+		void socketbuf::append_string(std::vector<char>& packet, const std::string& text)
+		{
+			size_t len = text.length();
 			while (len >= 0x80)
 			{
-				byte = (unsigned char)(len | 0x80);
-				m_socket->write_some(boost::asio::buffer(&byte, sizeof(unsigned char)), error);
+				append_value(packet, (unsigned char)(len | 0x80));
 				len = len >> 7;
 			}
-			byte = (unsigned char)len;
-			m_socket->write_some(boost::asio::buffer(&byte, sizeof(unsigned char)), error);
-
-			m_socket->write_some(boost::asio::buffer(m_name, m_name.length()), error);
+			append_value(packet, (unsigned char)len);
+			packet.insert(packet.end(), text.begin(), text.end());
 		}
 	} /*namespace internal*/
 } /*namespace CremaReader*/
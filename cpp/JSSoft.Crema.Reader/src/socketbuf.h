@@ -2,10 +2,12 @@
 
 #include "../include/crema/inidefine.h"
 #ifndef _IGNORE_BOOST
+#include "block_cache.h"
 #include <iostream>
 #include <algorithm>
+#include <deque>
+#include <vector>
 #include <boost/asio.hpp>
-#include <boost/array.hpp>
 
 namespace CremaReader {
 	namespace internal
@@ -16,7 +18,9 @@ namespace CremaReader {
 			socketbuf(const std::string& address, int port, const std::string& name);
 			virtual ~socketbuf();
 
-		protected:
+			static const size_t buffer_size = 1024 * 256;
+			static const size_t pipeline_depth = 4;
+
 			enum header_type
 			{
 				header_type_identify,
@@ -31,17 +35,33 @@ namespace CremaReader {
 				size_t size;
 			};
 
-			std::streamsize xsgetn(char * _Ptr, std::streamsize _Count);
+			template<typename T>
+			static void append_value(std::vector<char>& packet, const T& data)
+			{
+				const char* bytes = (const char*)&data;
+				packet.insert(packet.end(), bytes, bytes + sizeof(T));
+			}
+
+			static void append_string(std::vector<char>& packet, const std::string& text);
+			static void connect(boost::asio::io_service& io_service, boost::asio::ip::tcp::socket& socket, const std::string& address, int port, int receiveBufferSize = 0);
+
+		protected:
 			std::streambuf::int_type underflow();
 			pos_type seekoff(off_type o, std::ios_base::seekdir dir, std::ios_base::openmode = std::ios_base::in | std::ios_base::out);
 			pos_type seekpos(pos_type p, std::ios_base::openmode = std::ios_base::in | std::ios_base::out);
 
 		private:
-			size_t soket_read(char* dest, off_type pos, size_t size);
 			void write_string(const std::string& text);
 
 			char* read_buffer(off_type pos);
 			void set_buffer(off_type pos);
+			size_t block_size(size_t index) const;
+			void request_blocks(size_t index, size_t count);
+			void receive_block();
+			void read_range(off_type pos, size_t size, char* dest);
+
+			void open_cache();
+			bool load_cached(size_t index);
 
 			template<typename T>
 			void write_value(const T& data)
@@ -51,20 +71,20 @@ namespace CremaReader {
 			}
 
 		private:
-			static const size_t buffer_size = 1024 * 256;
-
-			pos_type m_p;
-			std::streamsize m_count;
-			//pos_type m_pos;
+			// 읽기 영역(eback)이 가리키는 블럭의 파일 위치입니다.
+			off_type m_base;
 			off_type m_len;
 
 			boost::asio::io_service m_io_service;
 			boost::asio::ip::tcp::socket* m_socket;
 			const std::size_t m_putBack;
-			//std::vector<char> m_buffer;
-			boost::array<char, buffer_size> m_buffer;
 			std::string m_name;
+			std::string m_cacheDirectory;
 			std::vector<char*> m_buffers;
+			std::vector<bool> m_requested;
+			std::deque<size_t> m_pending;
+			size_t m_lastIndex;
+			block_cache m_cache;
 
 
 		};
@@ -97,6 +97,24 @@ namespace JSSoft.Crema.Commands
             set;
         }
 
+        [CommandProperty("zero-copy")]
+        [Description("행의 값을 복사하지 않고 리더의 데이터를 직접 읽는 코드를 생성합니다.")]
+        [DefaultValue(false)]
+        public static bool ZeroCopyRows
+        {
+            get;
+            set;
+        }
+
+        [CommandProperty("lazy-tables")]
+        [Description("테이블을 처음 접근할 때 읽도록 데이터 클래스를 생성합니다.")]
+        [DefaultValue(false)]
+        public static bool LazyTables
+        {
+            get;
+            set;
+        }
+
         [CommandProperty]
         [Description("생성되는 파일명에 붙는 접두사를 설정합니다.")]
         [DefaultValue("")]
@@ -154,6 +172,10 @@ namespace JSSoft.Crema.Commands
                     options |= CodeGenerationOptions.OmitBaseCode;
                 if (OmitCode == true)
                     options |= CodeGenerationOptions.OmitCode;
+                if (ZeroCopyRows == true)
+                    options |= CodeGenerationOptions.ZeroCopyRows;
+                if (LazyTables == true)
+                    options |= CodeGenerationOptions.LazyTables;
                 return options;
             }
         }